@@ -0,0 +1,385 @@
+/**
+ * @file bench_card_poller.c
+ * @brief Host benchmark: building controller sweep of 32 zone cards
+ *
+ * The card poller reads 32 simulated zone cards on simulated I2C1, whose
+ * transactions take their wire time at the bus clock under test. For
+ * each clock, polling mode and NAK rate the report gives the full-sweep
+ * time against the 1 s budget of FR-BC-001, the frame reads per sweep,
+ * the per-card round trip (transaction start to completion interrupt),
+ * and the time of a hot pass with two cards in alarm. One card changes
+ * its fault mask before every sweep; the first sweep, which reads every
+ * frame in both modes, is not measured. "wire" is the pure bus time of
+ * one unchanged card: its frame, or its change counter.
+ * The host kernel is single-core, so frame checking does not overlap
+ * the transfers as it does on the RP2040; the sweep times are an upper
+ * bound.
+ *
+ * The second table runs the poller loop in real time at 100 kHz and
+ * puts a random card into alarm at random moments. It reports the time
+ * from the card publishing the alarm to the poller recording it, with
+ * the schedule alone and with the attention line, against the 1 s of
+ * NFR-PERF-002.
+ *
+ * The last case runs the same loop with one card changing on every
+ * read, so the attention line is never released, and checks that the
+ * loop still comes round (where the task beats its heartbeat) within
+ * TIMEOUT_HEARTBEAT_CARD_POLLER_MS.
+ *
+ * Usage: bench_card_poller [sweeps] [events]
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "card_poller.h"
+#include "status_link.h"
+#include "hal_sim.h"
+
+#define BENCH_CARDS             CARD_POLLER_MAX_CARDS
+#define BENCH_DEFAULT_SWEEPS    20
+#define BENCH_HOT_PASSES        20
+#define BENCH_SEED              0x2468ACE1u
+#define BENCH_CHANGING_CARD     7u
+#define BENCH_DEFAULT_EVENTS    20
+#define BENCH_EVENT_BAUDRATE    100000
+#define BENCH_EVENT_GAP_MS      50      /* Plus up to 300 ms at random */
+#define BENCH_EVENT_TIMEOUT_MS  2000
+#define BENCH_NFR_PERF_002_MS   1000
+#define BENCH_HELD_MS           3000
+
+static const uint32_t ulBaudrates[] = { 100000, 400000, 1000000 };
+static const uint32_t ulNakRates[] = { 0, 10, 50 };     /* Per thousand transactions */
+static const card_poller_mode_t eModes[] = { CARD_POLLER_MODE_FULL, CARD_POLLER_MODE_CHANGE };
+static uint32_t ulSweeps = BENCH_DEFAULT_SWEEPS;
+static uint32_t ulEvents = BENCH_DEFAULT_EVENTS;
+static uint32_t ulBenchRandom = BENCH_SEED;
+
+/* Poller loop of the latency cases, stopped between them */
+static TaskHandle_t xBenchTask;
+static volatile bool xPollerStop;
+static volatile uint32_t ulPollerLoops;
+static volatile uint32_t ulPollerMaxGapUs;     /* Longest pass plus wait */
+
+typedef struct {
+    double sweep_mean_ms;
+    double sweep_max_ms;
+    double frames_per_sweep;
+    double rtt_mean_us;
+    uint32_t rtt_max_us;
+    uint32_t failed;
+    uint32_t offline;
+    double hot_mean_us;
+} bench_result_t;
+
+static void prvRunCase(uint32_t ulBaudrate, card_poller_mode_t eMode, uint32_t ulNakPermille,
+                       bench_result_t *pxResult)
+{
+    card_poller_stats_t xStats;
+    card_poller_card_t xCard;
+    uint64_t ullSweepUs = 0;
+    uint64_t ullHotUs = 0;
+    uint64_t ullRttUs = 0;
+    uint32_t ulSweepMaxUs = 0;
+    uint32_t ulFrameReads;
+    uint32_t ulGood = 0;
+
+    (void)hal_sim_zone_cards_attach(1, CARD_POLLER_FIRST_ADDRESS, BENCH_CARDS);
+    hal_sim_zone_cards_set_nak_rate(ulNakPermille, BENCH_SEED);
+    if (!card_poller_init(BENCH_CARDS, ulBaudrate, eMode)) {
+        printf("card_poller_init failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    (void)card_poller_run(true);
+    card_poller_get_stats(&xStats);
+    ulFrameReads = xStats.frame_reads;
+
+    for (uint32_t i = 0; i < ulSweeps; i++) {
+        hal_sim_zone_cards_set_zones(BENCH_CHANGING_CARD, 0, (uint8_t)((i & 1u) ? 0x00 : 0x02));
+        (void)card_poller_run(true);
+        card_poller_get_stats(&xStats);
+        ullSweepUs += xStats.sweep_last_us;
+        if (xStats.sweep_last_us > ulSweepMaxUs) {
+            ulSweepMaxUs = xStats.sweep_last_us;
+        }
+    }
+    ulFrameReads = xStats.frame_reads - ulFrameReads;
+    hal_sim_zone_cards_set_zones(BENCH_CHANGING_CARD, 0, 0);
+
+    /* Two cards in alarm, seen by one sweep, then read on every hot pass */
+    hal_sim_zone_cards_set_zones(5, 0x01, 0);
+    hal_sim_zone_cards_set_zones(BENCH_CARDS - 1u, 0x02, 0);
+    (void)card_poller_run(true);
+    for (uint32_t i = 0; i < BENCH_HOT_PASSES; i++) {
+        (void)card_poller_run(false);
+        card_poller_get_stats(&xStats);
+        ullHotUs += xStats.hot_last_us;
+    }
+
+    *pxResult = (bench_result_t){ 0 };
+    card_poller_get_stats(&xStats);
+    pxResult->sweep_mean_ms = (double)ullSweepUs / ulSweeps / 1e3;
+    pxResult->sweep_max_ms = (double)ulSweepMaxUs / 1e3;
+    pxResult->frames_per_sweep = (double)ulFrameReads / ulSweeps;
+    pxResult->hot_mean_us = (double)ullHotUs / BENCH_HOT_PASSES;
+
+    for (uint32_t c = 0; c < BENCH_CARDS; c++) {
+        (void)card_poller_get_card(c, &xCard);
+        ullRttUs += xCard.rtt_total_us;
+        ulGood += xCard.polls - xCard.naks - xCard.crc_errors - xCard.timeouts;
+        pxResult->failed += xCard.naks + xCard.crc_errors + xCard.timeouts;
+        pxResult->offline += xCard.online ? 0u : 1u;
+        if (xCard.rtt_max_us > pxResult->rtt_max_us) {
+            pxResult->rtt_max_us = xCard.rtt_max_us;
+        }
+    }
+    pxResult->rtt_mean_us = ulGood ? (double)ullRttUs / ulGood : 0.0;
+}
+
+static uint32_t prvBenchRandom(void)
+{
+    ulBenchRandom ^= ulBenchRandom << 13;
+    ulBenchRandom ^= ulBenchRandom >> 17;
+    ulBenchRandom ^= ulBenchRandom << 5;
+    return ulBenchRandom;
+}
+
+/**
+ * @brief The card poller task's loop, until xPollerStop
+ */
+static void prvPollerTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    static periodic_task_t xPeriodic;
+    const uint32_t ulPassesPerSweep = CARD_POLLER_SWEEP_MS / CARD_POLLER_HOT_MS;
+    uint32_t ulPass = 0;
+
+    uint64_t ullLoopUs = time_us_64();
+
+    periodic_init(&xPeriodic, "BenchPoller", CARD_POLLER_HOT_MS);
+    ulPollerLoops = 0;
+    ulPollerMaxGapUs = 0;
+    while (!xPollerStop) {
+        uint64_t ullNowUs;
+
+        (void)card_poller_run(ulPass == 0);
+        if (++ulPass >= ulPassesPerSweep) {
+            ulPass = 0;
+        }
+        card_poller_wait(&xPeriodic);
+
+        /* The firmware task beats its heartbeat here */
+        ullNowUs = time_us_64();
+        if ((uint32_t)(ullNowUs - ullLoopUs) > ulPollerMaxGapUs) {
+            ulPollerMaxGapUs = (uint32_t)(ullNowUs - ullLoopUs);
+        }
+        ullLoopUs = ullNowUs;
+        ulPollerLoops++;
+    }
+
+    xTaskNotifyGive(xBenchTask);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Wait for the poller to record a change of a card
+ * @return Microseconds from ulStartUs, or UINT32_MAX on timeout
+ */
+static uint32_t prvWaitEvent(uint32_t ulCard, uint32_t ulLastEventUs, uint32_t ulStartUs)
+{
+    card_poller_card_t xCard;
+
+    for (uint32_t ms = 0; ms < BENCH_EVENT_TIMEOUT_MS; ms++) {
+        (void)card_poller_get_card(ulCard, &xCard);
+        if (xCard.event_us != ulLastEventUs) {
+            return xCard.event_us - ulStartUs;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    return UINT32_MAX;
+}
+
+static void prvRunLatencyCase(bool xAttention)
+{
+    card_poller_card_t xCard;
+    card_poller_stats_t xStats;
+    uint64_t ullTotalUs = 0;
+    uint32_t ulMaxUs = 0;
+    uint32_t ulMissed = 0;
+
+    (void)hal_sim_zone_cards_attach(1, CARD_POLLER_FIRST_ADDRESS, BENCH_CARDS);
+    hal_sim_zone_cards_set_nak_rate(0, BENCH_SEED);
+    (void)card_poller_init(BENCH_CARDS, BENCH_EVENT_BAUDRATE, CARD_POLLER_MODE_CHANGE);
+    card_poller_set_attention(xAttention);
+
+    xPollerStop = false;
+    xTaskCreate(prvPollerTask, "BenchPoller", configMINIMAL_STACK_SIZE * 4, NULL,
+                TASK_PRIORITY_COMMUNICATION, NULL);
+    vTaskDelay(pdMS_TO_TICKS(CARD_POLLER_SWEEP_MS + CARD_POLLER_HOT_MS));
+
+    for (uint32_t i = 0; i < ulEvents; i++) {
+        uint32_t ulCard = prvBenchRandom() % BENCH_CARDS;
+        uint32_t ulStartUs;
+        uint32_t ulLatencyUs;
+
+        vTaskDelay(pdMS_TO_TICKS(BENCH_EVENT_GAP_MS + (prvBenchRandom() % 300u)));
+
+        (void)card_poller_get_card(ulCard, &xCard);
+        ulStartUs = time_us_32();
+        hal_sim_zone_cards_set_zones(ulCard, 0x01, 0);
+        ulLatencyUs = prvWaitEvent(ulCard, xCard.event_us, ulStartUs);
+        if (ulLatencyUs == UINT32_MAX) {
+            ulMissed++;
+        } else {
+            ullTotalUs += ulLatencyUs;
+            if (ulLatencyUs > ulMaxUs) {
+                ulMaxUs = ulLatencyUs;
+            }
+        }
+
+        /* Back to normal before the next card; a card in alarm is hot */
+        (void)card_poller_get_card(ulCard, &xCard);
+        hal_sim_zone_cards_set_zones(ulCard, 0, 0);
+        (void)prvWaitEvent(ulCard, xCard.event_us, time_us_32());
+    }
+
+    xPollerStop = true;
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    card_poller_get_stats(&xStats);
+    printf("%10s %7u %12.1f %12.1f %7s %7u %9u %14.0f\n",
+           xAttention ? "attention" : "schedule", (unsigned)(ulEvents - ulMissed),
+           (ulEvents > ulMissed) ? (double)ullTotalUs / (ulEvents - ulMissed) / 1e3 : 0.0,
+           (double)ulMaxUs / 1e3,
+           ((ulMissed == 0) && (ulMaxUs <= BENCH_NFR_PERF_002_MS * 1000u)) ? "ok" : "OVER",
+           (unsigned)ulMissed, (unsigned)xStats.attention_scans,
+           xStats.attention_scans ? (double)xStats.attention_last_us : 0.0);
+}
+
+/**
+ * @brief Hold the attention line with a chattering card
+ * @return true if the poller loop kept within its heartbeat deadline
+ */
+static bool prvRunHeldCase(void)
+{
+    card_poller_stats_t xStats;
+    uint32_t ulScans;
+    uint32_t ulLoops;
+    bool xOk;
+
+    (void)hal_sim_zone_cards_attach(1, CARD_POLLER_FIRST_ADDRESS, BENCH_CARDS);
+    hal_sim_zone_cards_set_nak_rate(0, BENCH_SEED);
+    (void)card_poller_init(BENCH_CARDS, BENCH_EVENT_BAUDRATE, CARD_POLLER_MODE_CHANGE);
+    card_poller_set_attention(true);
+
+    xPollerStop = false;
+    xTaskCreate(prvPollerTask, "BenchPoller", configMINIMAL_STACK_SIZE * 4, NULL,
+                TASK_PRIORITY_COMMUNICATION, NULL);
+    vTaskDelay(pdMS_TO_TICKS(CARD_POLLER_SWEEP_MS + CARD_POLLER_HOT_MS));
+
+    card_poller_get_stats(&xStats);
+    ulScans = xStats.attention_scans;
+    ulLoops = ulPollerLoops;
+    ulPollerMaxGapUs = 0;
+    hal_sim_zone_cards_set_chatter(BENCH_CHANGING_CARD, true);
+    vTaskDelay(pdMS_TO_TICKS(BENCH_HELD_MS));
+
+    xPollerStop = true;
+    hal_sim_zone_cards_set_chatter(BENCH_CHANGING_CARD, false);
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    card_poller_get_stats(&xStats);
+    xOk = (ulPollerMaxGapUs <= TIMEOUT_HEARTBEAT_CARD_POLLER_MS * 1000u);
+    printf("\nAttention line held for %u ms by a card changing on every read\n",
+           (unsigned)BENCH_HELD_MS);
+    printf("%7s %9s %14s %10s\n", "loops", "scans", "max_loop_ms", "heartbeat");
+    printf("%7u %9u %14.1f %10s\n", (unsigned)(ulPollerLoops - ulLoops),
+           (unsigned)(xStats.attention_scans - ulScans), (double)ulPollerMaxGapUs / 1e3,
+           xOk ? "ok" : "MISSED");
+    return xOk;
+}
+
+static void prvBenchTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    bench_result_t xResult;
+
+    printf("\n%u cards, %u-byte frames, %u sweeps per case\n",
+           (unsigned)BENCH_CARDS, (unsigned)STATUS_LINK_FRAME_BYTES, (unsigned)ulSweeps);
+    printf("%8s %7s %5s %8s %12s %12s %7s %7s %12s %10s %7s %8s %12s\n",
+           "bus_hz", "mode", "nak", "wire_us", "sweep_mean", "sweep_max", "budget", "frames",
+           "rtt_mean_us", "rtt_max_us", "failed", "offline", "hot_pass_us");
+
+    for (size_t b = 0; b < sizeof(ulBaudrates) / sizeof(ulBaudrates[0]); b++) {
+        for (size_t m = 0; m < sizeof(eModes) / sizeof(eModes[0]); m++) {
+            /* Frame: address, offset, address again and the frame, plus start,
+             * restart and stop. Change counter: address and one byte, plus
+             * start and stop */
+            uint32_t ulWireBits = (eModes[m] == CARD_POLLER_MODE_FULL) ?
+                                  ((STATUS_LINK_FRAME_BYTES + 3u) * 9u + 3u) : (2u * 9u + 2u);
+            double xWireUs = (double)ulWireBits * 1e6 / ulBaudrates[b];
+
+            for (size_t n = 0; n < sizeof(ulNakRates) / sizeof(ulNakRates[0]); n++) {
+                prvRunCase(ulBaudrates[b], eModes[m], ulNakRates[n], &xResult);
+                printf("%8u %7s %4u%% %8.0f %9.2f ms %9.2f ms %7s %7.1f %12.0f %10u %7u %8u %12.0f\n",
+                       (unsigned)ulBaudrates[b],
+                       (eModes[m] == CARD_POLLER_MODE_FULL) ? "full" : "change",
+                       (unsigned)ulNakRates[n] / 10u, xWireUs,
+                       xResult.sweep_mean_ms, xResult.sweep_max_ms,
+                       (xResult.sweep_max_ms <= CARD_POLLER_SWEEP_MS) ? "ok" : "OVER",
+                       xResult.frames_per_sweep, xResult.rtt_mean_us, (unsigned)xResult.rtt_max_us,
+                       (unsigned)xResult.failed, (unsigned)xResult.offline, xResult.hot_mean_us);
+            }
+        }
+    }
+
+    /* Below the poller, as the rest of the panel is */
+    vTaskPrioritySet(NULL, tskIDLE_PRIORITY + 1u);
+    printf("\nAlarm to controller record, %u events at %u Hz, change counter polling\n",
+           (unsigned)ulEvents, (unsigned)BENCH_EVENT_BAUDRATE);
+    printf("%10s %7s %12s %12s %7s %7s %9s %14s\n",
+           "trigger", "events", "mean_ms", "max_ms", "nfr", "missed", "scans", "last_scan_us");
+    prvRunLatencyCase(false);
+    prvRunLatencyCase(true);
+
+    exit(prvRunHeldCase() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+int main(int argc, char **argv)
+{
+    TaskHandle_t xBenchHandle;
+
+    stdio_init_all();
+
+    if (argc > 1) {
+        ulSweeps = (uint32_t)strtoul(argv[1], NULL, 0);
+        if (ulSweeps == 0) {
+            ulSweeps = BENCH_DEFAULT_SWEEPS;
+        }
+    }
+    if (argc > 2) {
+        ulEvents = (uint32_t)strtoul(argv[2], NULL, 0);
+        if (ulEvents == 0) {
+            ulEvents = BENCH_DEFAULT_EVENTS;
+        }
+    }
+
+    xTaskCreate(prvBenchTask, "Bench", configMINIMAL_STACK_SIZE * 4, NULL,
+                TASK_PRIORITY_COMMUNICATION, &xBenchHandle);
+    xBenchTask = xBenchHandle;
+
+#if (configUSE_CORE_AFFINITY == 1)
+    vTaskCoreAffinitySet(xBenchHandle, CORE_AFFINITY_COMMUNICATION);
+#endif
+
+    vTaskStartScheduler();
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,264 @@
+/**
+ * @file bench_core_channel.c
+ * @brief Host benchmark: sensor-to-comm handoff transports
+ *
+ * A producer task (sensor side) hands message pointers to a consumer
+ * task (comm side) through a FreeRTOS queue, a stream buffer, a direct
+ * task notification and the core_channel ring. Each transport gets a
+ * burst phase, which measures throughput with the producer retrying
+ * while the transport is full, and a paced phase of one message per
+ * tick, which measures send-to-receive latency with an idle consumer.
+ * The host kernel is single-core, so producer and consumer share one
+ * core; the cross-core figures come from the RP2040.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "stream_buffer.h"
+#include "core_channel.h"
+
+#define BENCH_BURST_MESSAGES    20000
+#define BENCH_PACED_MESSAGES    200
+#define BENCH_DEPTH             CORE_CHANNEL_SLOTS
+#define BENCH_RECEIVE_TIMEOUT   pdMS_TO_TICKS(1000)
+
+typedef struct {
+    uint64_t sent_ns;
+    uint32_t sequence;
+} bench_msg_t;
+
+typedef struct {
+    const char *name;
+    bool (*send)(bench_msg_t *pxMsg);
+    bench_msg_t *(*receive)(TickType_t xTimeout);
+} bench_transport_t;
+
+typedef struct {
+    uint32_t received;
+    uint32_t out_of_order;
+    uint64_t total_latency_ns;
+    uint64_t max_latency_ns;
+} bench_result_t;
+
+static bench_msg_t xMessages[BENCH_BURST_MESSAGES];
+
+static QueueHandle_t xQueue;
+static StreamBufferHandle_t xStream;
+static core_channel_t xChannel;
+static TaskHandle_t xConsumerHandle;
+
+static SemaphoreHandle_t xStart;
+static SemaphoreHandle_t xDone;
+static const bench_transport_t *pxActive;
+static uint32_t ulExpected;
+static bench_result_t xResult;
+
+static uint64_t prvNowNs(void)
+{
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return ((uint64_t)xNow.tv_sec * 1000000000ull) + (uint64_t)xNow.tv_nsec;
+}
+
+static bool prvQueueSend(bench_msg_t *pxMsg)
+{
+    return xQueueSend(xQueue, &pxMsg, 0) == pdTRUE;
+}
+
+static bench_msg_t *prvQueueReceive(TickType_t xTimeout)
+{
+    bench_msg_t *pxMsg = NULL;
+
+    (void)xQueueReceive(xQueue, &pxMsg, xTimeout);
+    return pxMsg;
+}
+
+static bool prvStreamSend(bench_msg_t *pxMsg)
+{
+    return xStreamBufferSend(xStream, &pxMsg, sizeof(pxMsg), 0) == sizeof(pxMsg);
+}
+
+static bench_msg_t *prvStreamReceive(TickType_t xTimeout)
+{
+    bench_msg_t *pxMsg = NULL;
+
+    if (xStreamBufferReceive(xStream, &pxMsg, sizeof(pxMsg), xTimeout) != sizeof(pxMsg)) {
+        return NULL;
+    }
+    return pxMsg;
+}
+
+/* A notification value holds one message: its index plus one */
+static bool prvNotifySend(bench_msg_t *pxMsg)
+{
+    return xTaskNotify(xConsumerHandle, (uint32_t)(pxMsg - xMessages) + 1u,
+                       eSetValueWithoutOverwrite) == pdPASS;
+}
+
+static bench_msg_t *prvNotifyReceive(TickType_t xTimeout)
+{
+    uint32_t ulValue = 0;
+
+    if (xTaskNotifyWait(0, UINT32_MAX, &ulValue, xTimeout) != pdTRUE || ulValue == 0) {
+        return NULL;
+    }
+    return &xMessages[ulValue - 1u];
+}
+
+static bool prvChannelSend(bench_msg_t *pxMsg)
+{
+    return core_channel_send(&xChannel, pxMsg);
+}
+
+static bench_msg_t *prvChannelReceive(TickType_t xTimeout)
+{
+    return (bench_msg_t *)core_channel_receive(&xChannel, xTimeout);
+}
+
+static const bench_transport_t xTransports[] = {
+    { "queue",        prvQueueSend,   prvQueueReceive   },
+    { "stream_buf",   prvStreamSend,  prvStreamReceive  },
+    { "notify",       prvNotifySend,  prvNotifyReceive  },
+    { "core_channel", prvChannelSend, prvChannelReceive },
+};
+
+static void prvConsumerTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    /* The channel's doorbell belongs to the consumer's core */
+    if (!core_channel_open(&xChannel)) {
+        printf("core_channel_open failed\n");
+        exit(EXIT_FAILURE);
+    }
+    xSemaphoreGive(xDone);
+
+    for (;;) {
+        uint32_t ulNext = 0;
+
+        xSemaphoreTake(xStart, portMAX_DELAY);
+
+        while (xResult.received < ulExpected) {
+            bench_msg_t *pxMsg = pxActive->receive(BENCH_RECEIVE_TIMEOUT);
+            uint64_t ullLatency;
+
+            if (pxMsg == NULL) {
+                break;
+            }
+            ullLatency = prvNowNs() - pxMsg->sent_ns;
+            xResult.total_latency_ns += ullLatency;
+            if (ullLatency > xResult.max_latency_ns) {
+                xResult.max_latency_ns = ullLatency;
+            }
+            if (pxMsg->sequence != ulNext) {
+                xResult.out_of_order++;
+            }
+            ulNext = pxMsg->sequence + 1u;
+            xResult.received++;
+        }
+
+        xSemaphoreGive(xDone);
+    }
+}
+
+/**
+ * @brief Send ulCount messages through the active transport
+ * @return Elapsed time from the first send to the consumer finishing
+ */
+static uint64_t prvRun(const bench_transport_t *pxTransport, uint32_t ulCount, bool xPaced)
+{
+    uint64_t ullStart;
+
+    pxActive = pxTransport;
+    ulExpected = ulCount;
+    xResult = (bench_result_t){ 0 };
+    xSemaphoreGive(xStart);
+
+    ullStart = prvNowNs();
+    for (uint32_t i = 0; i < ulCount; i++) {
+        bench_msg_t *pxMsg = &xMessages[i];
+
+        pxMsg->sequence = i;
+        pxMsg->sent_ns = prvNowNs();
+        while (!pxTransport->send(pxMsg)) {
+            taskYIELD();
+        }
+        if (xPaced) {
+            vTaskDelay(1);
+        }
+    }
+
+    xSemaphoreTake(xDone, portMAX_DELAY);
+    return prvNowNs() - ullStart;
+}
+
+static void prvProducerTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    core_channel_stats_t xStats;
+
+    xSemaphoreTake(xDone, portMAX_DELAY);
+
+    printf("\n%-13s %12s %10s %12s %12s %6s\n",
+           "transport", "burst_msg/s", "burst_ns", "paced_mean_us", "paced_max_us", "lost");
+    for (size_t t = 0; t < sizeof(xTransports) / sizeof(xTransports[0]); t++) {
+        const bench_transport_t *pxTransport = &xTransports[t];
+        uint64_t ullBurstNs = prvRun(pxTransport, BENCH_BURST_MESSAGES, false);
+        uint32_t ulLost = BENCH_BURST_MESSAGES - xResult.received + xResult.out_of_order;
+
+        (void)prvRun(pxTransport, BENCH_PACED_MESSAGES, true);
+        ulLost += BENCH_PACED_MESSAGES - xResult.received + xResult.out_of_order;
+
+        printf("%-13s %12.0f %10.0f %12.1f %12.1f %6u\n", pxTransport->name,
+               (double)BENCH_BURST_MESSAGES * 1e9 / (double)ullBurstNs,
+               (double)ullBurstNs / BENCH_BURST_MESSAGES,
+               xResult.received ? (double)xResult.total_latency_ns / xResult.received / 1e3 : 0.0,
+               (double)xResult.max_latency_ns / 1e3, (unsigned)ulLost);
+    }
+
+    core_channel_get_stats(&xChannel, &xStats);
+    printf("\ncore_channel: %u sent, %u full, %u doorbells\n",
+           (unsigned)xStats.sent, (unsigned)xStats.full, (unsigned)xStats.doorbells);
+
+    exit(EXIT_SUCCESS);
+}
+
+int main(void)
+{
+    TaskHandle_t xProducerHandle;
+
+    stdio_init_all();
+
+    xQueue = xQueueCreate(BENCH_DEPTH, sizeof(bench_msg_t *));
+    xStream = xStreamBufferCreate(BENCH_DEPTH * sizeof(bench_msg_t *), sizeof(bench_msg_t *));
+    xStart = xSemaphoreCreateBinary();
+    xDone = xSemaphoreCreateBinary();
+    if (xQueue == NULL || xStream == NULL || xStart == NULL || xDone == NULL) {
+        printf("Failed to create benchmark objects\n");
+        return EXIT_FAILURE;
+    }
+
+    xTaskCreate(prvConsumerTask, "Consumer", configMINIMAL_STACK_SIZE * 2, NULL,
+                tskIDLE_PRIORITY + 3, &xConsumerHandle);
+    xTaskCreate(prvProducerTask, "Producer", configMINIMAL_STACK_SIZE * 2, NULL,
+                tskIDLE_PRIORITY + 2, &xProducerHandle);
+
+#if (configUSE_CORE_AFFINITY == 1)
+    vTaskCoreAffinitySet(xProducerHandle, CORE_AFFINITY_SENSORS);
+    vTaskCoreAffinitySet(xConsumerHandle, CORE_AFFINITY_COMMUNICATION);
+#endif
+
+    vTaskStartScheduler();
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,225 @@
+/**
+ * @file bench_crc.c
+ * @brief Benchmark: CRC back ends
+ *
+ * Cross-checks the slicing-by-4 and DMA sniffer back ends against the
+ * bit-at-a-time reference (check values, then every length up to 67 at
+ * each word offset), and reports the throughput of each back end for
+ * both CRCs at the status frame size (30 bytes) up to 64 KB. The same
+ * source builds for the host (where the sniffer is the bit-serial model
+ * in sim_crc_dma.c, so its column checks the set-up rather than speed)
+ * and as a standalone RP2040 image, printed over USB stdio, where the
+ * sniffer column is the DMA channel and the CPU is free while it runs.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "crc.h"
+
+#ifdef FACP_HOST_BUILD
+#include <time.h>
+#define BENCH_BYTES             (16u * 1024u * 1024u)
+#else
+#include "hardware/clocks.h"
+#define BENCH_BYTES             (256u * 1024u)
+#endif
+
+#define BENCH_BUFFER_BYTES      (64u * 1024u)
+#define BENCH_CHECK_LENGTH      67u
+
+typedef enum {
+    BENCH_BITWISE = 0,
+    BENCH_SLICING,
+    BENCH_SNIFFER,
+    BENCH_BACKENDS
+} bench_backend_t;
+
+static const char *const pcBackendNames[BENCH_BACKENDS] = {
+    "bitwise",
+    "slicing-by-4",
+#ifdef FACP_HOST_BUILD
+    "dma sniffer (sim)",
+#else
+    "dma sniffer",
+#endif
+};
+
+static const char *const pcKindNames[CRC_KIND_COUNT] = {
+    "CRC-16/CCITT",
+    "CRC-32/IEEE",
+};
+
+static const uint32_t ulSizes[] = { 30u, 256u, 4096u, BENCH_BUFFER_BYTES };
+
+static uint8_t ucBuffer[BENCH_BUFFER_BYTES + 4u] __attribute__((aligned(4)));
+static volatile uint32_t ulSink;
+
+static uint64_t prvNowNs(void)
+{
+#ifdef FACP_HOST_BUILD
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return ((uint64_t)xNow.tv_sec * 1000000000u) + (uint64_t)xNow.tv_nsec;
+#else
+    return time_us_64() * 1000u;
+#endif
+}
+
+static void prvFillBuffer(void)
+{
+    uint32_t ulSeed = 12345u;
+
+    for (uint32_t i = 0; i < sizeof(ucBuffer); i++) {
+        ulSeed = (ulSeed * 1103515245u) + 12345u;
+        ucBuffer[i] = (uint8_t)(ulSeed >> 16);
+    }
+}
+
+static uint32_t prvCompute(bench_backend_t eBackend, crc_kind_t eKind,
+                           const uint8_t *pucData, uint32_t ulLength)
+{
+    switch (eBackend) {
+    case BENCH_BITWISE:
+        return crc_bitwise(eKind, pucData, ulLength);
+    case BENCH_SLICING:
+        return (eKind == CRC_KIND_16_CCITT) ? crc16_ccitt(pucData, ulLength) :
+                                              crc32_ieee(pucData, ulLength);
+    default:
+        return crc_dma_compute(eKind, pucData, ulLength);
+    }
+}
+
+/**
+ * @brief Check every back end against the reference
+ * @return Mismatches
+ */
+static uint32_t prvCrossCheck(void)
+{
+    static const uint8_t ucCheck[] = "123456789";
+    static const uint32_t ulCheckValues[CRC_KIND_COUNT] = { 0x29B1u, 0xCBF43926u };
+    uint32_t ulBuffers = 0;
+    uint32_t ulMismatches = 0;
+
+    for (uint32_t k = 0; k < CRC_KIND_COUNT; k++) {
+        printf("%-13s check:", pcKindNames[k]);
+        for (uint32_t b = 0; b < BENCH_BACKENDS; b++) {
+            uint32_t ulCrc = prvCompute((bench_backend_t)b, (crc_kind_t)k, ucCheck, 9u);
+
+            printf(" %08x", (unsigned)ulCrc);
+            if (ulCrc != ulCheckValues[k]) {
+                ulMismatches++;
+            }
+        }
+        printf("\n");
+    }
+
+    for (uint32_t k = 0; k < CRC_KIND_COUNT; k++) {
+        for (uint32_t ulOffset = 0; ulOffset < 4u; ulOffset++) {
+            for (uint32_t ulLength = 0; ulLength <= BENCH_CHECK_LENGTH; ulLength++) {
+                const uint8_t *pucData = &ucBuffer[ulOffset];
+                uint32_t ulReference = crc_bitwise((crc_kind_t)k, pucData, ulLength);
+
+                for (uint32_t b = BENCH_SLICING; b < BENCH_BACKENDS; b++) {
+                    if (prvCompute((bench_backend_t)b, (crc_kind_t)k, pucData, ulLength) !=
+                        ulReference) {
+                        ulMismatches++;
+                    }
+                }
+                ulBuffers++;
+            }
+        }
+    }
+
+    /* Incremental updates match a single pass */
+    if ((crc16_ccitt_update(crc16_ccitt(ucBuffer, 13u), &ucBuffer[13], 50u) !=
+         crc16_ccitt(ucBuffer, 63u)) ||
+        (crc32_ieee_update(crc32_ieee(ucBuffer, 13u), &ucBuffer[13], 50u) !=
+         crc32_ieee(ucBuffer, 63u))) {
+        ulMismatches++;
+    }
+
+    printf("Cross-check: %u buffers per back end, %u mismatches\n",
+           (unsigned)ulBuffers, (unsigned)ulMismatches);
+    return ulMismatches;
+}
+
+static void prvReport(bench_backend_t eBackend, uint32_t ulSize, uint64_t ullBytes,
+                      uint64_t ullElapsedNs, uint32_t ulCalls)
+{
+    uint64_t ullNs = (ullElapsedNs != 0u) ? ullElapsedNs : 1u;
+    uint32_t ulDeciMBps = (uint32_t)((ullBytes * 10000u) / ullNs);
+    uint32_t ulNsPerCall = (uint32_t)(ullElapsedNs / ulCalls);
+
+#ifdef FACP_HOST_BUILD
+    printf("  %-18s %6u B %8u.%u MB/s %10u ns/call\n", pcBackendNames[eBackend],
+           (unsigned)ulSize, (unsigned)(ulDeciMBps / 10u), (unsigned)(ulDeciMBps % 10u),
+           (unsigned)ulNsPerCall);
+#else
+    uint32_t ulMhz = clock_get_hz(clk_sys) / 1000000u;
+    uint32_t ulCentiCycles = (uint32_t)(((uint64_t)ullElapsedNs * ulMhz) / (ullBytes * 10u));
+
+    printf("  %-18s %6u B %8u.%u MB/s %10u ns/call %4u.%02u cycles/byte\n",
+           pcBackendNames[eBackend], (unsigned)ulSize,
+           (unsigned)(ulDeciMBps / 10u), (unsigned)(ulDeciMBps % 10u),
+           (unsigned)ulNsPerCall,
+           (unsigned)(ulCentiCycles / 100u), (unsigned)(ulCentiCycles % 100u));
+#endif
+}
+
+static void prvRunBenchmarks(void)
+{
+    prvFillBuffer();
+
+    printf("\nCRC back ends: %u bytes per row\n", (unsigned)BENCH_BYTES);
+    if (prvCrossCheck() != 0u) {
+        printf("FAIL: back ends disagree\n");
+    }
+
+    for (uint32_t k = 0; k < CRC_KIND_COUNT; k++) {
+        printf("\n%s\n", pcKindNames[k]);
+        for (uint32_t s = 0; s < (sizeof(ulSizes) / sizeof(ulSizes[0])); s++) {
+            uint32_t ulCalls = BENCH_BYTES / ulSizes[s];
+
+            for (uint32_t b = 0; b < BENCH_BACKENDS; b++) {
+                uint32_t ulCrc = 0;
+                uint64_t ullStart = prvNowNs();
+
+                for (uint32_t i = 0; i < ulCalls; i++) {
+                    ulCrc ^= prvCompute((bench_backend_t)b, (crc_kind_t)k, ucBuffer, ulSizes[s]);
+                }
+                prvReport((bench_backend_t)b, ulSizes[s], (uint64_t)ulCalls * ulSizes[s],
+                          prvNowNs() - ullStart, ulCalls);
+                ulSink = ulCrc;
+            }
+        }
+    }
+}
+
+int main(void)
+{
+#ifndef FACP_HOST_BUILD
+    stdio_init_all();
+
+    /* Give the USB host time to open the port */
+    sleep_ms(2000);
+#endif
+
+    if (!crc_dma_init()) {
+        printf("No free DMA channel for the sniffer\n");
+        return 1;
+    }
+    prvRunBenchmarks();
+
+#ifndef FACP_HOST_BUILD
+    for (;;) {
+        tight_loop_contents();
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file bench_detect_kernels.c
+ * @brief Benchmark: fixed-point detection kernels
+ * 
+ * Runs each detection kernel, and the fused bank step, over a bank of
+ * DETECT_MAX_BANK_ZONES zones and reports the cost per zone sample. The
+ * same source builds for the host (ns/sample) and as a standalone RP2040
+ * image (cycles/sample, printed over USB stdio), and finishes with the
+ * core-0 load for a full bank at the default ADC frame rate.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "pico/stdlib.h"
+#include "detect_kernels.h"
+
+#ifdef FACP_HOST_BUILD
+#include <time.h>
+#define BENCH_STEPS             200000u
+#else
+#include "hardware/clocks.h"
+#define BENCH_STEPS             2000u
+#endif
+
+#define BENCH_ZONES             DETECT_MAX_BANK_ZONES
+#define BENCH_PATTERN_STEPS     64u
+#define BENCH_FRAME_HZ          1000u     /* ADC_STREAM_DEFAULT_RATE_HZ */
+
+static uint16_t usPattern[BENCH_PATTERN_STEPS][BENCH_ZONES];
+static detect_bank_t xBank;
+static volatile uint32_t ulSink;
+
+static uint64_t prvNowNs(void)
+{
+#ifdef FACP_HOST_BUILD
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return ((uint64_t)xNow.tv_sec * 1000000000u) + (uint64_t)xNow.tv_nsec;
+#else
+    return time_us_64() * 1000u;
+#endif
+}
+
+static void prvFillPattern(void)
+{
+    uint32_t ulSeed = 12345u;
+
+    /* Noisy readings around mid-scale with a slow rise on every fourth zone */
+    for (uint32_t s = 0; s < BENCH_PATTERN_STEPS; s++) {
+        for (uint32_t z = 0; z < BENCH_ZONES; z++) {
+            ulSeed = (ulSeed * 1103515245u) + 12345u;
+            usPattern[s][z] = (uint16_t)(2048u + ((ulSeed >> 16) & 0x3Fu) +
+                                         (((z & 3u) == 0) ? (s * 8u) : 0u));
+        }
+    }
+}
+
+static void prvInitBank(void)
+{
+    xBank.count = BENCH_ZONES;
+    xBank.lowpass_alpha = Q15_FROM_RATIO(1, 4);
+    xBank.baseline_shift = 8;
+    xBank.slope_shift = 3;
+    xBank.ror_threshold = Q16_FROM_INT(4);
+    for (uint32_t z = 0; z < BENCH_ZONES; z++) {
+        xBank.on[z] = Q16_FROM_INT(200);
+        xBank.off[z] = Q16_FROM_INT(150);
+    }
+    detect_bank_init(&xBank, usPattern[0]);
+}
+
+static void prvReport(const char *name, uint64_t elapsed_ns)
+{
+    uint64_t ullSamples = (uint64_t)BENCH_STEPS * BENCH_ZONES;
+    uint32_t ulPsPerSample = (uint32_t)((elapsed_ns * 1000u) / ullSamples);
+
+#ifdef FACP_HOST_BUILD
+    printf("%-16s %8u.%03u ns/sample\n", name,
+           (unsigned)(ulPsPerSample / 1000u), (unsigned)(ulPsPerSample % 1000u));
+#else
+    uint32_t ulMhz = clock_get_hz(clk_sys) / 1000000u;
+    uint32_t ulCentiCycles = (uint32_t)(((uint64_t)ulPsPerSample * ulMhz) / 10000u);
+
+    printf("%-16s %8u.%03u ns/sample %6u.%02u cycles/sample\n", name,
+           (unsigned)(ulPsPerSample / 1000u), (unsigned)(ulPsPerSample % 1000u),
+           (unsigned)(ulCentiCycles / 100u), (unsigned)(ulCentiCycles % 100u));
+#endif
+}
+
+static void prvRunBenchmarks(void)
+{
+    uint64_t ullStart;
+    uint64_t ullFused;
+    uint64_t ullStepNs;
+    uint64_t ullPeriodNs = 1000000000u / BENCH_FRAME_HZ;
+    uint32_t ulMask = 0;
+
+    prvFillPattern();
+
+    printf("\nDetection kernels: %u zones x %u steps\n",
+           (unsigned)BENCH_ZONES, (unsigned)BENCH_STEPS);
+
+    prvInitBank();
+    ullStart = prvNowNs();
+    for (uint32_t s = 0; s < BENCH_STEPS; s++) {
+        detect_lowpass(xBank.filtered, usPattern[s % BENCH_PATTERN_STEPS],
+                       BENCH_ZONES, xBank.lowpass_alpha);
+    }
+    prvReport("lowpass", prvNowNs() - ullStart);
+
+    ullStart = prvNowNs();
+    for (uint32_t s = 0; s < BENCH_STEPS; s++) {
+        detect_ewma(xBank.baseline, xBank.filtered, BENCH_ZONES,
+                    xBank.baseline_shift, s & 0x5555u);
+    }
+    prvReport("ewma", prvNowNs() - ullStart);
+
+    ullStart = prvNowNs();
+    for (uint32_t s = 0; s < BENCH_STEPS; s++) {
+        ulMask ^= detect_rate_of_rise(xBank.slope, xBank.previous, xBank.filtered,
+                                      BENCH_ZONES, xBank.slope_shift,
+                                      xBank.ror_threshold);
+    }
+    prvReport("rate_of_rise", prvNowNs() - ullStart);
+
+    ullStart = prvNowNs();
+    for (uint32_t s = 0; s < BENCH_STEPS; s++) {
+        ulMask = detect_hysteresis(xBank.filtered, xBank.baseline, xBank.on,
+                                   xBank.off, BENCH_ZONES, ulMask);
+    }
+    prvReport("hysteresis", prvNowNs() - ullStart);
+
+    prvInitBank();
+    ullStart = prvNowNs();
+    for (uint32_t s = 0; s < BENCH_STEPS; s++) {
+        ulMask ^= detect_bank_step(&xBank, usPattern[s % BENCH_PATTERN_STEPS]);
+    }
+    ullFused = prvNowNs() - ullStart;
+    prvReport("bank_step", ullFused);
+
+    ulSink = ulMask;
+
+    /* One fused step per zone bank per ADC frame */
+    ullStepNs = ullFused / BENCH_STEPS;
+
+    printf("\n%u zones at %u Hz: %u ns per frame, %u.%02u%% of one core\n",
+           (unsigned)BENCH_ZONES, (unsigned)BENCH_FRAME_HZ,
+           (unsigned)ullStepNs,
+           (unsigned)((ullStepNs * 100u) / ullPeriodNs),
+           (unsigned)(((ullStepNs * 10000u) / ullPeriodNs) % 100u));
+}
+
+int main(void)
+{
+#ifndef FACP_HOST_BUILD
+    stdio_init_all();
+
+    /* Give the USB host time to open the port */
+    sleep_ms(2000);
+#endif
+
+    prvRunBenchmarks();
+
+#ifndef FACP_HOST_BUILD
+    for (;;) {
+        tight_loop_contents();
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file bench_status_snapshot.c
+ * @brief Host benchmark: status snapshot under cross-core contention
+ * 
+ * Host threads stand in for the two RP2040 cores: two writers publish
+ * self-checking zone masks while readers copy snapshots as fast as they
+ * can. Every copy is checked for tearing (fields from different
+ * publishes), and the report gives throughput, reads that raced a
+ * publish, and the worst-case publish and read times.
+ * 
+ * Usage: bench_status_snapshot [seconds [readers]]
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "status_snapshot.h"
+
+#define BENCH_WRITERS           2
+#define BENCH_MAX_READERS       8
+#define BENCH_DISABLED_XOR      0x5A5A5A5Au
+
+typedef struct {
+    uint32_t id;
+    uint64_t operations;
+    uint64_t torn;
+    uint64_t raced;                     /* Reads that overlapped a publish */
+    uint64_t max_ns;
+} bench_thread_t;
+
+static volatile bool xStop = false;
+
+static uint64_t prvNowNs(void)
+{
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return ((uint64_t)xNow.tv_sec * 1000000000u) + (uint64_t)xNow.tv_nsec;
+}
+
+static void *prvWriterThread(void *pvArg)
+{
+    bench_thread_t *pxThread = pvArg;
+    uint32_t ulAlarm[ZONE_MASK_WORDS];
+    uint32_t ulFault[ZONE_MASK_WORDS];
+    uint32_t ulDisabled[ZONE_MASK_WORDS];
+    uint32_t k = pxThread->id << 28;
+
+    while (!xStop) {
+        uint64_t ullStart;
+        uint64_t ullElapsed;
+
+        /* Every word of every field derives from k */
+        k = (k & 0xF0000000u) | ((k + 1u) & 0x0FFFFFFFu);
+        for (uint32_t w = 0; w < ZONE_MASK_WORDS; w++) {
+            ulAlarm[w] = k + w;
+            ulFault[w] = ~(k + w);
+            ulDisabled[w] = (k + w) ^ BENCH_DISABLED_XOR;
+        }
+
+        ullStart = prvNowNs();
+        status_snapshot_publish_masks(ulAlarm, ulFault, ulDisabled,
+                                      (k & 1u) ? SYSTEM_STATUS_ALARM : SYSTEM_STATUS_NORMAL);
+        ullElapsed = prvNowNs() - ullStart;
+
+        if (ullElapsed > pxThread->max_ns) {
+            pxThread->max_ns = ullElapsed;
+        }
+        pxThread->operations++;
+    }
+
+    return NULL;
+}
+
+static void *prvReaderThread(void *pvArg)
+{
+    bench_thread_t *pxThread = pvArg;
+    status_snapshot_t xCopy;
+
+    while (!xStop) {
+        uint32_t ulBefore = status_snapshot_get_sequence();
+        uint64_t ullStart = prvNowNs();
+        uint32_t ulSeq = status_snapshot_read(&xCopy);
+        uint64_t ullElapsed = prvNowNs() - ullStart;
+        uint32_t k = xCopy.alarm[0];
+        bool xTorn = false;
+
+        if (ulSeq != ulBefore) {
+            pxThread->raced++;
+        }
+
+        for (uint32_t w = 0; (ulSeq != 0) && (w < ZONE_MASK_WORDS); w++) {
+            xTorn |= (xCopy.alarm[w] != k + w) ||
+                     (xCopy.fault[w] != ~(k + w)) ||
+                     (xCopy.disabled[w] != ((k + w) ^ BENCH_DISABLED_XOR));
+        }
+        if ((ulSeq != 0) &&
+            (xCopy.system != ((k & 1u) ? SYSTEM_STATUS_ALARM : SYSTEM_STATUS_NORMAL))) {
+            xTorn = true;
+        }
+
+        pxThread->torn += xTorn ? 1u : 0u;
+        if (ullElapsed > pxThread->max_ns) {
+            pxThread->max_ns = ullElapsed;
+        }
+        pxThread->operations++;
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    pthread_t xThreads[BENCH_WRITERS + BENCH_MAX_READERS];
+    bench_thread_t xStats[BENCH_WRITERS + BENCH_MAX_READERS] = { 0 };
+    uint32_t ulSeconds = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 2u;
+    uint32_t ulReaders = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 10) : 2u;
+    uint32_t ulThreads;
+    uint64_t ullTorn = 0;
+
+    /* The rates are per second of the run */
+    if (ulSeconds == 0) {
+        printf("Usage: %s [seconds [readers]], seconds at least 1\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (ulReaders == 0 || ulReaders > BENCH_MAX_READERS) {
+        ulReaders = 2;
+    }
+    ulThreads = BENCH_WRITERS + ulReaders;
+
+    status_snapshot_init();
+
+    for (uint32_t i = 0; i < ulThreads; i++) {
+        xStats[i].id = i;
+        pthread_create(&xThreads[i], NULL,
+                       (i < BENCH_WRITERS) ? prvWriterThread : prvReaderThread,
+                       &xStats[i]);
+    }
+
+    sleep((unsigned)ulSeconds);
+    xStop = true;
+
+    for (uint32_t i = 0; i < ulThreads; i++) {
+        pthread_join(xThreads[i], NULL);
+    }
+
+    printf("\nStatus snapshot: %u writers, %u readers, %u s, %u mask words\n",
+           (unsigned)BENCH_WRITERS, (unsigned)ulReaders, (unsigned)ulSeconds,
+           (unsigned)ZONE_MASK_WORDS);
+    printf("%-8s %12s %12s %10s %8s %10s\n",
+           "thread", "ops/s", "ops", "raced", "torn", "max_ns");
+    for (uint32_t i = 0; i < ulThreads; i++) {
+        printf("%-6s%2u %12.0f %12llu %10llu %8llu %10llu\n",
+               (i < BENCH_WRITERS) ? "writer" : "reader", (unsigned)i,
+               (double)xStats[i].operations / ulSeconds,
+               (unsigned long long)xStats[i].operations,
+               (unsigned long long)xStats[i].raced,
+               (unsigned long long)xStats[i].torn,
+               (unsigned long long)xStats[i].max_ns);
+        ullTorn += xStats[i].torn;
+    }
+
+    return (ullTorn == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,301 @@
+/**
+ * @file bench_zone_filter.c
+ * @brief Host benchmark: zone input glitch filter thresholds
+ * 
+ * Runs the bit-exact model of the PIO filter over a zone input trace for
+ * a range of confirm counts and reports, per setting, how many events the
+ * sensor core would handle compared with raw GPIO edges, plus the added
+ * detection delay.
+ * 
+ * Usage: bench_zone_filter [trace.txt [sample_hz]]
+ * 
+ * A trace holds one sample per line as a hex digit (bit n = GPIO4+n);
+ * lines starting with '#' are ignored. Without a trace, a synthetic one
+ * with contact bounce and random glitch bursts is generated, and false,
+ * missed and delayed transitions are scored against its ground truth
+ * ("missed" counts inputs left in the wrong state at the end).
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "zone_filter.h"
+
+#define BENCH_SYNTH_SAMPLES         2000000u  /* 200 s at 10 kHz */
+#define BENCH_SYNTH_MIN_HOLD        5000u     /* Samples between real transitions */
+#define BENCH_SYNTH_MAX_HOLD        50000u
+#define BENCH_SYNTH_MAX_BOUNCE      15u       /* Bounce samples after a transition */
+#define BENCH_SYNTH_GLITCH_PER_MIL  1u        /* Glitch bursts per 1000 samples per input */
+#define BENCH_SYNTH_MAX_GLITCH      5u        /* Longest glitch burst */
+
+static const uint32_t ulConfirmCounts[] = { 1, 2, 3, 4, 6, 8, 12, 16, 24, 32 };
+
+typedef struct {
+    uint8_t *samples;
+    uint8_t *truth;                     /* NULL for recorded traces */
+    uint32_t count;
+} bench_trace_t;
+
+static uint32_t ulRandState = 0x2468ACE1u;
+
+static uint32_t prvRand(void)
+{
+    /* xorshift32: deterministic across runs */
+    ulRandState ^= ulRandState << 13;
+    ulRandState ^= ulRandState >> 17;
+    ulRandState ^= ulRandState << 5;
+    return ulRandState;
+}
+
+static uint32_t prvRandRange(uint32_t min, uint32_t max)
+{
+    return min + (prvRand() % (max - min + 1u));
+}
+
+static bool prvLoadTrace(const char *path, bench_trace_t *trace)
+{
+    FILE *fp = fopen(path, "r");
+    char line[64];
+    uint32_t capacity = 4096;
+
+    if (fp == NULL) {
+        perror(path);
+        return false;
+    }
+
+    trace->samples = malloc(capacity);
+    trace->truth = NULL;
+    trace->count = 0;
+    if (trace->samples == NULL) {
+        printf("Out of memory loading %s\n", path);
+        fclose(fp);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if ((line[0] == '#') || (line[0] == '\n')) {
+            continue;
+        }
+        if (trace->count == capacity) {
+            uint8_t *pucGrown = realloc(trace->samples, capacity * 2u);
+
+            /* realloc() leaves the old buffer allocated on failure */
+            if (pucGrown == NULL) {
+                printf("Out of memory loading %s\n", path);
+                free(trace->samples);
+                trace->samples = NULL;
+                fclose(fp);
+                return false;
+            }
+            trace->samples = pucGrown;
+            capacity *= 2u;
+        }
+        trace->samples[trace->count++] =
+            (uint8_t)(strtoul(line, NULL, 16) & ZONE_FILTER_INPUT_MASK);
+    }
+
+    fclose(fp);
+    if (trace->count == 0) {
+        printf("No samples in %s\n", path);
+        free(trace->samples);
+        trace->samples = NULL;
+        return false;
+    }
+    return true;
+}
+
+static bool prvSynthesizeTrace(bench_trace_t *trace)
+{
+    uint32_t ulNextChange[ZONE_FILTER_INPUT_COUNT];
+    uint32_t ulBounceEnd[ZONE_FILTER_INPUT_COUNT] = { 0 };
+    uint32_t ulGlitchEnd[ZONE_FILTER_INPUT_COUNT] = { 0 };
+    uint8_t ucTruth = 0;
+
+    trace->count = BENCH_SYNTH_SAMPLES;
+    trace->samples = malloc(trace->count);
+    trace->truth = malloc(trace->count);
+    if ((trace->samples == NULL) || (trace->truth == NULL)) {
+        return false;
+    }
+
+    for (uint32_t ch = 0; ch < ZONE_FILTER_INPUT_COUNT; ch++) {
+        ulNextChange[ch] = prvRandRange(BENCH_SYNTH_MIN_HOLD, BENCH_SYNTH_MAX_HOLD);
+    }
+
+    for (uint32_t i = 0; i < trace->count; i++) {
+        uint8_t ucSample;
+
+        for (uint32_t ch = 0; ch < ZONE_FILTER_INPUT_COUNT; ch++) {
+            if (i == ulNextChange[ch]) {
+                ucTruth ^= (uint8_t)(1u << ch);
+                ulBounceEnd[ch] = i + prvRandRange(0, BENCH_SYNTH_MAX_BOUNCE);
+                ulNextChange[ch] = i + prvRandRange(BENCH_SYNTH_MIN_HOLD,
+                                                    BENCH_SYNTH_MAX_HOLD);
+            }
+            if (((prvRand() % 1000u) < BENCH_SYNTH_GLITCH_PER_MIL) && (i >= ulGlitchEnd[ch])) {
+                ulGlitchEnd[ch] = i + prvRandRange(1, BENCH_SYNTH_MAX_GLITCH);
+            }
+        }
+
+        ucSample = ucTruth;
+        for (uint32_t ch = 0; ch < ZONE_FILTER_INPUT_COUNT; ch++) {
+            bool xBounce = (i < ulBounceEnd[ch]) && (prvRand() & 1u);
+
+            if (xBounce || (i < ulGlitchEnd[ch])) {
+                ucSample ^= (uint8_t)(1u << ch);
+            }
+        }
+
+        trace->truth[i] = ucTruth;
+        trace->samples[i] = ucSample;
+    }
+
+    return true;
+}
+
+static uint32_t prvCountChanges(const uint8_t *samples, uint32_t count)
+{
+    uint32_t ulChanges = 0;
+
+    for (uint32_t i = 1; i < count; i++) {
+        ulChanges += (uint32_t)__builtin_popcount(samples[i] ^ samples[i - 1]);
+    }
+    return ulChanges;
+}
+
+static void prvRunFilter(const bench_trace_t *trace, uint32_t confirm_samples,
+                         uint32_t sample_hz)
+{
+    zone_filter_model_t xModel;
+    uint32_t ulLastTruthChange[ZONE_FILTER_INPUT_COUNT] = { 0 };
+    uint32_t ulReported = ZONE_FILTER_INPUT_MASK; /* Real transitions already reported */
+    uint32_t ulEvents = 0;
+    uint32_t ulEdges = 0;
+    uint32_t ulFalse = 0;
+    uint32_t ulMaxDelay = 0;
+    uint64_t ullTotalDelay = 0;
+    uint32_t ulDelayCount = 0;
+    uint32_t ulFiltered = 0;
+    uint32_t ulMismatched = 0;
+    uint64_t ullStart;
+    uint64_t ullElapsed;
+
+    zone_filter_model_init(&xModel, confirm_samples);
+
+    ullStart = time_us_64();
+    for (uint32_t i = 0; i < trace->count; i++) {
+        uint32_t ulWord;
+
+        if (trace->truth != NULL && i > 0) {
+            uint32_t ulTruthChanged = trace->truth[i] ^ trace->truth[i - 1];
+
+            for (uint32_t ch = 0; ch < ZONE_FILTER_INPUT_COUNT; ch++) {
+                if (ulTruthChanged & (1u << ch)) {
+                    ulLastTruthChange[ch] = i;
+                }
+            }
+            ulReported &= ~ulTruthChanged;
+        }
+
+        if (!zone_filter_model_step(&xModel, trace->samples[i], &ulWord)) {
+            continue;
+        }
+        if (i == 0) {
+            ulFiltered = ZONE_FILTER_EVENT_NEW_STATE(ulWord);
+            continue;
+        }
+
+        uint32_t ulChanged = ZONE_FILTER_EVENT_NEW_STATE(ulWord) ^ ulFiltered;
+
+        ulEvents++;
+        ulEdges += (uint32_t)__builtin_popcount(ulChanged);
+        ulFiltered = ZONE_FILTER_EVENT_NEW_STATE(ulWord);
+
+        if (trace->truth == NULL) {
+            continue;
+        }
+        for (uint32_t ch = 0; ch < ZONE_FILTER_INPUT_COUNT; ch++) {
+            if (!(ulChanged & (1u << ch))) {
+                continue;
+            }
+            /* Anything but the first report of a real transition is false */
+            if ((((ulFiltered ^ trace->truth[i]) | ulReported) & (1u << ch)) != 0) {
+                ulFalse++;
+            } else {
+                uint32_t ulDelay = i - ulLastTruthChange[ch];
+
+                ulReported |= (1u << ch);
+                ullTotalDelay += ulDelay;
+                ulDelayCount++;
+                if (ulDelay > ulMaxDelay) {
+                    ulMaxDelay = ulDelay;
+                }
+            }
+        }
+    }
+    ullElapsed = time_us_64() - ullStart;
+
+    if (trace->truth != NULL) {
+        ulMismatched = (uint32_t)__builtin_popcount(ulFiltered ^ trace->truth[trace->count - 1]);
+    }
+
+    printf("%7u %8u %8u", (unsigned)confirm_samples, (unsigned)ulEvents,
+           (unsigned)ulEdges);
+    if (trace->truth != NULL) {
+        double dMeanUs = ulDelayCount ?
+            ((double)ullTotalDelay / ulDelayCount) * 1e6 / sample_hz : 0.0;
+
+        printf(" %7u %7u %10.1f %10.1f", (unsigned)ulFalse, (unsigned)ulMismatched,
+               dMeanUs, (double)ulMaxDelay * 1e6 / sample_hz);
+    }
+    printf(" %10.2f\n", (double)ullElapsed * 1000.0 / trace->count);
+}
+
+int main(int argc, char *argv[])
+{
+    bench_trace_t xTrace;
+    uint32_t ulSampleHz = ZONE_FILTER_DEFAULT_SAMPLE_HZ;
+
+    if (argc > 2) {
+        ulSampleHz = (uint32_t)strtoul(argv[2], NULL, 10);
+        if (ulSampleHz == 0) {
+            fprintf(stderr, "Invalid sample rate: %s\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc > 1) {
+        if (!prvLoadTrace(argv[1], &xTrace)) {
+            return EXIT_FAILURE;
+        }
+        printf("Trace %s: %u samples at %u Hz\n", argv[1],
+               (unsigned)xTrace.count, (unsigned)ulSampleHz);
+    } else {
+        if (!prvSynthesizeTrace(&xTrace)) {
+            return EXIT_FAILURE;
+        }
+        printf("Synthetic trace: %u samples at %u Hz, %u real transitions\n",
+               (unsigned)xTrace.count, (unsigned)ulSampleHz,
+               (unsigned)prvCountChanges(xTrace.truth, xTrace.count));
+    }
+    printf("Raw GPIO edges (one interrupt each): %u\n\n",
+           (unsigned)prvCountChanges(xTrace.samples, xTrace.count));
+
+    printf("%7s %8s %8s", "confirm", "events", "edges");
+    if (xTrace.truth != NULL) {
+        printf(" %7s %7s %10s %10s", "false", "missed", "mean_us", "max_us");
+    }
+    printf(" %10s\n", "ns/sample");
+
+    for (size_t i = 0; i < sizeof(ulConfirmCounts) / sizeof(ulConfirmCounts[0]); i++) {
+        prvRunFilter(&xTrace, ulConfirmCounts[i], ulSampleHz);
+    }
+
+    free(xTrace.samples);
+    free(xTrace.truth);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file bench_zone_latency.c
+ * @brief Host benchmark: zone input edge-to-task latency
+ * 
+ * Injects simulated edges on the zone inputs from a low-priority stimulus
+ * task and reports the latency from the edge timestamp to the sensor
+ * monitor consuming it, and the edge-to-output latency of the alarm
+ * outputs the monitor drives. The PIO filter is not simulated, so this
+ * is the task path; the interrupt fast path is measured on target with
+ * the trace. Each fire input is reset as it clears, so every rising edge
+ * asserts its output again. A final check holds zone 1 in alarm, drops
+ * its input and fails the run unless the output stays latched until the
+ * reset. Trace builds also dump the kernel trace of the run.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hal_sim.h"
+#include "zone_input.h"
+#include "sensor_monitor.h"
+#include "alarm_output.h"
+#include "zone_table.h"
+#include "task_table.h"
+#include "trace.h"
+
+#define BENCH_EDGES             2000
+#define BENCH_EDGE_INTERVAL_MS  2
+#define BENCH_SETTLE_MS         20
+
+/**
+ * @brief Check that a fire alarm stays latched after its input clears
+ * @return true if the output held until the reset and was then released
+ */
+static bool prvCheckLatch(void)
+{
+    const uint32_t ulZone = ZONE_MASK_BIT(0);
+    bool xLatched;
+    bool xReleased;
+
+    hal_sim_gpio_set_input(BOARD_PIN_FIRE_ZONE_1, true);
+    vTaskDelay(pdMS_TO_TICKS(BENCH_SETTLE_MS));
+    hal_sim_gpio_set_input(BOARD_PIN_FIRE_ZONE_1, false);
+    vTaskDelay(pdMS_TO_TICKS(BENCH_SETTLE_MS));
+
+    xLatched = ((alarm_output_get_active() & ulZone) != 0) &&
+               (zone_table_get_status(0) == ZONE_STATUS_ALARM);
+
+    sensor_monitor_reset_alarms(ulZone);
+    vTaskDelay(pdMS_TO_TICKS(BENCH_SETTLE_MS));
+
+    xReleased = ((alarm_output_get_active() & ulZone) == 0) &&
+                (zone_table_get_status(0) == ZONE_STATUS_NORMAL);
+
+    printf("\nalarm latch: output %s after the input cleared, %s by the reset\n",
+           xLatched ? "held" : "DROPPED", xReleased ? "released" : "NOT released");
+    return xLatched && xReleased;
+}
+
+static void prvStimulusTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    bool xLevel[ZONE_INPUT_CHANNEL_COUNT] = { false };
+
+    /* Let the sensor monitor configure the inputs */
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    for (uint32_t i = 0; i < BENCH_EDGES; i++) {
+        uint32_t ch = i % ZONE_INPUT_CHANNEL_COUNT;
+
+        xLevel[ch] = !xLevel[ch];
+        hal_sim_gpio_set_input(ZONE_INPUT_FIRST_GPIO + ch, xLevel[ch]);
+        if (!xLevel[ch] && (ch < SENSOR_MONITOR_INPUT_ZONES)) {
+            sensor_monitor_reset_alarms(ZONE_MASK_BIT(ch));
+        }
+        vTaskDelay(pdMS_TO_TICKS(BENCH_EDGE_INTERVAL_MS));
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    printf("\n%-10s %8s %9s %10s %10s %10s\n",
+           "channel", "edges", "overruns", "mean_us", "max_us", "last_us");
+    for (uint32_t ch = 0; ch < ZONE_INPUT_CHANNEL_COUNT; ch++) {
+        zone_input_stats_t xStats;
+
+        zone_input_get_stats((zone_input_channel_t)ch, &xStats);
+        printf("GPIO%-6u %8u %9u %10.1f %10u %10u\n",
+               (unsigned)(ZONE_INPUT_FIRST_GPIO + ch),
+               (unsigned)xStats.edges, (unsigned)xStats.overruns,
+               xStats.edges ? (double)xStats.total_latency_us / xStats.edges : 0.0,
+               (unsigned)xStats.max_latency_us, (unsigned)xStats.last_latency_us);
+    }
+
+    alarm_output_stats_t xOutput;
+
+    alarm_output_get_stats(&xOutput);
+    printf("\nalarm outputs: %u task asserts, max %u us edge-to-output\n",
+           (unsigned)xOutput.task_asserts, (unsigned)xOutput.max_task_latency_us);
+
+    bool xPass = prvCheckLatch();
+
+    /* With -DFACP_TRACE=ON, append the trace for tools/trace_convert.py */
+    trace_dump();
+
+    exit(xPass ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+int main(void)
+{
+    stdio_init_all();
+    zone_table_init(SENSOR_MONITOR_INPUT_ZONES);
+    alarm_output_init(false);
+
+    if (!task_table_create(TASK_ID_SENSOR_MONITOR)) {
+        printf("Failed to create Sensor Monitor task\n");
+        return EXIT_FAILURE;
+    }
+
+    xTaskCreate(prvStimulusTask, "Stimulus", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 1, NULL);
+
+    vTaskStartScheduler();
+    return EXIT_FAILURE;
+}
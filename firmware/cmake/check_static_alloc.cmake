@@ -0,0 +1,39 @@
+# Static Allocation Check for FACP iZone
+# Run after linking a FACP_STATIC_ALLOCATION image: fails the build if the
+# ELF still defines a FreeRTOS heap or C library allocator, i.e. if any
+# code path survived --gc-sections that can allocate dynamically.
+#
+# Usage: cmake -DNM=<nm> -DELF=<image.elf> -P check_static_alloc.cmake
+
+execute_process(
+    COMMAND ${NM} --defined-only ${ELF}
+    OUTPUT_VARIABLE nm_output
+    RESULT_VARIABLE nm_result
+)
+if(NOT nm_result EQUAL 0)
+    message(FATAL_ERROR "check_static_alloc: could not read symbols of ${ELF}")
+endif()
+
+set(allocators
+    pvPortMalloc vPortFree
+    malloc calloc realloc free
+    _malloc_r _calloc_r _realloc_r _free_r
+    __wrap_malloc __wrap_calloc __wrap_realloc __wrap_free
+)
+
+set(found)
+string(REPLACE "\n" ";" nm_lines "${nm_output}")
+foreach(line IN LISTS nm_lines)
+    string(REGEX MATCH "[^ ]+$" symbol "${line}")
+    list(FIND allocators "${symbol}" index)
+    if(NOT index EQUAL -1)
+        list(APPEND found ${symbol})
+    endif()
+endforeach()
+
+if(found)
+    list(REMOVE_DUPLICATES found)
+    string(REPLACE ";" ", " found "${found}")
+    message(FATAL_ERROR "Static allocation build links dynamic allocators: ${found}\n"
+                        "Find the caller with -Wl,--trace-symbol=<name>.")
+endif()
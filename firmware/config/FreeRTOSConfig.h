@@ -24,16 +24,36 @@
 #define configMAX_PRIORITIES                    32
 #define configMINIMAL_STACK_SIZE                (configSTACK_DEPTH_TYPE)256
 #define configUSE_16_BIT_TICKS                  0
+#define configSTACK_DEPTH_TYPE                  uint32_t
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2  /* Index 1: inter-core channel doorbell */
 
 /* SMP Configuration for RP2040 dual-core */
+#if defined(FACP_HOST_BUILD)
+#define configNUMBER_OF_CORES                   FACP_HOST_CORES  /* Host build: 1 (POSIX port) */
+#else
 #define configNUMBER_OF_CORES                   2
+#endif
+#if (configNUMBER_OF_CORES > 1)
 #define configUSE_CORE_AFFINITY                 1
+#else
+#define configUSE_CORE_AFFINITY                 0
+#endif
 #define configUSE_PASSIVE_IDLE_HOOK             0
 
 /* Memory allocation related definitions. */
+#ifndef FACP_STATIC_ALLOCATION
+#define FACP_STATIC_ALLOCATION                  0
+#endif
+
 #define configSUPPORT_STATIC_ALLOCATION         1
+#if FACP_STATIC_ALLOCATION
+/* Every kernel object comes from static storage; no heap is linked */
+#define configSUPPORT_DYNAMIC_ALLOCATION        0
+#define configTOTAL_HEAP_SIZE                   0
+#else
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
 #define configTOTAL_HEAP_SIZE                   (96*1024)  /* Optimized for RP2040-Zero */
+#endif
 #define configAPPLICATION_ALLOCATED_HEAP        0
 #define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP 0
 
@@ -42,14 +62,23 @@
 
 /* Hook function related definitions. */
 #define configCHECK_FOR_STACK_OVERFLOW          2
-#define configUSE_MALLOC_FAILED_HOOK            1
+#define configUSE_MALLOC_FAILED_HOOK            configSUPPORT_DYNAMIC_ALLOCATION
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
+#define configRUN_TIME_COUNTER_TYPE             uint64_t  /* 1 MHz, never wraps */
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    1
 
+/* Run-time counter: microseconds from the 64-bit hardware timer (freertos_config.c) */
+#ifndef __ASSEMBLER__
+extern void vPortConfigureTimerForRunTimeStats(void);
+extern uint64_t ulGetRunTimeCounterValue(void);
+#endif
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    vPortConfigureTimerForRunTimeStats()
+#define portGET_RUN_TIME_COUNTER_VALUE()            ulGetRunTimeCounterValue()
+
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
 #define configMAX_CO_ROUTINE_PRIORITIES         1
@@ -89,7 +118,7 @@
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
 #define INCLUDE_uxTaskGetStackHighWaterMark     1
-#define INCLUDE_xTaskGetIdleTaskHandle          0
+#define INCLUDE_xTaskGetIdleTaskHandle          1
 #define INCLUDE_eTaskGetState                   1
 #define INCLUDE_xEventGroupSetBitFromISR        1
 #define INCLUDE_xTimerPendFunctionCall          1
@@ -97,7 +126,8 @@
 #define INCLUDE_xTaskGetHandle                  0
 #define INCLUDE_xTaskResumeFromISR              1
 
-/* A header file that defines trace macros can be included here. */
+/* Trace macros: CPU load accounting and the FACP_TRACE event recorder */
+#include "trace_hooks.h"
 
 /* Fire Safety System Specific Priorities */
 #define TASK_PRIORITY_WATCHDOG                  (configMAX_PRIORITIES - 1)  /* Highest */
@@ -106,6 +136,8 @@
 #define TASK_PRIORITY_COMMUNICATION             (configMAX_PRIORITIES - 4)  /* High */
 #define TASK_PRIORITY_STATUS_LED                (configMAX_PRIORITIES - 8)  /* Medium */
 #define TASK_PRIORITY_DIAGNOSTICS               (configMAX_PRIORITIES - 10) /* Low */
+#define TASK_PRIORITY_LOG_DRAIN                 (tskIDLE_PRIORITY + 1)      /* Lowest */
+#define TASK_PRIORITY_SMP_TEST                  (tskIDLE_PRIORITY + 1)      /* Lowest */
 
 /* Task Stack Sizes (in words) - Optimized for SMP operation */
 #define TASK_STACK_SIZE_SENSOR_MONITOR          512  /* Core 0 - Critical sensor processing */
@@ -114,6 +146,8 @@
 #define TASK_STACK_SIZE_STATUS_LED              256  /* Core 1 - Non-critical UI operations */
 #define TASK_STACK_SIZE_DIAGNOSTICS             512  /* Core 1 - System diagnostics */
 #define TASK_STACK_SIZE_WATCHDOG                256  /* Core 0 - Critical safety monitor */
+#define TASK_STACK_SIZE_LOG_DRAIN               384  /* Core 1 - Console output */
+#define TASK_STACK_SIZE_SMP_TEST                256  /* Both - SMP demonstration */
 
 /* Core Affinity Task Assignments */
 #define TASK_CORE_AFFINITY_SENSOR_MONITOR       CORE_AFFINITY_SENSORS
@@ -122,6 +156,20 @@
 #define TASK_CORE_AFFINITY_STATUS_LED           CORE_AFFINITY_COMMUNICATION
 #define TASK_CORE_AFFINITY_DIAGNOSTICS          CORE_AFFINITY_COMMUNICATION
 #define TASK_CORE_AFFINITY_WATCHDOG             CORE_AFFINITY_SENSORS
+#define TASK_CORE_AFFINITY_LOG_DRAIN            CORE_AFFINITY_COMMUNICATION
+
+/* Task Periods (ms) of table tasks not paced by their own module */
+#define TASK_PERIOD_MS_STATUS_LED               500
+#define TASK_PERIOD_MS_SMP_TEST                 5000
+
+/* Task RAM (static stacks and TCBs) per core, checked by task_table.c */
+#if defined(FACP_HOST_BUILD)
+#define TASK_RAM_BUDGET_CORE0                   (20 * 1024)  /* 64-bit stack words */
+#define TASK_RAM_BUDGET_CORE1                   (20 * 1024)
+#else
+#define TASK_RAM_BUDGET_CORE0                   (8 * 1024)
+#define TASK_RAM_BUDGET_CORE1                   (8 * 1024)
+#endif
 
 /* Queue Sizes */
 #define QUEUE_SIZE_SENSOR_DATA                  8
@@ -131,6 +179,11 @@
 /* Timeouts */
 #define TIMEOUT_SENSOR_RESPONSE_MS              100
 #define TIMEOUT_COMMUNICATION_MS                1000
-#define TIMEOUT_WATCHDOG_RESET_MS               30000
+#define TIMEOUT_WATCHDOG_RESET_MS               500     /* Unfed time before reset */
+
+/* Heartbeat deadlines of supervised tasks (see supervisor.h) */
+#define TIMEOUT_HEARTBEAT_SENSOR_MS             250
+#define TIMEOUT_HEARTBEAT_STATUS_LED_MS         1000
+#define TIMEOUT_HEARTBEAT_CARD_POLLER_MS        1000
 
 #endif /* FREERTOS_CONFIG_H */ 
\ No newline at end of file
@@ -0,0 +1,110 @@
+/**
+ * @file trace_hooks.h
+ * @brief FreeRTOS trace macro definitions for FACP iZone
+ *
+ * Included from FreeRTOSConfig.h, so it is compiled into the kernel and
+ * must not depend on firmware headers. The task switch hook always
+ * feeds the CPU load accounting (cpu_load.c); with FACP_TRACE=1 the
+ * kernel events below are also written to the per-core trace rings
+ * (trace.c, see include/trace.h for the dump and export API).
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef TRACE_HOOKS_H
+#define TRACE_HOOKS_H
+
+#include <stdint.h>
+
+#ifndef FACP_TRACE
+#define FACP_TRACE                  0
+#endif
+
+/* Event types; the trace dump format and tools/trace_convert.py use these values */
+#define TRACE_EVT_TASK_IN           1   /* id: task number */
+#define TRACE_EVT_TASK_OUT          2   /* id: task number */
+#define TRACE_EVT_QUEUE_CREATE      3   /* id: queue number, arg: queue type */
+#define TRACE_EVT_QUEUE_SEND        4   /* id: queue number, arg: queue type */
+#define TRACE_EVT_QUEUE_SEND_FAILED 5
+#define TRACE_EVT_QUEUE_RECEIVE     6
+#define TRACE_EVT_QUEUE_RECEIVE_FAILED 7
+#define TRACE_EVT_QUEUE_SEND_ISR    8
+#define TRACE_EVT_QUEUE_RECEIVE_ISR 9
+#define TRACE_EVT_QUEUE_BLOCK       10  /* Task blocks on an empty or full queue */
+#define TRACE_EVT_NOTIFY            11  /* id: notified task, arg: notification index */
+#define TRACE_EVT_NOTIFY_ISR        12
+#define TRACE_EVT_NOTIFY_TAKE       13  /* id: current task, arg: notification index */
+#define TRACE_EVT_NOTIFY_WAIT       14
+#define TRACE_EVT_PRIORITY_INHERIT  15  /* id: mutex holder, arg: new priority */
+#define TRACE_EVT_PRIORITY_DISINHERIT 16 /* id: mutex holder, arg: restored priority */
+#define TRACE_EVT_ISR_ENTER         17  /* id: trace_isr_t */
+#define TRACE_EVT_ISR_EXIT          18
+#define TRACE_EVT_ALARM_OUTPUT      19  /* id: edge-to-output us, arg: zone | source << 4 */
+
+#ifndef __ASSEMBLER__
+
+/* Per-core idle accounting (cpu_load.c) */
+extern void cpu_load_task_switched_in(void);
+
+#if FACP_TRACE
+
+extern void trace_record(uint8_t type, uint8_t arg, uint16_t id);
+extern void trace_record_current_task(uint8_t type, uint8_t arg);
+extern uint16_t trace_next_queue_number(void);
+
+#define traceTASK_SWITCHED_IN()                                             \
+    do {                                                                    \
+        cpu_load_task_switched_in();                                        \
+        trace_record_current_task(TRACE_EVT_TASK_IN, 0);                    \
+    } while (0)
+#define traceTASK_SWITCHED_OUT()                                            \
+    trace_record_current_task(TRACE_EVT_TASK_OUT, 0)
+
+/* Queues, semaphores and mutexes; ucQueueType tells them apart */
+#define traceQUEUE_CREATE(pxNewQueue)                                       \
+    do {                                                                    \
+        (pxNewQueue)->uxQueueNumber = trace_next_queue_number();            \
+        trace_record(TRACE_EVT_QUEUE_CREATE, (pxNewQueue)->ucQueueType,     \
+                     (uint16_t)(pxNewQueue)->uxQueueNumber);                \
+    } while (0)
+#define TRACE_QUEUE_EVENT(type, pxQueue)                                    \
+    trace_record((type), (pxQueue)->ucQueueType, (uint16_t)(pxQueue)->uxQueueNumber)
+#define traceQUEUE_SEND(pxQueue)            TRACE_QUEUE_EVENT(TRACE_EVT_QUEUE_SEND, pxQueue)
+#define traceQUEUE_SEND_FAILED(pxQueue)     TRACE_QUEUE_EVENT(TRACE_EVT_QUEUE_SEND_FAILED, pxQueue)
+#define traceQUEUE_RECEIVE(pxQueue)         TRACE_QUEUE_EVENT(TRACE_EVT_QUEUE_RECEIVE, pxQueue)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)  TRACE_QUEUE_EVENT(TRACE_EVT_QUEUE_RECEIVE_FAILED, pxQueue)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)   TRACE_QUEUE_EVENT(TRACE_EVT_QUEUE_SEND_ISR, pxQueue)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue) TRACE_QUEUE_EVENT(TRACE_EVT_QUEUE_RECEIVE_ISR, pxQueue)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)    TRACE_QUEUE_EVENT(TRACE_EVT_QUEUE_BLOCK, pxQueue)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) TRACE_QUEUE_EVENT(TRACE_EVT_QUEUE_BLOCK, pxQueue)
+
+/* Direct-to-task notifications; expanded in tasks.c where pxTCB is the target */
+#define traceTASK_NOTIFY(uxIndexToNotify)                                   \
+    trace_record(TRACE_EVT_NOTIFY, (uint8_t)(uxIndexToNotify), (uint16_t)pxTCB->uxTCBNumber)
+#define traceTASK_NOTIFY_FROM_ISR(uxIndexToNotify)                          \
+    trace_record(TRACE_EVT_NOTIFY_ISR, (uint8_t)(uxIndexToNotify), (uint16_t)pxTCB->uxTCBNumber)
+#define traceTASK_NOTIFY_GIVE_FROM_ISR(uxIndexToNotify)                     \
+    trace_record(TRACE_EVT_NOTIFY_ISR, (uint8_t)(uxIndexToNotify), (uint16_t)pxTCB->uxTCBNumber)
+#define traceTASK_NOTIFY_TAKE(uxIndexToWait)                                \
+    trace_record_current_task(TRACE_EVT_NOTIFY_TAKE, (uint8_t)(uxIndexToWait))
+#define traceTASK_NOTIFY_WAIT(uxIndexToWait)                                \
+    trace_record_current_task(TRACE_EVT_NOTIFY_WAIT, (uint8_t)(uxIndexToWait))
+
+/* Priority inheritance shows priority inversions on mutexes */
+#define traceTASK_PRIORITY_INHERIT(pxTCBOfMutexHolder, uxInheritedPriority) \
+    trace_record(TRACE_EVT_PRIORITY_INHERIT, (uint8_t)(uxInheritedPriority), \
+                 (uint16_t)(pxTCBOfMutexHolder)->uxTCBNumber)
+#define traceTASK_PRIORITY_DISINHERIT(pxTCBOfMutexHolder, uxOriginalPriority) \
+    trace_record(TRACE_EVT_PRIORITY_DISINHERIT, (uint8_t)(uxOriginalPriority), \
+                 (uint16_t)(pxTCBOfMutexHolder)->uxTCBNumber)
+
+#else /* FACP_TRACE */
+
+#define traceTASK_SWITCHED_IN()     cpu_load_task_switched_in()
+
+#endif /* FACP_TRACE */
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* TRACE_HOOKS_H */
@@ -0,0 +1,148 @@
+/**
+ * @file hal_sim.h
+ * @brief Simulated HAL control interface for the host build
+ * 
+ * The host stand-ins for GPIO, ADC, I2C (with simulated zone cards),
+ * UART and watchdog are driven from this interface by benchmarks and
+ * stimulus tasks. Injection calls that raise a simulated interrupt run
+ * the handler in the caller's context, so they should be made from a
+ * FreeRTOS task when the handler uses FromISR kernel APIs.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Simulated I2C device attached to a bus address
+ * 
+ * Callbacks return the number of bytes transferred, or a negative
+ * PICO_ERROR_* code to NAK the transfer.
+ */
+typedef struct {
+    int (*write)(void *ctx, const uint8_t *src, size_t len, bool nostop);
+    int (*read)(void *ctx, uint8_t *dst, size_t len, bool nostop);
+    void *ctx;
+} hal_sim_i2c_device_t;
+
+/**
+ * @brief Drive a simulated GPIO input level
+ * 
+ * Raises the registered GPIO callback if the resulting edge is enabled.
+ * 
+ * @param gpio GPIO number
+ * @param level New input level
+ */
+void hal_sim_gpio_set_input(uint gpio, bool level);
+
+/**
+ * @brief Read back the level last written to a simulated GPIO output
+ * @param gpio GPIO number
+ * @return Output latch value
+ */
+bool hal_sim_gpio_get_output(uint gpio);
+
+/**
+ * @brief Set the raw value returned for a simulated ADC channel
+ * 
+ * Also feeds the simulated ADC stream sampler, which reads the channels
+ * round-robin once per block period.
+ * 
+ * @param channel ADC input (0-4)
+ * @param value 12-bit sample value
+ */
+void hal_sim_adc_set_value(uint channel, uint16_t value);
+
+/**
+ * @brief Attach a simulated device to an I2C bus address
+ * @param bus_index I2C instance number (0 or 1)
+ * @param addr 7-bit device address
+ * @param device Device callbacks (NULL to detach)
+ * @return true if attached, false if the address is invalid
+ */
+bool hal_sim_i2c_attach(uint bus_index, uint8_t addr,
+                        const hal_sim_i2c_device_t *device);
+
+/**
+ * @brief Attach simulated zone cards at consecutive I2C addresses
+ *
+ * Each card serves a valid status_link.h frame (system normal, no zones
+ * active) at every offset, as the real card's slave does. Attaching
+ * again resets the cards.
+ *
+ * @param bus_index I2C instance number (0 or 1)
+ * @param first_addr Address of card 0
+ * @param count Number of cards (at most 32)
+ * @return Cards attached
+ */
+uint32_t hal_sim_zone_cards_attach(uint bus_index, uint8_t first_addr, uint32_t count);
+
+/**
+ * @brief Make the simulated cards NAK a share of their transactions
+ * @param nak_permille NAKs per thousand offset writes (0 for none)
+ * @param seed Seed of the pseudo-random sequence
+ */
+void hal_sim_zone_cards_set_nak_rate(uint32_t nak_permille, uint32_t seed);
+
+/**
+ * @brief Set the zone state a simulated card reports
+ *
+ * If the masks change, publishes a new frame with the next sequence
+ * number and change counter, and asserts the card's attention output
+ * until the next read from register 0. The system status follows the
+ * masks (alarm over fault over normal).
+ *
+ * @param card Card index
+ * @param alarm Zones in alarm, bit 0 = zone 1
+ * @param fault Zones in fault
+ */
+void hal_sim_zone_cards_set_zones(uint32_t card, uint8_t alarm, uint8_t fault);
+
+/**
+ * @brief Make a simulated card change on every read of its counter
+ *
+ * Each read from register 0 publishes a new frame (zone 1 fault
+ * toggled) before it is returned, so the card keeps its attention
+ * output asserted. Enabling it publishes a change at once; disabling
+ * it leaves the line held until the next read.
+ *
+ * @param card Card index
+ * @param enabled true to chatter
+ */
+void hal_sim_zone_cards_set_chatter(uint32_t card, bool enabled);
+
+/**
+ * @brief Get the number of transactions a simulated card has NAKed
+ * @param card Card index
+ * @return NAKs since attaching
+ */
+uint32_t hal_sim_zone_cards_get_naks(uint32_t card);
+
+/**
+ * @brief Queue bytes to be returned by uart_getc()
+ * @param uart_index UART instance number (0 or 1)
+ * @param data Bytes to queue
+ * @param len Number of bytes
+ * @return Number of bytes queued
+ */
+size_t hal_sim_uart_inject(uint uart_index, const uint8_t *data, size_t len);
+
+/**
+ * @brief Check whether the simulated watchdog would have fired
+ * @return true if enabled and not fed within its timeout
+ */
+bool hal_sim_watchdog_expired(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_SIM_H */
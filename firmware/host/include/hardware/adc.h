@@ -0,0 +1,35 @@
+/**
+ * @file adc.h
+ * @brief Host stand-in for hardware/adc.h
+ * 
+ * Simulated 12-bit ADC: each channel returns the value last set with
+ * hal_sim_adc_set_value().
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HOST_HARDWARE_ADC_H
+#define HOST_HARDWARE_ADC_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ADC_CHANNEL_COUNT   5   /* ADC0-ADC3 plus the temperature sensor */
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+uint adc_get_selected_input(void);
+void adc_set_round_robin(uint input_mask);
+void adc_set_temp_sensor_enabled(bool enable);
+uint16_t adc_read(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_HARDWARE_ADC_H */
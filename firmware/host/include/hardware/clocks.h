@@ -0,0 +1,42 @@
+/**
+ * @file clocks.h
+ * @brief Host stand-in for hardware/clocks.h
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HOST_HARDWARE_CLOCKS_H
+#define HOST_HARDWARE_CLOCKS_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum clock_index {
+    clk_gpout0 = 0,
+    clk_gpout1,
+    clk_gpout2,
+    clk_gpout3,
+    clk_ref,
+    clk_sys,
+    clk_peri,
+    clk_usb,
+    clk_adc,
+    clk_rtc,
+    CLK_COUNT
+};
+
+/**
+ * @brief Get the nominal frequency of a clock
+ * @return 125 MHz for clk_sys/clk_peri, 48 MHz for clk_usb/clk_adc
+ */
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_HARDWARE_CLOCKS_H */
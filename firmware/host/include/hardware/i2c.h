@@ -0,0 +1,40 @@
+/**
+ * @file i2c.h
+ * @brief Host stand-in for hardware/i2c.h
+ * 
+ * Blocking master transfers are routed to simulated devices attached
+ * with hal_sim_i2c_attach(); unattached addresses NAK.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct i2c_inst i2c_inst_t;
+
+extern i2c_inst_t *const i2c0;
+extern i2c_inst_t *const i2c1;
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t *i2c);
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+void i2c_set_slave_mode(i2c_inst_t *i2c, bool slave, uint8_t addr);
+uint i2c_hw_index(i2c_inst_t *i2c);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src,
+                       size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst,
+                      size_t len, bool nostop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_HARDWARE_I2C_H */
@@ -0,0 +1,85 @@
+/**
+ * @file sync.h
+ * @brief Host stand-in for hardware/sync.h
+ * 
+ * Interrupt masking is a no-op on the host; the simulated "interrupts"
+ * run in the context of the thread that injects them. Hardware spinlocks
+ * are atomic flags, so they also exclude host threads from each other.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline uint32_t save_and_disable_interrupts(void)
+{
+    return 0;
+}
+
+static inline void restore_interrupts(uint32_t status)
+{
+    (void)status;
+}
+
+static inline void __dmb(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __mem_fence_acquire(void)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+static inline void __mem_fence_release(void)
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void __sev(void) {}
+static inline void __wfe(void) {}
+
+/* Hardware spinlocks */
+#define NUM_SPIN_LOCKS  32
+
+typedef volatile uint32_t spin_lock_t;
+
+extern spin_lock_t hal_sim_spin_locks[NUM_SPIN_LOCKS];
+
+static inline spin_lock_t *spin_lock_instance(uint lock_num)
+{
+    return &hal_sim_spin_locks[lock_num];
+}
+
+static inline uint32_t spin_lock_blocking(spin_lock_t *lock)
+{
+    uint32_t save = save_and_disable_interrupts();
+
+    while (__atomic_exchange_n(lock, 1u, __ATOMIC_ACQUIRE) != 0) {
+    }
+    return save;
+}
+
+static inline void spin_unlock(spin_lock_t *lock, uint32_t saved_irq)
+{
+    __atomic_store_n(lock, 0u, __ATOMIC_RELEASE);
+    restore_interrupts(saved_irq);
+}
+
+spin_lock_t *spin_lock_init(uint lock_num);
+int spin_lock_claim_unused(bool required);
+void spin_lock_unclaim(uint lock_num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_HARDWARE_SYNC_H */
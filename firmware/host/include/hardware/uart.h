@@ -0,0 +1,39 @@
+/**
+ * @file uart.h
+ * @brief Host stand-in for hardware/uart.h
+ * 
+ * Simulated UART: transmitted bytes go to stdout, received bytes come
+ * from hal_sim_uart_inject().
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HOST_HARDWARE_UART_H
+#define HOST_HARDWARE_UART_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct uart_inst uart_inst_t;
+
+extern uart_inst_t *const uart0;
+extern uart_inst_t *const uart1;
+
+uint uart_init(uart_inst_t *uart, uint baudrate);
+void uart_deinit(uart_inst_t *uart);
+void uart_putc_raw(uart_inst_t *uart, char c);
+void uart_putc(uart_inst_t *uart, char c);
+void uart_puts(uart_inst_t *uart, const char *s);
+void uart_write_blocking(uart_inst_t *uart, const uint8_t *src, size_t len);
+bool uart_is_readable(uart_inst_t *uart);
+char uart_getc(uart_inst_t *uart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_HARDWARE_UART_H */
@@ -0,0 +1,39 @@
+/**
+ * @file watchdog.h
+ * @brief Host stand-in for hardware/watchdog.h
+ * 
+ * The simulated watchdog never resets the process; it records feeds so
+ * that hal_sim_watchdog_expired() can report a missed deadline.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HOST_HARDWARE_WATCHDOG_H
+#define HOST_HARDWARE_WATCHDOG_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Scratch registers only; they are zero at start like after a power-on reset */
+typedef struct {
+    volatile uint32_t scratch[8];
+} watchdog_hw_t;
+
+extern watchdog_hw_t hal_sim_watchdog_regs;
+#define watchdog_hw (&hal_sim_watchdog_regs)
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug);
+void watchdog_update(void);
+bool watchdog_caused_reboot(void);
+bool watchdog_enable_caused_reboot(void);
+uint32_t watchdog_get_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_HARDWARE_WATCHDOG_H */
@@ -0,0 +1,52 @@
+/**
+ * @file pico.h
+ * @brief Host stand-in for the Pico SDK base header
+ * 
+ * Provides the basic types and attribute macros of the Pico SDK so that
+ * the firmware sources compile unchanged in the host (Linux) build.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HOST_PICO_H
+#define HOST_PICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned int uint;
+
+#define PICO_DEFAULT_LED_PIN        25
+#define NUM_BANK0_GPIOS             30
+
+#define PICO_OK                     0
+#define PICO_ERROR_GENERIC          (-1)
+#define PICO_ERROR_TIMEOUT          (-2)
+
+/* Memory placement attributes have no meaning on the host */
+#define __not_in_flash_func(func)   func
+#define __time_critical_func(func)  func
+#define __uninitialized_ram(name)   name
+
+/**
+ * @brief Get the number of the core the caller is running on
+ * @return Core number (always 0: the host kernel is single-core)
+ */
+uint get_core_num(void);
+
+/**
+ * @brief Hint for busy-wait loops (no-op on the host)
+ */
+static inline void tight_loop_contents(void) {}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_PICO_H */
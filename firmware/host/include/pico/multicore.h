@@ -0,0 +1,18 @@
+/**
+ * @file multicore.h
+ * @brief Host stand-in for pico/multicore.h
+ * 
+ * Core management is owned by the FreeRTOS POSIX port on the host, so
+ * this header only provides what the firmware includes it for.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HOST_PICO_MULTICORE_H
+#define HOST_PICO_MULTICORE_H
+
+#include "pico.h"
+#include "hardware/sync.h"
+
+#endif /* HOST_PICO_MULTICORE_H */
@@ -0,0 +1,34 @@
+/**
+ * @file stdlib.h
+ * @brief Host stand-in for pico/stdlib.h
+ * 
+ * Pulls in the simulated HAL headers the same way the Pico SDK standard
+ * library does, so that firmware sources need no host-specific includes.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include "pico.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/uart.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialise stdio (line-buffered stdout on the host)
+ * @return true
+ */
+bool stdio_init_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_PICO_STDLIB_H */
@@ -0,0 +1,41 @@
+/**
+ * @file time.h
+ * @brief Host stand-in for pico/time.h
+ * 
+ * The 1 MHz RP2040 timer is emulated with CLOCK_MONOTONIC, measured from
+ * the first call into the simulated HAL.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HOST_PICO_TIME_H
+#define HOST_PICO_TIME_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void busy_wait_us(uint64_t us);
+void busy_wait_us_32(uint32_t us);
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t)
+{
+    return (uint32_t)(t / 1000u);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_PICO_TIME_H */
@@ -0,0 +1,68 @@
+/**
+ * @file sim_adc.c
+ * @brief Simulated ADC for the host build
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "hardware/adc.h"
+#include "hal_sim.h"
+
+static volatile uint16_t usChannelValue[ADC_CHANNEL_COUNT];
+static uint uxSelectedInput;
+static uint uxRoundRobinMask;
+
+void adc_init(void)
+{
+    uxSelectedInput = 0;
+    uxRoundRobinMask = 0;
+}
+
+void adc_gpio_init(uint gpio)
+{
+    (void)gpio;
+}
+
+void adc_select_input(uint input)
+{
+    if (input < ADC_CHANNEL_COUNT) {
+        uxSelectedInput = input;
+    }
+}
+
+uint adc_get_selected_input(void)
+{
+    return uxSelectedInput;
+}
+
+void adc_set_round_robin(uint input_mask)
+{
+    uxRoundRobinMask = input_mask & ((1u << ADC_CHANNEL_COUNT) - 1u);
+}
+
+void adc_set_temp_sensor_enabled(bool enable)
+{
+    (void)enable;
+}
+
+uint16_t adc_read(void)
+{
+    uint16_t usValue = usChannelValue[uxSelectedInput];
+
+    /* Advance to the next enabled channel, as the hardware does */
+    if (uxRoundRobinMask != 0) {
+        do {
+            uxSelectedInput = (uxSelectedInput + 1u) % ADC_CHANNEL_COUNT;
+        } while ((uxRoundRobinMask & (1u << uxSelectedInput)) == 0);
+    }
+
+    return usValue;
+}
+
+void hal_sim_adc_set_value(uint channel, uint16_t value)
+{
+    if (channel < ADC_CHANNEL_COUNT) {
+        usChannelValue[channel] = value & 0x0FFFu;
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file sim_adc_stream.c
+ * @brief Simulated HAL: ADC stream sampler
+ * 
+ * Stands in for the ADC DMA back end. A high-priority task fills the two
+ * block buffers alternately with round-robin adc_read() values, once per
+ * block period, and reports each block as the DMA interrupt would.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "adc_stream.h"
+
+static TaskHandle_t xSimSamplerTask = NULL;
+static uint16_t *pusSimBuffers[2];
+static uint32_t ulSimBlockSamples;
+static TickType_t xSimBlockTicks;
+
+static void prvSimSamplerTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint32_t ulBuffer = 0;
+
+    for (;;)
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+        vTaskDelayUntil(&xLastWakeTime, xSimBlockTicks);
+
+        for (uint32_t i = 0; i < ulSimBlockSamples; i++) {
+            pusSimBuffers[ulBuffer][i] = adc_read();
+        }
+        ulBuffer ^= 1u;
+
+        adc_stream_block_from_isr(&xHigherPriorityTaskWoken);
+        if (xHigherPriorityTaskWoken) {
+            taskYIELD();
+        }
+    }
+}
+
+bool adc_stream_hw_start(uint16_t *buffers[2], uint32_t block_samples,
+                         uint32_t channel_mask, uint32_t adc_rate_hz)
+{
+    uint32_t ulBlockMs = (block_samples * 1000u + adc_rate_hz - 1u) / adc_rate_hz;
+
+    pusSimBuffers[0] = buffers[0];
+    pusSimBuffers[1] = buffers[1];
+    ulSimBlockSamples = block_samples;
+    xSimBlockTicks = pdMS_TO_TICKS(ulBlockMs);
+    if (xSimBlockTicks == 0) {
+        xSimBlockTicks = 1;
+    }
+
+    adc_init();
+    adc_select_input(0);
+    adc_set_round_robin(channel_mask);
+
+    return xTaskCreate(prvSimSamplerTask, "SimADC", configMINIMAL_STACK_SIZE * 2,
+                       NULL, configMAX_PRIORITIES - 1, &xSimSamplerTask) == pdPASS;
+}
+
+void adc_stream_hw_stop(void)
+{
+    if (xSimSamplerTask != NULL) {
+        vTaskDelete(xSimSamplerTask);
+        xSimSamplerTask = NULL;
+    }
+    adc_set_round_robin(0);
+}
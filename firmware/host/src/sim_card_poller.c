@@ -0,0 +1,172 @@
+/**
+ * @file sim_card_poller.c
+ * @brief Simulated HAL: card poller I2C1 master
+ *
+ * Stands in for the DMA engine. A high-priority task runs each
+ * transaction against the devices attached to simulated bus 1 (see
+ * hal_sim_zone_cards_attach()), holds it for the time the bytes would
+ * take on the wire at the configured clock, and reports it as the stop
+ * interrupt would; the report starts the next card, which the same task
+ * picks up at once. On the single-core host kernel the poller checks
+ * frames only between transactions. The attention line is
+ * simulated GPIO input, driven by the simulated zone cards.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/gpio.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "card_poller.h"
+#include "board_pins.h"
+
+#define SIM_I2C_BITS_PER_BYTE   9u      /* Eight data bits and the acknowledge */
+#define SIM_I2C_FRAMING_BITS    2u      /* Start and stop */
+
+static TaskHandle_t xSimMasterTask = NULL;
+static uint32_t ulSimBaudrate;
+
+/* Transaction handed over by card_poller_hw_begin(), under the kernel
+ * critical section; an abort bumps the generation so a transaction
+ * already on the bus is not reported */
+static volatile bool xSimPending;
+static volatile uint32_t ulSimGeneration;
+static uint8_t ucSimAddress;
+static uint8_t *pucSimFrame;
+static uint32_t ulSimLength;
+static bool xSimSetOffset;
+
+/**
+ * @brief Wire time of a transaction
+ */
+static uint32_t prvBusTimeUs(uint32_t ulBytes, bool xSetOffset)
+{
+    /* An offset write adds a repeated start */
+    uint64_t ullBits = ((uint64_t)ulBytes * SIM_I2C_BITS_PER_BYTE) + SIM_I2C_FRAMING_BITS +
+                       (xSetOffset ? 1u : 0u);
+
+    return (uint32_t)((ullBits * 1000000u) / ulSimBaudrate);
+}
+
+/**
+ * @brief Run one transaction on the simulated bus
+ * @return true if the card acknowledged
+ */
+static bool prvTransfer(uint8_t ucAddress, uint8_t *pucFrame, uint32_t ulLength, bool xSetOffset)
+{
+    const uint8_t ucOffset = 0;
+    uint64_t ullStart = time_us_64();
+    uint32_t ulBusUs;
+    uint32_t ulSpentUs;
+    bool xAcked;
+
+    /* A NAK ends the transaction after the address byte */
+    xAcked = (!xSetOffset || (i2c_write_blocking(i2c1, ucAddress, &ucOffset, 1, true) == 1)) &&
+             (i2c_read_blocking(i2c1, ucAddress, pucFrame, ulLength, false) == (int)ulLength);
+    ulBusUs = prvBusTimeUs(!xAcked ? 1u : xSetOffset ? (ulLength + 3u) : (ulLength + 1u),
+                           xSetOffset);
+
+    ulSpentUs = (uint32_t)(time_us_64() - ullStart);
+    if (ulSpentUs < ulBusUs) {
+        busy_wait_us(ulBusUs - ulSpentUs);
+    }
+    return xAcked;
+}
+
+/**
+ * @brief Attention line falling edge (runs in the context driving the line)
+ */
+static void prvAttentionIrqHandler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (gpio_get_irq_event_mask(BOARD_PIN_EXPANSION_IN) & GPIO_IRQ_EDGE_FALL) {
+        gpio_acknowledge_irq(BOARD_PIN_EXPANSION_IN, GPIO_IRQ_EDGE_FALL);
+        taskENTER_CRITICAL();
+        card_poller_attention_from_isr(&xHigherPriorityTaskWoken);
+        taskEXIT_CRITICAL();
+    }
+}
+
+static void prvSimMasterTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        /* Reporting a transaction hands over the next one */
+        for (;;) {
+            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+            uint8_t ucAddress;
+            uint8_t *pucFrame;
+            uint32_t ulLength;
+            bool xSetOffset;
+            uint32_t ulGeneration;
+            bool xAcked;
+
+            taskENTER_CRITICAL();
+            if (!xSimPending) {
+                taskEXIT_CRITICAL();
+                break;
+            }
+            xSimPending = false;
+            ucAddress = ucSimAddress;
+            pucFrame = pucSimFrame;
+            ulLength = ulSimLength;
+            xSetOffset = xSimSetOffset;
+            ulGeneration = ulSimGeneration;
+            taskEXIT_CRITICAL();
+
+            xAcked = prvTransfer(ucAddress, pucFrame, ulLength, xSetOffset);
+
+            taskENTER_CRITICAL();
+            if (ulGeneration == ulSimGeneration) {
+                card_poller_done_from_isr(xAcked, &xHigherPriorityTaskWoken);
+            }
+            taskEXIT_CRITICAL();
+        }
+    }
+}
+
+void card_poller_hw_begin(uint8_t address, uint8_t *frame, uint32_t length, bool set_offset)
+{
+    ucSimAddress = address;
+    pucSimFrame = frame;
+    ulSimLength = length;
+    xSimSetOffset = set_offset;
+    xSimPending = true;
+    xTaskNotifyGive(xSimMasterTask);
+}
+
+void card_poller_hw_abort(void)
+{
+    xSimPending = false;
+    ulSimGeneration++;
+}
+
+bool card_poller_hw_attention(void)
+{
+    return !gpio_get(BOARD_PIN_EXPANSION_IN);
+}
+
+bool card_poller_hw_init(uint32_t baudrate)
+{
+    ulSimBaudrate = (baudrate != 0u) ? baudrate : CARD_POLLER_BAUDRATE;
+    i2c_init(i2c1, ulSimBaudrate);
+
+    gpio_init(BOARD_PIN_EXPANSION_IN);
+    gpio_pull_up(BOARD_PIN_EXPANSION_IN);
+    gpio_add_raw_irq_handler(BOARD_PIN_EXPANSION_IN, prvAttentionIrqHandler);
+    gpio_set_irq_enabled(BOARD_PIN_EXPANSION_IN, GPIO_IRQ_EDGE_FALL, true);
+
+    if (xSimMasterTask != NULL) {
+        return true;
+    }
+    return xTaskCreate(prvSimMasterTask, "SimI2CM", configMINIMAL_STACK_SIZE * 2,
+                       NULL, configMAX_PRIORITIES - 1, &xSimMasterTask) == pdPASS;
+}
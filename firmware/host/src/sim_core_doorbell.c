@@ -0,0 +1,28 @@
+/**
+ * @file sim_core_doorbell.c
+ * @brief Simulated HAL: cross-core doorbell
+ *
+ * Like the other simulated interrupts, the doorbell handler runs in the
+ * context of the thread that rings it.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stddef.h>
+#include "core_doorbell.h"
+
+bool core_doorbell_init(core_doorbell_t *bell, core_doorbell_handler_t handler, void *context)
+{
+    bell->alarm = 0;
+    bell->handler = handler;
+    bell->context = context;
+    return true;
+}
+
+void core_doorbell_ring(core_doorbell_t *bell)
+{
+    if (bell->handler != NULL) {
+        bell->handler(bell->context);
+    }
+}
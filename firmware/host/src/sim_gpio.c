@@ -0,0 +1,198 @@
+/**
+ * @file sim_gpio.c
+ * @brief Simulated GPIO bank for the host build
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "hardware/gpio.h"
+#include "hal_sim.h"
+
+/* Simulated pad state, one bit per GPIO */
+static volatile uint32_t ulOutputLatch;
+static volatile uint32_t ulOutputEnable;
+static volatile uint32_t ulInputLevel;
+static volatile uint32_t ulPullUp;
+
+/* Edge interrupt enables and pending events, one event mask per GPIO */
+static uint32_t ulIrqEnabled[NUM_BANK0_GPIOS];
+static uint32_t ulIrqPending[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t pxIrqCallback;
+static irq_handler_t pxRawHandlers[NUM_BANK0_GPIOS];
+
+static inline uint32_t prvBit(uint gpio)
+{
+    return (gpio < NUM_BANK0_GPIOS) ? (1u << gpio) : 0u;
+}
+
+void gpio_init(uint gpio)
+{
+    ulOutputEnable &= ~prvBit(gpio);
+    ulOutputLatch &= ~prvBit(gpio);
+}
+
+void gpio_init_mask(uint32_t gpio_mask)
+{
+    ulOutputEnable &= ~gpio_mask;
+    ulOutputLatch &= ~gpio_mask;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    if (out) {
+        ulOutputEnable |= prvBit(gpio);
+    } else {
+        ulOutputEnable &= ~prvBit(gpio);
+    }
+}
+
+void gpio_set_dir_out_masked(uint32_t mask)
+{
+    ulOutputEnable |= mask;
+}
+
+void gpio_set_dir_in_masked(uint32_t mask)
+{
+    ulOutputEnable &= ~mask;
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    if (value) {
+        ulOutputLatch |= prvBit(gpio);
+    } else {
+        ulOutputLatch &= ~prvBit(gpio);
+    }
+}
+
+void gpio_set_mask(uint32_t mask)
+{
+    ulOutputLatch |= mask;
+}
+
+void gpio_clr_mask(uint32_t mask)
+{
+    ulOutputLatch &= ~mask;
+}
+
+void gpio_put_masked(uint32_t mask, uint32_t value)
+{
+    ulOutputLatch = (ulOutputLatch & ~mask) | (value & mask);
+}
+
+uint32_t gpio_get_all(void)
+{
+    return (ulOutputLatch & ulOutputEnable) | (ulInputLevel & ~ulOutputEnable);
+}
+
+bool gpio_get(uint gpio)
+{
+    return (gpio_get_all() & prvBit(gpio)) != 0;
+}
+
+void gpio_pull_up(uint gpio)
+{
+    ulPullUp |= prvBit(gpio);
+    ulInputLevel |= prvBit(gpio);
+}
+
+void gpio_pull_down(uint gpio)
+{
+    ulPullUp &= ~prvBit(gpio);
+    ulInputLevel &= ~prvBit(gpio);
+}
+
+void gpio_disable_pulls(uint gpio)
+{
+    ulPullUp &= ~prvBit(gpio);
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled)
+{
+    if (gpio >= NUM_BANK0_GPIOS) {
+        return;
+    }
+    if (enabled) {
+        ulIrqEnabled[gpio] |= event_mask;
+    } else {
+        ulIrqEnabled[gpio] &= ~event_mask;
+    }
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask,
+                                        bool enabled,
+                                        gpio_irq_callback_t callback)
+{
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+    if (enabled) {
+        pxIrqCallback = callback;
+    }
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask)
+{
+    if (gpio < NUM_BANK0_GPIOS) {
+        ulIrqPending[gpio] &= ~event_mask;
+    }
+}
+
+uint32_t gpio_get_irq_event_mask(uint gpio)
+{
+    return (gpio < NUM_BANK0_GPIOS) ? ulIrqPending[gpio] : 0u;
+}
+
+void gpio_add_raw_irq_handler(uint gpio, irq_handler_t handler)
+{
+    if (gpio < NUM_BANK0_GPIOS) {
+        pxRawHandlers[gpio] = handler;
+    }
+}
+
+void hal_sim_gpio_set_input(uint gpio, bool level)
+{
+    uint32_t ulBit = prvBit(gpio);
+    bool xOld = (ulInputLevel & ulBit) != 0;
+    uint32_t ulEvents;
+
+    if (ulBit == 0) {
+        return;
+    }
+
+    if (level) {
+        ulInputLevel |= ulBit;
+    } else {
+        ulInputLevel &= ~ulBit;
+    }
+
+    if (xOld == level) {
+        return;
+    }
+
+    ulEvents = ulIrqEnabled[gpio] & (level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL);
+    if (ulEvents == 0) {
+        return;
+    }
+
+    /* A raw handler sees the event first; the callback gets what it leaves */
+    ulIrqPending[gpio] |= ulEvents;
+    if (pxRawHandlers[gpio] != NULL) {
+        pxRawHandlers[gpio]();
+    }
+    ulEvents = ulIrqPending[gpio];
+    ulIrqPending[gpio] = 0;
+    if ((ulEvents != 0) && (pxIrqCallback != NULL)) {
+        pxIrqCallback(gpio, ulEvents);
+    }
+}
+
+bool hal_sim_gpio_get_output(uint gpio)
+{
+    return (ulOutputLatch & prvBit(gpio)) != 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file sim_i2c.c
+ * @brief Simulated I2C controllers for the host build
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "hardware/i2c.h"
+#include "hal_sim.h"
+
+#define SIM_I2C_ADDR_COUNT  128
+
+struct i2c_inst {
+    uint index;
+    uint baudrate;
+    bool slave;
+    uint8_t slave_addr;
+    hal_sim_i2c_device_t devices[SIM_I2C_ADDR_COUNT];
+};
+
+static struct i2c_inst xI2CInstances[2] = {
+    { .index = 0 },
+    { .index = 1 },
+};
+
+i2c_inst_t *const i2c0 = &xI2CInstances[0];
+i2c_inst_t *const i2c1 = &xI2CInstances[1];
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+    i2c->slave = false;
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+void i2c_deinit(i2c_inst_t *i2c)
+{
+    i2c->baudrate = 0;
+}
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate)
+{
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+void i2c_set_slave_mode(i2c_inst_t *i2c, bool slave, uint8_t addr)
+{
+    i2c->slave = slave;
+    i2c->slave_addr = addr;
+}
+
+uint i2c_hw_index(i2c_inst_t *i2c)
+{
+    return i2c->index;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src,
+                       size_t len, bool nostop)
+{
+    const hal_sim_i2c_device_t *pxDevice;
+
+    if (addr >= SIM_I2C_ADDR_COUNT) {
+        return PICO_ERROR_GENERIC;
+    }
+    pxDevice = &i2c->devices[addr];
+    if (pxDevice->write == NULL) {
+        return PICO_ERROR_GENERIC;
+    }
+    return pxDevice->write(pxDevice->ctx, src, len, nostop);
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst,
+                      size_t len, bool nostop)
+{
+    const hal_sim_i2c_device_t *pxDevice;
+
+    if (addr >= SIM_I2C_ADDR_COUNT) {
+        return PICO_ERROR_GENERIC;
+    }
+    pxDevice = &i2c->devices[addr];
+    if (pxDevice->read == NULL) {
+        return PICO_ERROR_GENERIC;
+    }
+    return pxDevice->read(pxDevice->ctx, dst, len, nostop);
+}
+
+bool hal_sim_i2c_attach(uint bus_index, uint8_t addr,
+                        const hal_sim_i2c_device_t *device)
+{
+    hal_sim_i2c_device_t *pxSlot;
+
+    if ((bus_index > 1) || (addr >= SIM_I2C_ADDR_COUNT)) {
+        return false;
+    }
+
+    pxSlot = &xI2CInstances[bus_index].devices[addr];
+    if (device != NULL) {
+        *pxSlot = *device;
+    } else {
+        pxSlot->write = NULL;
+        pxSlot->read = NULL;
+        pxSlot->ctx = NULL;
+    }
+    return true;
+}
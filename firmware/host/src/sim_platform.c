@@ -0,0 +1,107 @@
+/**
+ * @file sim_platform.c
+ * @brief Simulated time, clocks and stdio for the host build
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+
+static uint64_t prvMonotonicUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000u) + ((uint64_t)ts.tv_nsec / 1000u);
+}
+
+/**
+ * @brief Microseconds since the first call, like the RP2040 timer since boot
+ */
+uint64_t time_us_64(void)
+{
+    static uint64_t ullEpoch;
+
+    if (ullEpoch == 0) {
+        ullEpoch = prvMonotonicUs();
+    }
+    return prvMonotonicUs() - ullEpoch;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)time_us_64();
+}
+
+absolute_time_t get_absolute_time(void)
+{
+    return time_us_64();
+}
+
+void busy_wait_us(uint64_t us)
+{
+    uint64_t ullEnd = time_us_64() + us;
+
+    while (time_us_64() < ullEnd) {
+        tight_loop_contents();
+    }
+}
+
+void busy_wait_us_32(uint32_t us)
+{
+    busy_wait_us(us);
+}
+
+void sleep_us(uint64_t us)
+{
+    struct timespec ts = {
+        .tv_sec = (time_t)(us / 1000000u),
+        .tv_nsec = (long)((us % 1000000u) * 1000u),
+    };
+
+    /* The POSIX port delivers its tick as a signal, so resume on EINTR */
+    while (nanosleep(&ts, &ts) != 0) {
+    }
+}
+
+void sleep_ms(uint32_t ms)
+{
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+bool stdio_init_all(void)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+uint get_core_num(void)
+{
+#if FACP_HOST_CORES > 1
+    return (uint)portGET_CORE_ID();
+#else
+    return 0;
+#endif
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    switch (clk_index) {
+        case clk_sys:
+        case clk_peri:
+            return 125000000u;
+        case clk_usb:
+        case clk_adc:
+            return 48000000u;
+        case clk_ref:
+        case clk_rtc:
+            return 12000000u;
+        default:
+            return 0;
+    }
+}
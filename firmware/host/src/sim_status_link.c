@@ -0,0 +1,70 @@
+/**
+ * @file sim_status_link.c
+ * @brief Simulated HAL: status link I2C1 slave
+ *
+ * Attaches the zone card to simulated I2C bus 1, so host code can poll
+ * it with i2c_write_blocking()/i2c_read_blocking() as the building
+ * controller would. Each transfer runs the same interrupt-side calls as
+ * the DMA engine, in the caller's context. The attention line is the
+ * simulated GPIO output, driven open drain as on the card.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "hardware/i2c.h"
+#include "hardware/gpio.h"
+#include "hal_sim.h"
+#include "status_link.h"
+
+static int prvWrite(void *ctx, const uint8_t *src, size_t len, bool nostop)
+{
+    (void)ctx;
+
+    if (len > 0) {
+        status_link_set_offset_from_isr(src[0]);
+    }
+    if (!nostop) {
+        status_link_end_from_isr();
+    }
+    return (int)len;
+}
+
+static int prvRead(void *ctx, uint8_t *dst, size_t len, bool nostop)
+{
+    const uint16_t *pusWords;
+    uint32_t ulWords;
+    size_t i = 0;
+
+    (void)ctx;
+
+    pusWords = status_link_begin_read_from_isr(&ulWords);
+    for (; (i < len) && (i < ulWords); i++) {
+        dst[i] = (uint8_t)pusWords[i];
+    }
+    for (; i < len; i++) {
+        dst[i] = STATUS_LINK_FILL_BYTE;
+    }
+
+    if (!nostop) {
+        status_link_end_from_isr();
+    }
+    return (int)len;
+}
+
+bool status_link_hw_start(uint8_t address)
+{
+    const hal_sim_i2c_device_t xDevice = {
+        .write = prvWrite,
+        .read = prvRead,
+        .ctx = NULL,
+    };
+
+    gpio_init(BOARD_PIN_EXPANSION_OUT);
+    return hal_sim_i2c_attach(1, address, &xDevice);
+}
+
+void status_link_hw_set_attention(bool asserted)
+{
+    gpio_set_dir(BOARD_PIN_EXPANSION_OUT, asserted);
+}
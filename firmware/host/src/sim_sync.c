@@ -0,0 +1,48 @@
+/**
+ * @file sim_sync.c
+ * @brief Simulated hardware spinlocks for the host build
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "hardware/sync.h"
+
+/* The SDK reserves the lower locks; claims start at the same index */
+#define SIM_SPIN_LOCK_CLAIM_FIRST   24u
+
+spin_lock_t hal_sim_spin_locks[NUM_SPIN_LOCKS];
+
+static uint32_t ulClaimedLocks;
+
+spin_lock_t *spin_lock_init(uint lock_num)
+{
+    spin_lock_t *pxLock = spin_lock_instance(lock_num);
+
+    __atomic_store_n(pxLock, 0u, __ATOMIC_RELEASE);
+    return pxLock;
+}
+
+int spin_lock_claim_unused(bool required)
+{
+    for (uint lock_num = SIM_SPIN_LOCK_CLAIM_FIRST; lock_num < NUM_SPIN_LOCKS; lock_num++) {
+        uint32_t ulBit = 1u << lock_num;
+
+        if ((__atomic_fetch_or(&ulClaimedLocks, ulBit, __ATOMIC_ACQ_REL) & ulBit) == 0) {
+            return (int)lock_num;
+        }
+    }
+
+    if (required) {
+        fprintf(stderr, "No spinlocks are available\n");
+        abort();
+    }
+    return -1;
+}
+
+void spin_lock_unclaim(uint lock_num)
+{
+    __atomic_fetch_and(&ulClaimedLocks, ~(1u << lock_num), __ATOMIC_ACQ_REL);
+}
@@ -0,0 +1,105 @@
+/**
+ * @file sim_uart.c
+ * @brief Simulated UARTs for the host build
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include "hardware/uart.h"
+#include "hal_sim.h"
+
+#define SIM_UART_RX_SIZE    256
+
+struct uart_inst {
+    uint index;
+    uint baudrate;
+    uint8_t rx[SIM_UART_RX_SIZE];
+    volatile size_t rx_head;
+    volatile size_t rx_tail;
+};
+
+static struct uart_inst xUartInstances[2] = {
+    { .index = 0 },
+    { .index = 1 },
+};
+
+uart_inst_t *const uart0 = &xUartInstances[0];
+uart_inst_t *const uart1 = &xUartInstances[1];
+
+uint uart_init(uart_inst_t *uart, uint baudrate)
+{
+    uart->baudrate = baudrate;
+    uart->rx_head = 0;
+    uart->rx_tail = 0;
+    return baudrate;
+}
+
+void uart_deinit(uart_inst_t *uart)
+{
+    uart->baudrate = 0;
+}
+
+void uart_putc_raw(uart_inst_t *uart, char c)
+{
+    (void)uart;
+    fputc(c, stdout);
+}
+
+void uart_putc(uart_inst_t *uart, char c)
+{
+    uart_putc_raw(uart, c);
+}
+
+void uart_puts(uart_inst_t *uart, const char *s)
+{
+    while (*s != '\0') {
+        uart_putc(uart, *s++);
+    }
+}
+
+void uart_write_blocking(uart_inst_t *uart, const uint8_t *src, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        uart_putc_raw(uart, (char)src[i]);
+    }
+}
+
+bool uart_is_readable(uart_inst_t *uart)
+{
+    return uart->rx_head != uart->rx_tail;
+}
+
+char uart_getc(uart_inst_t *uart)
+{
+    char c;
+
+    while (!uart_is_readable(uart)) {
+        tight_loop_contents();
+    }
+    c = (char)uart->rx[uart->rx_tail];
+    uart->rx_tail = (uart->rx_tail + 1u) % SIM_UART_RX_SIZE;
+    return c;
+}
+
+size_t hal_sim_uart_inject(uint uart_index, const uint8_t *data, size_t len)
+{
+    struct uart_inst *pxUart;
+    size_t xQueued = 0;
+
+    if (uart_index > 1) {
+        return 0;
+    }
+
+    pxUart = &xUartInstances[uart_index];
+    while (xQueued < len) {
+        size_t xNext = (pxUart->rx_head + 1u) % SIM_UART_RX_SIZE;
+        if (xNext == pxUart->rx_tail) {
+            break;
+        }
+        pxUart->rx[pxUart->rx_head] = data[xQueued++];
+        pxUart->rx_head = xNext;
+    }
+    return xQueued;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file sim_watchdog.c
+ * @brief Simulated watchdog for the host build
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "pico/time.h"
+#include "hardware/watchdog.h"
+#include "hal_sim.h"
+
+watchdog_hw_t hal_sim_watchdog_regs;
+
+static uint32_t ulTimeoutMs;
+static volatile uint64_t ullLastFeedUs;
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug)
+{
+    (void)pause_on_debug;
+
+    ulTimeoutMs = delay_ms;
+    watchdog_update();
+}
+
+void watchdog_update(void)
+{
+    ullLastFeedUs = time_us_64();
+}
+
+bool watchdog_caused_reboot(void)
+{
+    return false;
+}
+
+bool watchdog_enable_caused_reboot(void)
+{
+    return false;
+}
+
+uint32_t watchdog_get_count(void)
+{
+    uint64_t ullElapsedUs = time_us_64() - ullLastFeedUs;
+    uint64_t ullTimeoutUs = (uint64_t)ulTimeoutMs * 1000u;
+
+    return (ullElapsedUs < ullTimeoutUs) ? (uint32_t)(ullTimeoutUs - ullElapsedUs) : 0;
+}
+
+bool hal_sim_watchdog_expired(void)
+{
+    return (ulTimeoutMs != 0) && (watchdog_get_count() == 0);
+}
@@ -0,0 +1,240 @@
+/**
+ * @file sim_zone_cards.c
+ * @brief Simulated HAL: zone cards on an I2C bus
+ *
+ * Each card is a status_link.h register map: a one-byte write sets the
+ * offset, a read returns the frame from there and 0xFF past its end.
+ * NAKs are drawn per transaction (offset write, or a read without one)
+ * from a seeded xorshift sequence, so a benchmark run is repeatable. The
+ * change counter steps with the zone masks and, as a forced refresh, on
+ * a read from register 0 once STATUS_LINK_FORCED_REFRESH_MS has passed.
+ * A zone change also asserts the card's attention output, released by
+ * the next read from register 0; the cards' outputs are wire-ORed onto
+ * the controller's BOARD_PIN_EXPANSION_IN. A chattering card changes
+ * again on every read from register 0, so it never releases the line.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/gpio.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hal_sim.h"
+#include "status_link.h"
+#include "crc.h"
+#include "system_init.h"
+
+#define SIM_CARDS_MAX       32u
+
+typedef struct {
+    status_link_frame_t frame;
+    uint8_t offset;
+    bool restarted;                 /* Read follows an offset write */
+    uint16_t sequence;
+    uint32_t change_ms;
+    uint32_t naks;
+    bool attention;
+    bool chatter;                   /* Changes on every read from register 0 */
+} sim_card_t;
+
+static sim_card_t xSimCards[SIM_CARDS_MAX];
+static uint32_t ulSimCardCount;
+static uint32_t ulNakPermille;
+static uint32_t ulRandom = 1u;
+static uint32_t ulAttentionCount;           /* Cards holding the line */
+
+static uint32_t prvRandom(void)
+{
+    ulRandom ^= ulRandom << 13;
+    ulRandom ^= ulRandom >> 17;
+    ulRandom ^= ulRandom << 5;
+    return ulRandom;
+}
+
+/**
+ * @brief Drive a card's attention output (critical section held)
+ *
+ * The controller's edge interrupt runs here when the line falls.
+ */
+static void prvSetAttention(sim_card_t *pxCard, bool xAsserted)
+{
+    if (pxCard->attention == xAsserted) {
+        return;
+    }
+    pxCard->attention = xAsserted;
+    if (xAsserted) {
+        if (ulAttentionCount++ == 0u) {
+            hal_sim_gpio_set_input(BOARD_PIN_EXPANSION_IN, false);
+        }
+    } else if (--ulAttentionCount == 0u) {
+        hal_sim_gpio_set_input(BOARD_PIN_EXPANSION_IN, true);
+    }
+}
+
+static bool prvDrawNak(sim_card_t *pxCard)
+{
+    if ((ulNakPermille != 0u) && ((prvRandom() % 1000u) < ulNakPermille)) {
+        pxCard->naks++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Publish a card's frame with new zone masks (critical section held)
+ */
+static void prvPublish(sim_card_t *pxCard, uint8_t ucAlarm, uint8_t ucFault)
+{
+    status_link_frame_t *pxFrame = &pxCard->frame;
+    uint8_t ucChange = pxFrame->change;
+
+    memset(pxFrame, 0, sizeof(*pxFrame));
+    pxFrame->change = (uint8_t)(ucChange + 1u);
+    pxFrame->version = STATUS_LINK_FRAME_VERSION;
+    pxFrame->length = (uint8_t)STATUS_LINK_FRAME_BYTES;
+    pxFrame->sequence = pxCard->sequence++;
+    pxFrame->uptime_ms = to_ms_since_boot(get_absolute_time());
+    pxCard->change_ms = pxFrame->uptime_ms;
+    pxFrame->system_status = (uint8_t)((ucAlarm != 0) ? SYSTEM_STATUS_ALARM :
+                                       (ucFault != 0) ? SYSTEM_STATUS_FAULT :
+                                                        SYSTEM_STATUS_NORMAL);
+    pxFrame->zone_count = 2;
+    pxFrame->alarm = ucAlarm;
+    pxFrame->fault = ucFault;
+    pxFrame->outputs = ucAlarm;
+    pxFrame->crc = crc16_ccitt(pxFrame, STATUS_LINK_FRAME_BYTES - sizeof(pxFrame->crc));
+}
+
+static int prvWrite(void *ctx, const uint8_t *src, size_t len, bool nostop)
+{
+    sim_card_t *pxCard = (sim_card_t *)ctx;
+    int lResult = (int)len;
+
+    taskENTER_CRITICAL();
+    pxCard->restarted = false;
+    if (prvDrawNak(pxCard)) {
+        lResult = PICO_ERROR_GENERIC;
+    } else if (len > 0) {
+        pxCard->offset = src[0];
+        pxCard->restarted = nostop;
+    }
+    taskEXIT_CRITICAL();
+    return lResult;
+}
+
+static int prvRead(void *ctx, uint8_t *dst, size_t len, bool nostop)
+{
+    sim_card_t *pxCard = (sim_card_t *)ctx;
+    const uint8_t *pucFrame = (const uint8_t *)&pxCard->frame;
+    bool xRestarted;
+
+    (void)nostop;
+
+    taskENTER_CRITICAL();
+    xRestarted = pxCard->restarted;
+    pxCard->restarted = false;
+    if (!xRestarted && prvDrawNak(pxCard)) {
+        taskEXIT_CRITICAL();
+        return PICO_ERROR_GENERIC;
+    }
+    if ((pxCard->offset == 0u) &&
+        ((to_ms_since_boot(get_absolute_time()) - pxCard->change_ms) >= STATUS_LINK_FORCED_REFRESH_MS)) {
+        prvPublish(pxCard, pxCard->frame.alarm, pxCard->frame.fault);
+    }
+    if (pxCard->offset == 0u) {
+        if (pxCard->chatter) {
+            prvPublish(pxCard, pxCard->frame.alarm, (uint8_t)(pxCard->frame.fault ^ 0x01u));
+        } else {
+            prvSetAttention(pxCard, false);
+        }
+    }
+    for (size_t i = 0; i < len; i++) {
+        size_t xPos = (size_t)pxCard->offset + i;
+
+        dst[i] = (xPos < STATUS_LINK_FRAME_BYTES) ? pucFrame[xPos] : STATUS_LINK_FILL_BYTE;
+    }
+    taskEXIT_CRITICAL();
+    return (int)len;
+}
+
+uint32_t hal_sim_zone_cards_attach(uint bus_index, uint8_t first_addr, uint32_t count)
+{
+    hal_sim_i2c_device_t xDevice = {
+        .write = prvWrite,
+        .read = prvRead,
+    };
+    uint32_t ulAttached = 0;
+
+    if (count > SIM_CARDS_MAX) {
+        count = SIM_CARDS_MAX;
+    }
+
+    taskENTER_CRITICAL();
+    ulAttentionCount = 0;
+    hal_sim_gpio_set_input(BOARD_PIN_EXPANSION_IN, true);
+    taskEXIT_CRITICAL();
+
+    for (uint32_t i = 0; i < count; i++) {
+        sim_card_t *pxCard = &xSimCards[i];
+
+        taskENTER_CRITICAL();
+        memset(pxCard, 0, sizeof(*pxCard));
+        prvPublish(pxCard, 0, 0);
+        taskEXIT_CRITICAL();
+
+        xDevice.ctx = pxCard;
+        if (!hal_sim_i2c_attach(bus_index, (uint8_t)(first_addr + i), &xDevice)) {
+            break;
+        }
+        ulAttached++;
+    }
+    ulSimCardCount = ulAttached;
+    return ulAttached;
+}
+
+void hal_sim_zone_cards_set_nak_rate(uint32_t nak_permille, uint32_t seed)
+{
+    taskENTER_CRITICAL();
+    ulNakPermille = nak_permille;
+    ulRandom = (seed != 0u) ? seed : 1u;
+    taskEXIT_CRITICAL();
+}
+
+void hal_sim_zone_cards_set_zones(uint32_t card, uint8_t alarm, uint8_t fault)
+{
+    if (card >= ulSimCardCount) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    if ((alarm != xSimCards[card].frame.alarm) || (fault != xSimCards[card].frame.fault)) {
+        prvPublish(&xSimCards[card], alarm, fault);
+        prvSetAttention(&xSimCards[card], true);
+    }
+    taskEXIT_CRITICAL();
+}
+
+void hal_sim_zone_cards_set_chatter(uint32_t card, bool enabled)
+{
+    if (card >= ulSimCardCount) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    xSimCards[card].chatter = enabled;
+    if (enabled) {
+        prvPublish(&xSimCards[card], xSimCards[card].frame.alarm,
+                   (uint8_t)(xSimCards[card].frame.fault ^ 0x01u));
+        prvSetAttention(&xSimCards[card], true);
+    }
+    taskEXIT_CRITICAL();
+}
+
+uint32_t hal_sim_zone_cards_get_naks(uint32_t card)
+{
+    return (card < ulSimCardCount) ? xSimCards[card].naks : 0u;
+}
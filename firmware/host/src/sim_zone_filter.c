@@ -0,0 +1,29 @@
+/**
+ * @file sim_zone_filter.c
+ * @brief Simulated HAL: PIO zone filter
+ * 
+ * PIO is not simulated. zone_filter_start() reports the filter as
+ * unavailable so zone_input falls back to GPIO edge interrupts; the
+ * filter itself is exercised through zone_filter_model_step().
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "zone_filter.h"
+
+bool zone_filter_start(uint32_t sample_hz, uint32_t confirm_samples)
+{
+    (void)sample_hz;
+    (void)confirm_samples;
+    return false;
+}
+
+void zone_filter_stop(void)
+{
+}
+
+uint32_t zone_filter_get_event_count(void)
+{
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file adc_stream.h
+ * @brief Free-running ADC sampling of the analog sensor inputs
+ * 
+ * The ADC runs in round-robin mode over ADC0-ADC2 (GPIO26-28) and,
+ * optionally, the ADC4 temperature sensor. DMA streams the conversions
+ * into two alternating block buffers; each completed block sets a bit on
+ * the consumer task's notification value, and the consumer reduces the
+ * block to per-channel min, max, mean and threshold crossings.
+ * 
+ * If the consumer is still reading a block when the sampler wraps around
+ * to its buffer, that block is discarded and counted as dropped.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef ADC_STREAM_H
+#define ADC_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "zone_input.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Channels */
+#define ADC_STREAM_SENSOR_CHANNELS  3    /* ADC0-ADC2 */
+#define ADC_STREAM_TEMP_CHANNEL     4    /* On-chip temperature sensor */
+#define ADC_STREAM_MAX_CHANNELS     (ADC_STREAM_SENSOR_CHANNELS + 1)
+
+/* Samples per block buffer, including all channels and oversampling */
+#define ADC_STREAM_BLOCK_SAMPLES    512
+#define ADC_STREAM_MAX_OVERSAMPLE   16
+
+/* Default sampling parameters */
+#define ADC_STREAM_DEFAULT_RATE_HZ      1000  /* Frames per second, per channel */
+#define ADC_STREAM_DEFAULT_OVERSAMPLE   4
+
+/* Notification bit set on the consumer task for each completed block */
+#define ADC_STREAM_NOTIFY_BIT       (1UL << ZONE_INPUT_CHANNEL_COUNT)
+
+/* Per-channel block summary; values are 12-bit, after oversampling */
+typedef struct {
+    uint16_t min;
+    uint16_t max;
+    uint16_t mean;
+    uint16_t last;
+    uint16_t crossings;                 /* Threshold crossings in the block */
+    bool above;                         /* Above threshold at block end */
+} adc_channel_stats_t;
+
+/* Stream counters */
+typedef struct {
+    uint32_t blocks;                    /* Blocks completed by the sampler */
+    uint32_t processed;                 /* Blocks reduced by the consumer */
+    uint32_t dropped;                   /* Blocks lost to a late consumer */
+    uint32_t frames_per_block;
+    uint32_t block_period_us;
+} adc_stream_counters_t;
+
+/**
+ * @brief Start sampling
+ * @param xNotifyTask Task that receives ADC_STREAM_NOTIFY_BIT and calls
+ *                    adc_stream_process()
+ * @param sample_hz Frames per second, each frame one reading per channel
+ * @param oversample Conversions averaged per reading (power of two, 1-16)
+ * @param temp_sensor Include the ADC4 temperature sensor
+ * @return true if sampling started
+ */
+bool adc_stream_start(TaskHandle_t xNotifyTask, uint32_t sample_hz,
+                      uint32_t oversample, bool temp_sensor);
+
+/**
+ * @brief Stop sampling
+ */
+void adc_stream_stop(void);
+
+/**
+ * @brief Reduce the most recent complete block
+ * 
+ * Called by the notified task. Blocks completed since the previous call,
+ * other than the latest, are counted as dropped.
+ * 
+ * @return true if a block was reduced
+ */
+bool adc_stream_process(void);
+
+/**
+ * @brief Get the summary of a channel from the last reduced block
+ * @param channel Stream channel (0-2 for ADC0-ADC2, 3 for the temperature sensor)
+ * @param stats Receives the summary
+ * @return true if the channel is sampled and has data
+ */
+bool adc_stream_get_stats(uint32_t channel, adc_channel_stats_t *stats);
+
+/**
+ * @brief Get the stream counters
+ * @param counters Receives the counters
+ */
+void adc_stream_get_counters(adc_stream_counters_t *counters);
+
+/**
+ * @brief Reduce one block of interleaved, oversampled samples
+ * 
+ * Samples are laid out frame by frame; each frame holds oversample
+ * consecutive round-robin passes over the channels.
+ * 
+ * @param samples Block samples
+ * @param frames Frames in the block
+ * @param channels Channels per pass
+ * @param oversample_shift log2 of the oversampling factor
+ * @param thresholds Per-channel thresholds, 0 to skip crossing detection
+ * @param stats Per-channel summaries; the above flags carry the state
+ *              from the previous block
+ */
+void adc_stream_reduce(const uint16_t *samples, uint32_t frames,
+                       uint32_t channels, uint32_t oversample_shift,
+                       const uint16_t *thresholds, adc_channel_stats_t *stats);
+
+/* Sampler back end: DMA on the RP2040, a simulated sampler on the host */
+
+/**
+ * @brief Start filling the two block buffers alternately, buffer 0 first
+ * @param buffers Block buffers
+ * @param block_samples Samples per block
+ * @param channel_mask ADC round-robin input mask
+ * @param adc_rate_hz Conversions per second over all channels
+ * @return true if the sampler started
+ */
+bool adc_stream_hw_start(uint16_t *buffers[2], uint32_t block_samples,
+                         uint32_t channel_mask, uint32_t adc_rate_hz);
+
+/**
+ * @brief Stop the sampler
+ */
+void adc_stream_hw_stop(void);
+
+/**
+ * @brief Called by the back end when a block buffer is full
+ * @param pxHigherPriorityTaskWoken Set if the consumer should run
+ */
+void adc_stream_block_from_isr(BaseType_t *pxHigherPriorityTaskWoken);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADC_STREAM_H */
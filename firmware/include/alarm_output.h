@@ -0,0 +1,111 @@
+/**
+ * @file alarm_output.h
+ * @brief Zone alarm outputs and fire LEDs, with an interrupt fast path
+ *
+ * Each input zone drives its alarm output (GPIO14/15) and fire LED
+ * (GPIO8/9). With the fast path enabled, the zone filter interrupt
+ * asserts both as soon as a fire input passes the PIO confirm filter,
+ * before any task runs; the sensor monitor then verifies the zone
+ * against the zone table and takes the outputs over. A fast assertion
+ * the monitor does not confirm is released and counted. A confirmed
+ * zone latches in the zone table, so its outputs stay on after the
+ * fire input clears, until the alarm is reset. Without the
+ * fast path (or on GPIO edge interrupts, which are unfiltered) the
+ * monitor asserts the outputs itself.
+ *
+ * Every assertion records its edge-to-output latency in the statistics
+ * and, with FACP_TRACE, as a TRACE_EVT_ALARM_OUTPUT event.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef ALARM_OUTPUT_H
+#define ALARM_OUTPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "board_pins.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ALARM_OUTPUT_ZONES          2
+#define ALARM_OUTPUT_ZONE_MASK      ((1UL << ALARM_OUTPUT_ZONES) - 1u)
+
+/* Who changed an output; the trace event carries it */
+typedef enum {
+    ALARM_OUTPUT_SOURCE_FAST = 0,       /* Zone filter interrupt */
+    ALARM_OUTPUT_SOURCE_TASK,           /* Sensor monitor */
+    ALARM_OUTPUT_SOURCE_RELEASE         /* Released by the sensor monitor */
+} alarm_output_source_t;
+
+/* Output statistics, all zones */
+typedef struct {
+    uint32_t fast_asserts;              /* Asserted from the interrupt */
+    uint32_t task_asserts;              /* Asserted by the sensor monitor */
+    uint32_t confirmed;                 /* Fast assertions the monitor confirmed */
+    uint32_t unconfirmed;               /* Fast assertions released unconfirmed */
+    uint32_t last_latency_us;           /* Edge-to-output latency of the last assertion */
+    uint32_t max_fast_latency_us;
+    uint32_t max_task_latency_us;
+} alarm_output_stats_t;
+
+/**
+ * @brief Configure the outputs and LEDs, all off
+ * @param fast_path Let the zone filter interrupt assert outputs
+ */
+void alarm_output_init(bool fast_path);
+
+/**
+ * @brief Assert the outputs of zones whose fire input was just confirmed
+ *
+ * Interrupt context, on the sensor monitor's core. Disabled zones and
+ * zones already asserted are skipped.
+ *
+ * @param zones Zone bits (bit 0 = zone 1)
+ * @param edge_us time_us_64() of the input edge
+ */
+void alarm_output_fast_from_isr(uint32_t zones, uint64_t edge_us);
+
+/**
+ * @brief Get the zones asserted by the fast path and not yet verified
+ *
+ * The sensor monitor reads this before it consumes the input edges and
+ * passes it back to alarm_output_update().
+ *
+ * @return Zone bits
+ */
+uint32_t alarm_output_get_fast_pending(void);
+
+/**
+ * @brief Drive the outputs from the verified zone alarms
+ *
+ * Sensor monitor task only.
+ *
+ * @param alarm Zones in alarm per the zone table (latched until reset)
+ * @param fast_seen Result of alarm_output_get_fast_pending() taken
+ *                  before the edges behind alarm were consumed; fast
+ *                  assertions newer than that are left for the next call
+ * @param edge_us Time of the last rising fire edge, per zone
+ */
+void alarm_output_update(uint32_t alarm, uint32_t fast_seen, const uint64_t *edge_us);
+
+/**
+ * @brief Get the asserted zones
+ * @return Zone bits
+ */
+uint32_t alarm_output_get_active(void);
+
+/**
+ * @brief Copy the output statistics
+ * @param stats Receives the statistics
+ */
+void alarm_output_get_stats(alarm_output_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ALARM_OUTPUT_H */
@@ -0,0 +1,61 @@
+/**
+ * @file board_pins.h
+ * @brief RP2040 GPIO assignments for the FACP iZone zone card
+ * 
+ * Pin numbers follow hardware/docs/rp2040_pinout_table.md, plus the
+ * pending board changes listed there.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef BOARD_PINS_H
+#define BOARD_PINS_H
+
+/* Debug UART */
+#define BOARD_PIN_UART0_TX          0
+#define BOARD_PIN_UART0_RX          1
+
+/* I2C1 link to the building controller */
+#define BOARD_PIN_I2C1_SDA          2
+#define BOARD_PIN_I2C1_SCL          3
+
+/* TCMT4600 optocoupler inputs (high = active) */
+#define BOARD_PIN_FIRE_ZONE_1       4
+#define BOARD_PIN_FIRE_ZONE_2       5
+#define BOARD_PIN_FAULT_ZONE_1      6
+#define BOARD_PIN_FAULT_ZONE_2      7
+
+/* Zone indicator LEDs (high = on) */
+#define BOARD_PIN_LED_FIRE_1        8
+#define BOARD_PIN_LED_FIRE_2        9
+#define BOARD_PIN_LED_FAULT_1       10
+#define BOARD_PIN_LED_FAULT_2       11
+
+/* Zone test switches (active low) */
+#define BOARD_PIN_TEST_SW_1         12
+#define BOARD_PIN_TEST_SW_2         13
+
+/* Zone alarm outputs */
+#define BOARD_PIN_ALARM_OUT_1       14
+#define BOARD_PIN_ALARM_OUT_2       15
+
+/* Expansion lines */
+#define BOARD_PIN_EXPANSION_IN      16
+#define BOARD_PIN_EXPANSION_OUT     17
+
+/* Panel power and normal LEDs: pending board change, not on the
+ * schematic (see "Pending Board Changes" in the pinout table). They take
+ * the SPI MISO and CS pins of the debug header, since GPIO2/3 are I2C1. */
+#define BOARD_PIN_LED_POWER         20
+#define BOARD_PIN_LED_NORMAL        21
+
+/* Power monitor */
+#define BOARD_PIN_POWER_GOOD        22
+
+/* Analog sensor inputs */
+#define BOARD_PIN_ADC0              26
+#define BOARD_PIN_ADC1              27
+#define BOARD_PIN_ADC2              28
+
+#endif /* BOARD_PINS_H */
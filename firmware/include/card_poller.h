@@ -0,0 +1,240 @@
+/**
+ * @file card_poller.h
+ * @brief Building controller: pipelined I2C1 master poller for zone cards
+ *
+ * In a building controller build (FACP_BUILDING_CONTROLLER) I2C1 is the
+ * master of up to CARD_POLLER_MAX_CARDS zone cards at consecutive
+ * addresses from CARD_POLLER_FIRST_ADDRESS, and reads each card's
+ * status_link.h frame. Every card is read once per full sweep
+ * (CARD_POLLER_SWEEP_MS, FR-BC-001); cards in alarm or fault, or that
+ * have just started failing, are also read on every hot pass in between
+ * (CARD_POLLER_HOT_MS).
+ *
+ * A pass is a plan of cards, each with its own frame buffer. The back
+ * end runs one transaction at a time (offset write, repeated start,
+ * frame read) by DMA, and its completion interrupt starts the next card
+ * of the plan at once, so the bus never waits for the task. The task
+ * checks the CRC of card N and updates its record while card N + 1 is
+ * on the bus.
+ *
+ * In CARD_POLLER_MODE_CHANGE a card whose frame the poller holds is read
+ * with one byte: its change counter (status_link.h register 0, where the
+ * last frame read left the offset). Only when the counter differs is the
+ * frame read, as an extra slot at the end of the pass. A card that has
+ * failed, or whose frame is older than CARD_POLLER_FRAME_REFRESH_MS, is
+ * read in full.
+ *
+ * With attention enabled, a falling edge of the cards' wired-OR
+ * attention line (BOARD_PIN_EXPANSION_IN) wakes the poller task between
+ * passes for an attention scan: every card by change counter, with the
+ * frame read of a changed card queued straight after the transaction on
+ * the bus. The scan stops once the line is released and a change was
+ * found, and runs again if the line is still held, once per wait: then
+ * only a new edge scans before the next pass, so a card that keeps
+ * changing cannot hold the poller off its schedule. A change reaches the
+ * card record in one scan rather than up to a sweep later (NFR-PERF-002).
+ *
+ * The back end (card_poller_i2c.c, or the host simulation) implements
+ * card_poller_hw_*() and reports each transaction with
+ * card_poller_done_from_isr().
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef CARD_POLLER_H
+#define CARD_POLLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "status_link.h"
+#include "periodic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef FACP_BUILDING_CONTROLLER
+#define FACP_BUILDING_CONTROLLER    0
+#endif
+
+#define CARD_POLLER_MAX_CARDS       32      /* FR-COM-003 */
+#define CARD_POLLER_FIRST_ADDRESS   0x20    /* Card n answers at 0x20 + n */
+#define CARD_POLLER_BAUDRATE        STATUS_LINK_BAUDRATE
+#define CARD_POLLER_SWEEP_MS        1000    /* Every card at least this often */
+#define CARD_POLLER_HOT_MS          100     /* Cards in alarm or fault */
+#define CARD_POLLER_TIMEOUT_MS      10      /* One transaction, including clock stretching */
+#define CARD_POLLER_FAIL_LIMIT      3       /* Consecutive failures before a card is offline */
+#define CARD_POLLER_FRAME_REFRESH_MS (2 * STATUS_LINK_FORCED_REFRESH_MS) /* Stuck counters */
+
+typedef enum {
+    CARD_POLLER_MODE_FULL = 0,              /* Every poll reads the frame */
+    CARD_POLLER_MODE_CHANGE                 /* One-byte change counter reads */
+} card_poller_mode_t;
+
+typedef enum {
+    CARD_POLL_OK = 0,
+    CARD_POLL_NAK,                          /* Address or offset not acknowledged */
+    CARD_POLL_CRC,                          /* Frame failed its CRC or header check */
+    CARD_POLL_TIMEOUT                       /* No completion within CARD_POLLER_TIMEOUT_MS */
+} card_poll_result_t;
+
+/* State and counters of one zone card */
+typedef struct {
+    uint8_t address;
+    bool online;                            /* Answered within the last FAIL_LIMIT polls */
+    uint8_t system_status;                  /* From the last good frame */
+    uint8_t alarm;
+    uint8_t fault;
+    uint8_t disabled;
+    uint8_t outputs;
+    uint16_t sequence;                      /* Card's publish count */
+    uint8_t change;                         /* Change counter of the last good frame */
+    bool synced;                            /* Frame current as of the last good poll */
+    uint32_t last_ok_ms;
+    uint32_t last_frame_ms;
+    uint32_t event_us;                      /* time_us_32() when alarm or fault last changed */
+    uint32_t polls;
+    uint32_t quick_polls;                   /* Change counter reads among the polls */
+    uint32_t naks;
+    uint32_t crc_errors;
+    uint32_t timeouts;
+    uint32_t failures;                      /* Consecutive failed polls */
+    uint32_t rtt_last_us;                   /* Transaction start to completion interrupt */
+    uint32_t rtt_max_us;
+    uint64_t rtt_total_us;                  /* Over good polls */
+} card_poller_card_t;
+
+/* Pass timing: first transaction start to last card checked */
+typedef struct {
+    uint32_t sweeps;
+    uint32_t hot_passes;
+    uint32_t sweep_last_us;
+    uint32_t sweep_max_us;
+    uint32_t hot_last_us;
+    uint32_t hot_max_us;
+    uint32_t quick_reads;                   /* One-byte change counter reads */
+    uint32_t frame_reads;
+    uint32_t attention_edges;
+    uint32_t attention_scans;
+    uint32_t attention_last_us;
+    uint32_t attention_max_us;
+} card_poller_stats_t;
+
+/**
+ * @brief Reset the card table and start the I2C1 master
+ * @param card_count Cards on the bus (at most CARD_POLLER_MAX_CARDS)
+ * @param baudrate Bus clock in Hz
+ * @param mode Full frame or change counter polling
+ * @return false if the back end could not start
+ */
+bool card_poller_init(uint32_t card_count, uint32_t baudrate, card_poller_mode_t mode);
+
+/**
+ * @brief Poll one pass and update the card records
+ *
+ * Blocks the calling task until every card of the pass is checked. Only
+ * one task may poll.
+ *
+ * @param full_sweep true for every card, false for the hot cards only
+ * @return Transactions of the pass, including frame reads of changed cards
+ */
+uint32_t card_poller_run(bool full_sweep);
+
+/**
+ * @brief Sleep until the next pass is due, serving attention scans meanwhile
+ *
+ * Ends the poller's periodic cycle like periodic_wait_notify().
+ *
+ * @param periodic Poller loop state
+ */
+void card_poller_wait(periodic_task_t *periodic);
+
+/**
+ * @brief Act on attention line edges
+ * @param enabled false to poll on the pass schedule only
+ */
+void card_poller_set_attention(bool enabled);
+
+/**
+ * @brief Copy the record of one card
+ * @param index Card index
+ * @param card Receives the record
+ * @return false if the index is not configured
+ */
+bool card_poller_get_card(uint32_t index, card_poller_card_t *card);
+
+/**
+ * @brief Copy the pass timing
+ * @param stats Receives the timing
+ */
+void card_poller_get_stats(card_poller_stats_t *stats);
+
+/**
+ * @brief Card poller task: full sweeps with hot passes in between, and
+ *        attention scans
+ *
+ * Table task of building controller builds, on the communication core.
+ *
+ * @param pvParameters Unused
+ */
+void vCardPollerTask(void *pvParameters);
+
+/**
+ * @brief Report the end of the running transaction (back end interrupt)
+ *
+ * Starts the next card of the pass before returning.
+ *
+ * @param acked false if the card did not acknowledge
+ * @param higher_priority_woken Set if the poller task should run
+ */
+void card_poller_done_from_isr(bool acked, BaseType_t *higher_priority_woken);
+
+/**
+ * @brief Report a falling edge of the attention line (back end interrupt)
+ * @param higher_priority_woken Set if the poller task should run
+ */
+void card_poller_attention_from_isr(BaseType_t *higher_priority_woken);
+
+/* Back end (card_poller_i2c.c, or the host simulation) */
+
+/**
+ * @brief Start the I2C1 master and the attention line interrupt
+ * @param baudrate Bus clock in Hz
+ * @return false if a DMA channel could not be claimed
+ */
+bool card_poller_hw_init(uint32_t baudrate);
+
+/**
+ * @brief Start reading a card
+ *
+ * Called with the poller's interrupt masked or from its interrupt; the
+ * completion is reported with card_poller_done_from_isr().
+ *
+ * @param address 7-bit card address
+ * @param frame Receives the bytes
+ * @param length Bytes to read
+ * @param set_offset true to write offset 0 first (repeated start), false
+ *                   to read from the card's current offset
+ */
+void card_poller_hw_begin(uint8_t address, uint8_t *frame, uint32_t length, bool set_offset);
+
+/**
+ * @brief Abandon the running transaction without a completion
+ *
+ * Called with the poller's interrupt masked.
+ */
+void card_poller_hw_abort(void);
+
+/**
+ * @brief Level of the attention line
+ * @return true while a card holds the line low
+ */
+bool card_poller_hw_attention(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CARD_POLLER_H */
@@ -0,0 +1,100 @@
+/**
+ * @file core_channel.h
+ * @brief Single-producer single-consumer channel between the cores
+ *
+ * Hands message pointers (typically msg_pool blocks) from one producer
+ * on one core to one consumer task on the other without the kernel's
+ * cross-core lock: the ring lives in SRAM, head and tail each have a
+ * single writer, and the producer rings the consumer's core_doorbell
+ * only when the consumer is about to sleep. The doorbell interrupt
+ * wakes the consumer through its task notification at index
+ * CORE_CHANNEL_NOTIFY_INDEX, so the task's default notification stays
+ * free for other uses.
+ *
+ *     Consumer (core 1):              Producer (core 0):
+ *     core_channel_open(&xChan);      if (!core_channel_send(&xChan, pxMsg)) {
+ *     for (;;) {                          msg_pool_free(pxMsg);
+ *         pxMsg = core_channel_receive(&xChan, portMAX_DELAY);
+ *         ... handle, msg_pool_free(pxMsg) ...
+ *     }                               }
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef CORE_CHANNEL_H
+#define CORE_CHANNEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "core_doorbell.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CORE_CHANNEL_SLOTS          32  /* Power of two */
+#define CORE_CHANNEL_NOTIFY_INDEX   1   /* Consumer notification used for wake-ups */
+
+/* Channel counters */
+typedef struct {
+    uint32_t sent;                  /* Messages accepted */
+    uint32_t full;                  /* Sends refused because the ring was full */
+    uint32_t doorbells;             /* Sends that had to wake the consumer */
+} core_channel_stats_t;
+
+typedef struct {
+    void *slots[CORE_CHANNEL_SLOTS];
+    volatile uint32_t head;         /* Written by the producer only */
+    volatile uint32_t tail;         /* Written by the consumer only */
+    volatile uint32_t sleeping;     /* Consumer is about to block */
+    TaskHandle_t consumer;
+    core_doorbell_t doorbell;
+    core_channel_stats_t stats;     /* Written by the producer only */
+} core_channel_t;
+
+/**
+ * @brief Open a channel for the calling task as its consumer
+ *
+ * Call from the consumer task on its own core: the doorbell interrupt
+ * is enabled on the calling core. The task must be pinned to that core.
+ *
+ * @param channel Channel (static storage)
+ * @return false if no doorbell is free
+ */
+bool core_channel_open(core_channel_t *channel);
+
+/**
+ * @brief Pass a message to the consumer without blocking
+ *
+ * Single producer: one task or ISR, on the other core. Ownership of the
+ * message passes to the consumer on success.
+ *
+ * @param channel Open channel
+ * @param message Message pointer, not NULL
+ * @return false if the ring is full
+ */
+bool core_channel_send(core_channel_t *channel, void *message);
+
+/**
+ * @brief Take the next message, sleeping until one arrives
+ * @param channel Open channel; consumer task only
+ * @param timeout Ticks to wait
+ * @return Message, or NULL on timeout
+ */
+void *core_channel_receive(core_channel_t *channel, TickType_t timeout);
+
+/**
+ * @brief Copy the channel counters
+ * @param channel Channel
+ * @param stats Receives the counters
+ */
+void core_channel_get_stats(const core_channel_t *channel, core_channel_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_CHANNEL_H */
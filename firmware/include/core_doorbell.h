@@ -0,0 +1,53 @@
+/**
+ * @file core_doorbell.h
+ * @brief Cross-core doorbell interrupt for FACP iZone
+ *
+ * Rings an interrupt on another core with one register write. The SMP
+ * kernel owns the SIO FIFO interrupt (its cross-core yield), so the
+ * doorbell is a claimed timer alarm that is never armed: ringing forces
+ * its interrupt through the timer's INTF register, and only the core
+ * that called core_doorbell_init() has the alarm interrupt enabled.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef CORE_DOORBELL_H
+#define CORE_DOORBELL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Runs in interrupt context on the core that initialised the doorbell */
+typedef void (*core_doorbell_handler_t)(void *context);
+
+typedef struct {
+    int32_t alarm;                          /* Claimed timer alarm, -1 before init */
+    core_doorbell_handler_t handler;
+    void *context;
+} core_doorbell_t;
+
+/**
+ * @brief Claim a doorbell and take its interrupt on the calling core
+ * @param bell Doorbell to initialise
+ * @param handler Interrupt handler
+ * @param context Passed to the handler
+ * @return false if no timer alarm is free
+ */
+bool core_doorbell_init(core_doorbell_t *bell, core_doorbell_handler_t handler, void *context);
+
+/**
+ * @brief Raise the doorbell interrupt; callable from any core and context
+ * @param bell Initialised doorbell
+ */
+void core_doorbell_ring(core_doorbell_t *bell);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_DOORBELL_H */
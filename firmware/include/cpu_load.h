@@ -0,0 +1,94 @@
+/**
+ * @file cpu_load.h
+ * @brief Per-core and per-task CPU load accounting for FACP iZone
+ *
+ * Idle time is accounted per core from the task switch hook, so core
+ * load is exact even when idle tasks migrate between cores. Per-task
+ * load comes from the kernel's run-time counters (1 MHz, 64-bit).
+ * cpu_load_update() turns both into loads over the last interval and a
+ * peak over the last window; results can be read at any time from
+ * either core, e.g. by the USB console or the I2C register map.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef CPU_LOAD_H
+#define CPU_LOAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CPU_LOAD_MAX_TASKS          24  /* Tasks tracked per report */
+#define CPU_LOAD_WINDOW_UPDATES     60  /* Updates per peak window */
+
+/* Loads are in permille of one core */
+typedef struct {
+    uint16_t load_permille;         /* Busy time over the last interval */
+    uint16_t peak_permille;         /* Highest interval load in the last window */
+    uint64_t idle_us;               /* Total idle time since boot */
+} cpu_load_core_t;
+
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];
+    UBaseType_t priority;
+    uint16_t load_permille;         /* Run time over the last interval */
+    uint16_t peak_permille;         /* Highest interval load in the last window */
+} cpu_load_task_t;
+
+/**
+ * @brief Compute loads over the time since the previous call
+ *
+ * Call periodically from one task (the system monitor calls it once a
+ * second). The first call only sets the baseline.
+ */
+void cpu_load_update(void);
+
+/**
+ * @brief Get the load of one core
+ * @param core Core number
+ * @param load Receives the load
+ * @return false if the core number is invalid
+ */
+bool cpu_load_get_core(uint32_t core, cpu_load_core_t *load);
+
+/**
+ * @brief Get the per-task loads
+ * @param tasks Receives up to max_tasks entries
+ * @param max_tasks Capacity of tasks
+ * @return Number of entries written
+ */
+uint32_t cpu_load_get_tasks(cpu_load_task_t *tasks, uint32_t max_tasks);
+
+/**
+ * @brief Get the idle time of one core, including a current idle span
+ * @param core Core number
+ * @return Microseconds spent idle since the scheduler started
+ */
+uint64_t cpu_load_get_idle_us(uint32_t core);
+
+/**
+ * @brief Format the last report as text
+ * @param buffer Output buffer
+ * @param buffer_size Size of the buffer
+ * @return Number of characters written (excluding the terminator)
+ */
+int cpu_load_format(char *buffer, size_t buffer_size);
+
+/**
+ * @brief Task switch hook (traceTASK_SWITCHED_IN), called by the kernel
+ */
+void cpu_load_task_switched_in(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPU_LOAD_H */
@@ -0,0 +1,164 @@
+/**
+ * @file crc.h
+ * @brief CRC-16 and CRC-32 on the CPU and on the DMA sniffer
+ *
+ * Two CRCs cover the firmware: CRC-16/CCITT-FALSE for the status link
+ * frames and the tokenized log frames, and CRC-32 (IEEE 802.3, as in
+ * zlib) for larger blocks such as the system configuration.
+ *
+ * The CPU back end is slicing-by-4: four 256-entry tables, built in RAM
+ * on first use (2 KB for CRC-16, 4 KB for CRC-32), fold one aligned word
+ * per step instead of one bit or byte. The DMA back end runs a transfer
+ * through the RP2040 DMA sniffer, which computes the CRC of every byte
+ * the channel moves, so a block is checked, or copied and checked, with
+ * the CPU free until crc_dma_finish(). The sniffer is one per chip: the
+ * DMA back end has one user at a time, and the card status link and
+ * poller DMA channels never enable it.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* CRC-16/CCITT-FALSE: poly 0x1021, init 0xFFFF, MSB first, no final XOR
+ * (check value 0x29B1 over "123456789") */
+#define CRC16_CCITT_INIT        0xFFFFu
+
+/* CRC-32/IEEE: poly 0x04C11DB7, LSB first, init and final XOR 0xFFFFFFFF
+ * (check value 0xCBF43926); crc32_ieee_update() takes and returns the
+ * finished value, starting from 0, as zlib's crc32() does */
+#define CRC32_IEEE_INIT         0u
+
+typedef enum {
+    CRC_KIND_16_CCITT = 0,
+    CRC_KIND_32_IEEE,
+    CRC_KIND_COUNT
+} crc_kind_t;
+
+/* Sniffer set-up for one CRC (RP2040 datasheet, DMA SNIFF_CTRL) */
+typedef struct {
+    uint8_t calc;                       /* SNIFF_CTRL.CALC */
+    bool out_rev;                       /* Result read back bit-reversed */
+    bool out_inv;                       /* Result read back inverted */
+    uint32_t seed;                      /* SNIFF_DATA before the transfer */
+    uint32_t mask;                      /* Result bits */
+} crc_sniff_config_t;
+
+/* Sniffer set-up of each crc_kind_t, shared by the driver and the host
+ * simulation of the sniffer */
+extern const crc_sniff_config_t crc_sniff_config[CRC_KIND_COUNT];
+
+/* CPU back end (crc.c) */
+
+/**
+ * @brief Continue a CRC-16/CCITT-FALSE
+ * @param crc CRC so far (CRC16_CCITT_INIT to start)
+ * @param data Bytes
+ * @param length Byte count
+ * @return CRC including data
+ */
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, size_t length);
+
+/**
+ * @brief CRC-16/CCITT-FALSE of a byte buffer
+ * @param data Bytes
+ * @param length Byte count
+ * @return CRC
+ */
+static inline uint16_t crc16_ccitt(const void *data, size_t length)
+{
+    return crc16_ccitt_update(CRC16_CCITT_INIT, data, length);
+}
+
+/**
+ * @brief Continue a CRC-32/IEEE
+ * @param crc CRC so far (CRC32_IEEE_INIT to start)
+ * @param data Bytes
+ * @param length Byte count
+ * @return CRC including data
+ */
+uint32_t crc32_ieee_update(uint32_t crc, const void *data, size_t length);
+
+/**
+ * @brief CRC-32/IEEE of a byte buffer
+ * @param data Bytes
+ * @param length Byte count
+ * @return CRC
+ */
+static inline uint32_t crc32_ieee(const void *data, size_t length)
+{
+    return crc32_ieee_update(CRC32_IEEE_INIT, data, length);
+}
+
+/**
+ * @brief Bit-at-a-time reference of either CRC
+ *
+ * For checking the other back ends; a fraction of their speed.
+ *
+ * @param kind CRC
+ * @param data Bytes
+ * @param length Byte count
+ * @return CRC
+ */
+uint32_t crc_bitwise(crc_kind_t kind, const void *data, size_t length);
+
+/* DMA sniffer back end (crc_dma.c; simulated in the host build) */
+
+/**
+ * @brief Claim the DMA channel for the sniffer
+ * @return true if a channel was free (or already claimed)
+ */
+bool crc_dma_init(void);
+
+/**
+ * @brief Release the DMA channel claimed by crc_dma_init()
+ *
+ * For one-shot users; the transfer started last must have finished.
+ */
+void crc_dma_deinit(void);
+
+/**
+ * @brief Start a checked transfer
+ *
+ * Bytes are moved one per DMA cycle with the sniffer on the channel. The
+ * buffers must stay untouched until crc_dma_finish().
+ *
+ * @param kind CRC
+ * @param dst Copy destination, or NULL to compute the CRC only
+ * @param src Bytes
+ * @param length Byte count
+ */
+void crc_dma_start(crc_kind_t kind, void *dst, const void *src, size_t length);
+
+/**
+ * @brief Check whether the transfer started last is still running
+ * @return true while bytes are still moving
+ */
+bool crc_dma_busy(void);
+
+/**
+ * @brief Wait for the transfer started last and read its CRC
+ * @return CRC, in the low 16 bits for CRC_KIND_16_CCITT
+ */
+uint32_t crc_dma_finish(void);
+
+/**
+ * @brief CRC of a byte buffer on the sniffer, waiting for the result
+ * @param kind CRC
+ * @param src Bytes
+ * @param length Byte count
+ * @return CRC
+ */
+static inline uint32_t crc_dma_compute(crc_kind_t kind, const void *src, size_t length)
+{
+    crc_dma_start(kind, NULL, src, length);
+    return crc_dma_finish();
+}
+
+#endif /* CRC_H */
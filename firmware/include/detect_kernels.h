@@ -0,0 +1,129 @@
+/**
+ * @file detect_kernels.h
+ * @brief Fixed-point detection kernels over arrays of zones
+ * 
+ * Each kernel makes one pass over the zone arrays per sample period.
+ * Per-zone flags are returned as bit masks (bit n = zone n), so a bank
+ * covers up to DETECT_MAX_BANK_ZONES zones; larger installations run one
+ * bank per 32 zones.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef DETECT_KERNELS_H
+#define DETECT_KERNELS_H
+
+#include <stdint.h>
+#include "fixed_point.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DETECT_MAX_BANK_ZONES   32
+
+/**
+ * @brief Low-pass filter raw readings: y += alpha * (x - y)
+ * @param state Filter outputs (Q16), updated in place
+ * @param samples Raw readings, one per zone
+ * @param count Zones
+ * @param alpha Smoothing coefficient (Q15)
+ */
+void detect_lowpass(q16_t *state, const uint16_t *samples, uint32_t count,
+                    q15_t alpha);
+
+/**
+ * @brief Track the baseline with an EWMA of weight 2^-shift
+ * 
+ * Zones set in freeze_mask keep their baseline, so a slowly developing
+ * condition is not absorbed into it.
+ * 
+ * @param baseline Baselines (Q16), updated in place
+ * @param input Filtered readings (Q16)
+ * @param count Zones
+ * @param shift EWMA weight exponent
+ * @param freeze_mask Zones whose baseline is held
+ */
+void detect_ewma(q16_t *baseline, const q16_t *input, uint32_t count,
+                 uint32_t shift, uint32_t freeze_mask);
+
+/**
+ * @brief Smoothed rate of rise per sample period
+ * @param slope Smoothed slope (Q16 per sample), updated in place
+ * @param previous Previous inputs (Q16), updated in place
+ * @param input Filtered readings (Q16)
+ * @param count Zones
+ * @param shift Slope smoothing weight exponent
+ * @param threshold Rate-of-rise alarm level (Q16 per sample)
+ * @return Mask of zones whose slope is at or above threshold
+ */
+uint32_t detect_rate_of_rise(q16_t *slope, q16_t *previous, const q16_t *input,
+                             uint32_t count, uint32_t shift, q16_t threshold);
+
+/**
+ * @brief Threshold with hysteresis on the deviation from a reference
+ * 
+ * A zone activates when input - reference >= on[n] and releases when it
+ * falls to off[n] or below.
+ * 
+ * @param input Filtered readings (Q16)
+ * @param reference Baselines (Q16)
+ * @param on Activation thresholds (Q16)
+ * @param off Release thresholds (Q16)
+ * @param count Zones
+ * @param active_mask Currently active zones
+ * @return New active mask
+ */
+uint32_t detect_hysteresis(const q16_t *input, const q16_t *reference,
+                           const q16_t *on, const q16_t *off, uint32_t count,
+                           uint32_t active_mask);
+
+/* All detection state for one bank of zones */
+typedef struct {
+    uint32_t count;                     /* Zones in the bank */
+    q16_t filtered[DETECT_MAX_BANK_ZONES];
+    q16_t baseline[DETECT_MAX_BANK_ZONES];
+    q16_t previous[DETECT_MAX_BANK_ZONES];
+    q16_t slope[DETECT_MAX_BANK_ZONES];
+    q16_t on[DETECT_MAX_BANK_ZONES];
+    q16_t off[DETECT_MAX_BANK_ZONES];
+    q15_t lowpass_alpha;
+    uint8_t baseline_shift;
+    uint8_t slope_shift;
+    q16_t ror_threshold;                /* Q16 per sample */
+    uint32_t level_mask;                /* Hysteresis state */
+    uint32_t ror_mask;                  /* Rate-of-rise over threshold */
+} detect_bank_t;
+
+/**
+ * @brief Initialise a bank from its first readings
+ * @param bank Bank state; count and the tuning fields must be set
+ * @param samples Raw readings, one per zone
+ */
+void detect_bank_init(detect_bank_t *bank, const uint16_t *samples);
+
+/**
+ * @brief Run all kernels for one sample period in a single pass
+ * @param bank Bank state
+ * @param samples Raw readings, one per zone
+ * @return Mask of zones whose level or rate-of-rise flag changed
+ */
+uint32_t detect_bank_step(detect_bank_t *bank, const uint16_t *samples);
+
+/**
+ * @brief Convert a rate of rise per second to the per-sample unit
+ * @param per_second Rate (Q16 per second)
+ * @param sample_hz Sample rate
+ * @return Rate (Q16 per sample)
+ */
+static inline q16_t detect_ror_per_sample(q16_t per_second, uint32_t sample_hz)
+{
+    return (q16_t)(per_second / (int32_t)sample_hz);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DETECT_KERNELS_H */
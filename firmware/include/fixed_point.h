@@ -0,0 +1,78 @@
+/**
+ * @file fixed_point.h
+ * @brief Q15/Q16 fixed-point arithmetic for sensor processing
+ * 
+ * The Cortex-M0+ has no FPU; these helpers keep sensor processing in
+ * integer arithmetic. Multiplies are arranged to fit the single-cycle
+ * 32x32->32 multiplier rather than calling the 64-bit library routine.
+ * 
+ * q16_t: signed 16.16 (12-bit ADC readings scale to at most 2^28)
+ * q15_t: signed 1.15 coefficients, 0x7FFF ~ 1.0
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int16_t q15_t;
+typedef int32_t q16_t;
+
+#define Q15_ONE             ((q15_t)0x7FFF)
+#define Q16_ONE             ((q16_t)0x10000)
+
+/* Constant conversions; the argument must be an integer constant or variable */
+#define Q16_FROM_INT(x)     ((q16_t)((x) * Q16_ONE))
+#define Q16_TO_INT(x)       ((int32_t)((x) >> 16))
+
+/* Q15 coefficient from a ratio num/den, 0 <= num <= den */
+#define Q15_FROM_RATIO(num, den) ((q15_t)(((int32_t)(num) * 0x7FFF) / (den)))
+
+/**
+ * @brief Convert a raw unsigned reading to Q16
+ */
+static inline q16_t q16_from_raw(uint16_t raw)
+{
+    return (q16_t)((uint32_t)raw << 16);
+}
+
+/**
+ * @brief Multiply a Q16 value by a Q15 coefficient
+ * 
+ * Splits x so both partial products fit 32 bits; the result equals
+ * floor(x * a / 2^15) for |x| < 2^30.
+ */
+static inline q16_t q16_mul_q15(q16_t x, q15_t a)
+{
+    int32_t lHi = x >> 15;
+    int32_t lLo = x & 0x7FFF;
+
+    return (q16_t)((lHi * a) + ((lLo * a) >> 15));
+}
+
+/**
+ * @brief Saturating Q16 addition
+ */
+static inline q16_t q16_add_sat(q16_t a, q16_t b)
+{
+    int32_t lSum = (int32_t)((uint32_t)a + (uint32_t)b);
+
+    /* Overflow only if both operands share a sign the result lacks */
+    if (((a ^ lSum) & (b ^ lSum)) < 0) {
+        return (a < 0) ? INT32_MIN : INT32_MAX;
+    }
+    return lSum;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIXED_POINT_H */
@@ -25,9 +25,9 @@ void vPortConfigureTimerForRunTimeStats(void);
 
 /**
  * @brief Get run-time counter value for statistics
- * @return Current run-time counter value
+ * @return Microseconds since boot
  */
-uint32_t ulGetRunTimeCounterValue(void);
+configRUN_TIME_COUNTER_TYPE ulGetRunTimeCounterValue(void);
 
 /**
  * @brief Called when an assertion fails
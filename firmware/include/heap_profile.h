@@ -0,0 +1,84 @@
+/**
+ * @file heap_profile.h
+ * @brief Kernel heap allocation profiler for FACP iZone
+ *
+ * Built with -DFACP_HEAP_PROFILE=ON (RP2040 build), the linker wraps
+ * pvPortMalloc() and vPortFree() so every heap_4 allocation is charged
+ * to its call site (the caller's return address): allocations, frees,
+ * failures, live and peak bytes, and a histogram of how long blocks
+ * lived. heap_profile_dump() prints the sites together with the free
+ * heap, the minimum ever free and the largest free block as "HEAPPROF"
+ * hex lines, which tools/heap_profile.py symbolizes against the ELF.
+ * Without FACP_HEAP_PROFILE all of this compiles out.
+ *
+ * Dump records, little-endian, hex-encoded one per line:
+ *   HEAPPROF H <header>   magic, version, sites, anchor, heap sizes,
+ *                         untracked and failing request (heap_profile.c)
+ *   HEAPPROF S <site>     one per call site
+ *   HEAPPROF END
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef HEAP_PROFILE_H
+#define HEAP_PROFILE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef FACP_HEAP_PROFILE
+#define FACP_HEAP_PROFILE           0
+#endif
+
+#define HEAP_PROFILE_MAX_SITES      32      /* Distinct call sites */
+#define HEAP_PROFILE_MAX_LIVE       128     /* Outstanding blocks tracked for lifetimes */
+#define HEAP_PROFILE_LIFE_BUCKETS   6       /* <10 ms, <100 ms, <1 s, <10 s, <60 s, longer */
+#define HEAP_PROFILE_DUMP_PERIOD_S  60      /* System monitor dump request interval */
+
+/**
+ * @brief Claim the profiler lock
+ *
+ * Call from prvSetupHardware(), before the first kernel allocation;
+ * earlier allocations are counted as untracked.
+ */
+void heap_profile_init(void);
+
+/**
+ * @brief Print the profile as HEAPPROF lines
+ *
+ * Call from a task; the heap statistics need the scheduler.
+ */
+void heap_profile_dump(void);
+
+/**
+ * @brief Ask for a dump without waiting for the console
+ *
+ * For the system monitor, which feeds the watchdog and must not block on
+ * stdout; heap_profile_service() prints the dump.
+ */
+void heap_profile_request_dump(void);
+
+/**
+ * @brief Print a requested dump
+ *
+ * Called by the log drain task after each pass, so a stalled console
+ * holds up only the lowest-priority task.
+ */
+void heap_profile_service(void);
+
+/**
+ * @brief Print the profile from the malloc failed hook
+ *
+ * The header names the request that failed and its call site.
+ */
+void heap_profile_panic_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEAP_PROFILE_H */
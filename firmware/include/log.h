@@ -0,0 +1,174 @@
+/**
+ * @file log.h
+ * @brief Non-blocking logging for FACP iZone
+ * 
+ * LOG_* macros copy a record (timestamp, level, format pointer and up to
+ * LOG_MAX_ARGS argument words) into a ring owned by the calling core, in
+ * constant time and with interrupts disabled only for the copy. Nothing
+ * is formatted at the call site. A low-priority drain task on core 1
+ * formats the records and writes them to stdio; when a ring is full the
+ * record is dropped and counted.
+ * 
+ * Arguments are stored as machine words, so:
+ *  - %s arguments must outlive the record (literals, task names);
+ *  - floating-point and 64-bit conversions are not supported.
+ * 
+ * With LOG_TOKENIZED (FACP_LOG_TOKENIZED=ON, RP2040 only) format strings
+ * must be literals. They are placed in the non-loaded .facp_logfmt
+ * section, the drain sends binary frames carrying the string's offset
+ * in that section, and tools/log_decode.py formats them on the host
+ * from facp_izone.elf.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_FATAL,
+    LOG_LEVEL_NONE
+} log_level_t;
+
+/* Records below this level are compiled out */
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL       LOG_LEVEL_DEBUG
+#endif
+
+#ifndef LOG_TOKENIZED
+#define LOG_TOKENIZED           0
+#endif
+
+#define LOG_MAX_ARGS            6
+#ifndef LOG_RING_RECORDS
+#if FACP_STATIC_ALLOCATION
+#define LOG_RING_RECORDS        256  /* Per core, power of two; uses RAM freed from the heap */
+#else
+#define LOG_RING_RECORDS        64   /* Per core, power of two */
+#endif
+#endif
+#define LOG_DRAIN_PERIOD_MS     10
+
+typedef uintptr_t log_arg_t;
+
+/* Tokenized frame: sync, length, payload, CRC-16/CCITT-FALSE (crc.h) of
+ * the length and payload. Little endian throughout; payload: token u32,
+ * timestamp_us u32, level << 4 | core u8, nargs u8, args u32[nargs]. */
+#define LOG_FRAME_SYNC          0xA5u
+#define LOG_TOKEN_DROPPED       0xFFFFFFFFu  /* args: core, records dropped */
+
+typedef struct {
+    uint32_t written;                   /* Records queued */
+    uint32_t dropped;                   /* Records lost to a full ring */
+    uint32_t filtered;                  /* Records below the run-time level */
+} log_core_stats_t;
+
+/* Argument counting (format string included) and conversion to log_arg_t */
+#define LOG_NARG_(_f, _1, _2, _3, _4, _5, _6, N, ...)  N
+#define LOG_NARG(...)           LOG_NARG_(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0, ~)
+#define LOG_CAT_(a, b)          a##b
+#define LOG_CAT(a, b)           LOG_CAT_(a, b)
+#define LOG_A(a)                (log_arg_t)(a)
+
+/* Format reference passed to log_write(); a token in tokenized builds */
+#if LOG_TOKENIZED
+#define LOG_F(f)                                                            \
+    __extension__ ({                                                        \
+        static const char xLogFmt[]                                         \
+            __attribute__((section(".facp_logfmt"), used)) = f;             \
+        xLogFmt;                                                            \
+    })
+#else
+#define LOG_F(f)                (f)
+#endif
+
+#define LOG_CALL_0(l, f)        log_write(l, LOG_F(f), 0)
+#define LOG_CALL_1(l, f, a)     log_write(l, LOG_F(f), 1, LOG_A(a))
+#define LOG_CALL_2(l, f, a, b)  log_write(l, LOG_F(f), 2, LOG_A(a), LOG_A(b))
+#define LOG_CALL_3(l, f, a, b, c) \
+    log_write(l, LOG_F(f), 3, LOG_A(a), LOG_A(b), LOG_A(c))
+#define LOG_CALL_4(l, f, a, b, c, d) \
+    log_write(l, LOG_F(f), 4, LOG_A(a), LOG_A(b), LOG_A(c), LOG_A(d))
+#define LOG_CALL_5(l, f, a, b, c, d, e) \
+    log_write(l, LOG_F(f), 5, LOG_A(a), LOG_A(b), LOG_A(c), LOG_A(d), LOG_A(e))
+#define LOG_CALL_6(l, f, a, b, c, d, e, g) \
+    log_write(l, LOG_F(f), 6, LOG_A(a), LOG_A(b), LOG_A(c), LOG_A(d), LOG_A(e), LOG_A(g))
+
+/* LOG_RECORD(level, fmt, args...) with at most LOG_MAX_ARGS arguments */
+#define LOG_RECORD(level, ...)                                              \
+    do {                                                                    \
+        if ((level) >= LOG_COMPILE_LEVEL) {                                 \
+            LOG_CAT(LOG_CALL_, LOG_NARG(__VA_ARGS__))((level), __VA_ARGS__); \
+        }                                                                   \
+    } while (0)
+
+#define LOG_DEBUG(...)          LOG_RECORD(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)           LOG_RECORD(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...)           LOG_RECORD(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...)          LOG_RECORD(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_FATAL(...)          LOG_RECORD(LOG_LEVEL_FATAL, __VA_ARGS__)
+
+/**
+ * @brief Reset the rings; records may be written before the drain starts
+ */
+void log_init(void);
+
+/**
+ * @brief Drain task: the only place log output blocks (see task_table.h)
+ * @param pvParameters Task parameters (unused)
+ */
+void vLogDrainTask(void *pvParameters);
+
+/**
+ * @brief Queue a record; use the LOG_* macros instead
+ * @param level Severity
+ * @param fmt Format string (must outlive the record), or its token
+ * @param nargs Number of log_arg_t arguments that follow
+ */
+void log_write(log_level_t level, const char *fmt, uint32_t nargs, ...);
+
+/**
+ * @brief Set the run-time severity filter
+ * @param level Lowest level queued
+ */
+void log_set_level(log_level_t level);
+
+/**
+ * @brief Get the run-time severity filter
+ * @return Lowest level queued
+ */
+log_level_t log_get_level(void);
+
+/**
+ * @brief Get the counters of one core's ring
+ * @param core Core number
+ * @param stats Receives the counters
+ */
+void log_get_stats(uint32_t core, log_core_stats_t *stats);
+
+/**
+ * @brief Write out all queued records synchronously
+ * 
+ * For fatal error hooks: runs with interrupts disabled and without the
+ * scheduler. Output is best effort if the console needs interrupts.
+ */
+void log_panic_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOG_H */
@@ -0,0 +1,161 @@
+/**
+ * @file msg_pool.h
+ * @brief Fixed-block message pools and pointer queues for FACP iZone
+ *
+ * Inter-task messages are taken from three fixed-size block classes
+ * instead of the FreeRTOS heap. Each core keeps a small cache of free
+ * blocks per class that it touches with only its own interrupts masked;
+ * the global freelist behind the caches is guarded by one hardware
+ * spinlock and is visited once per batch. Block counts follow the
+ * QUEUE_SIZE_* constants so a full queue never starves the pool.
+ *
+ * A msg_queue_t carries block pointers, so a payload is written once by
+ * the producer and read in place by the consumer:
+ *
+ *     comm_msg_t *pxMsg = msg_pool_alloc(sizeof(*pxMsg));
+ *     if (pxMsg != NULL) {
+ *         ... fill in ...
+ *         if (!msg_queue_send(&xCommQueue, pxMsg, 0)) {
+ *             msg_pool_free(pxMsg);
+ *         }
+ *     }
+ *
+ * The consumer frees the block when it is done with it.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef MSG_POOL_H
+#define MSG_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Block sizes (multiples of 8) */
+#define MSG_POOL_SMALL_SIZE         32      /* Sensor events, alarm commands */
+#define MSG_POOL_MEDIUM_SIZE        64      /* Panel-to-panel frames */
+#define MSG_POOL_LARGE_SIZE         192     /* SMS text, USB reports */
+
+/* Per-core cache: capacity and blocks moved per visit to the global list */
+#define MSG_POOL_CACHE_BLOCKS       4
+#define MSG_POOL_CACHE_BATCH        2
+
+/* A queue of depth n needs n blocks queued, one being filled, one being
+ * handled, plus whatever the per-core caches may be holding */
+#define MSG_POOL_BLOCKS_FOR(depth)  ((depth) + 2u + (configNUMBER_OF_CORES * MSG_POOL_CACHE_BLOCKS))
+
+#define MSG_POOL_SMALL_BLOCKS       MSG_POOL_BLOCKS_FOR(QUEUE_SIZE_SENSOR_DATA + QUEUE_SIZE_ALARM_COMMANDS)
+#define MSG_POOL_MEDIUM_BLOCKS      MSG_POOL_BLOCKS_FOR(QUEUE_SIZE_COMM_MESSAGES)
+#define MSG_POOL_LARGE_BLOCKS       MSG_POOL_BLOCKS_FOR(QUEUE_SIZE_COMM_MESSAGES / 2u)
+
+typedef enum {
+    MSG_POOL_SMALL = 0,
+    MSG_POOL_MEDIUM,
+    MSG_POOL_LARGE,
+    MSG_POOL_CLASS_COUNT
+} msg_pool_class_t;
+
+/* Usage of one size class */
+typedef struct {
+    uint32_t block_size;
+    uint32_t blocks;
+    uint32_t in_use;            /* Allocated and not yet freed */
+    uint32_t high_water;        /* Most blocks ever out of the global list (in use or cached) */
+    uint32_t exhausted;         /* Allocations that found the class empty */
+} msg_pool_stats_t;
+
+/* Queue of message block pointers */
+typedef struct {
+    QueueHandle_t handle;
+    StaticQueue_t control;
+} msg_queue_t;
+
+/**
+ * @brief Build the freelists and claim the pool spinlock
+ *
+ * Call once from prvSetupHardware(), before any task or ISR allocates.
+ */
+void msg_pool_init(void);
+
+/**
+ * @brief Allocate a block of the smallest class that fits
+ *
+ * Never blocks and never falls back to a larger class; callable from
+ * tasks and ISRs on either core.
+ *
+ * @param size Payload size in bytes
+ * @return Block, or NULL if the class is exhausted or size is too large
+ */
+void *msg_pool_alloc(size_t size);
+
+/**
+ * @brief Return a block to its pool
+ *
+ * Callable from tasks and ISRs on either core, not necessarily the one
+ * that allocated the block.
+ *
+ * @param block Block from msg_pool_alloc(), or NULL
+ */
+void msg_pool_free(void *block);
+
+/**
+ * @brief Get the usage of one size class
+ * @param cls Size class
+ * @param stats Receives the usage
+ * @return false for an invalid class
+ */
+bool msg_pool_get_stats(msg_pool_class_t cls, msg_pool_stats_t *stats);
+
+/**
+ * @brief Create a pointer queue on caller-provided storage
+ * @param queue Queue to initialise
+ * @param storage Array of length block pointers (static storage)
+ * @param length Queue depth
+ * @return true on success
+ */
+bool msg_queue_init(msg_queue_t *queue, void **storage, UBaseType_t length);
+
+/**
+ * @brief Pass a block to the consumer
+ *
+ * On success the consumer owns the block; on failure it stays with the
+ * caller.
+ *
+ * @param queue Queue
+ * @param block Block from msg_pool_alloc()
+ * @param timeout Ticks to wait for space
+ * @return true if the block was queued
+ */
+bool msg_queue_send(msg_queue_t *queue, void *block, TickType_t timeout);
+
+/**
+ * @brief Pass a block to the consumer from an ISR
+ * @param queue Queue
+ * @param block Block from msg_pool_alloc()
+ * @param higher_priority_woken Set when a context switch is needed
+ * @return true if the block was queued
+ */
+bool msg_queue_send_from_isr(msg_queue_t *queue, void *block,
+                             BaseType_t *higher_priority_woken);
+
+/**
+ * @brief Take the next block; the caller must msg_pool_free() it
+ * @param queue Queue
+ * @param timeout Ticks to wait for a block
+ * @return Block, or NULL on timeout
+ */
+void *msg_queue_receive(msg_queue_t *queue, TickType_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MSG_POOL_H */
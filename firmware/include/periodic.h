@@ -0,0 +1,131 @@
+/**
+ * @file periodic.h
+ * @brief Periodic task timing monitor for FACP iZone
+ *
+ * Wraps the vTaskDelayUntil() loop of a periodic task and measures each
+ * cycle: wake-up lateness against the ideal release time and execution
+ * time from release to the next wait, both in fixed-bucket histograms.
+ * A cycle whose work is still running at the next release is a
+ * deadline miss. Statistics of all registered tasks can be read from
+ * either core for telemetry.
+ *
+ *     periodic_task_t xPeriodic;
+ *     periodic_init(&xPeriodic, "Monitor", 50);
+ *     for (;;) {
+ *         ... work ...
+ *         periodic_wait(&xPeriodic);
+ *     }
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef PERIODIC_H
+#define PERIODIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PERIODIC_MAX_TASKS          8
+#define PERIODIC_HIST_BUCKETS       8   /* See periodic_get_bucket_limit_us() */
+
+/* Timing statistics of one periodic task */
+typedef struct {
+    const char *name;
+    uint32_t period_ms;
+    uint32_t cycles;                            /* Releases so far */
+    uint32_t misses;                            /* Cycles that overran the next release */
+    uint32_t late_max_us;                       /* Worst wake-up lateness */
+    uint32_t exec_max_us;                       /* Longest cycle execution */
+    uint32_t late_hist[PERIODIC_HIST_BUCKETS];  /* Wake-up lateness */
+    uint32_t exec_hist[PERIODIC_HIST_BUCKETS];  /* Execution time */
+} periodic_stats_t;
+
+/* Loop state; lives in the task for as long as it is registered */
+typedef struct {
+    TickType_t last_wake;
+    TickType_t period_ticks;
+    uint64_t next_release_us;                   /* Ideal time of the next release */
+    uint64_t release_us;                        /* Actual start of the running cycle */
+    bool in_cycle;
+    periodic_stats_t stats;                     /* Written by the owning task only */
+} periodic_task_t;
+
+/**
+ * @brief Start a periodic loop and register it for telemetry
+ *
+ * The first cycle starts now. Lateness is measured against releases
+ * spaced exactly one period from the first wake-up.
+ *
+ * @param task Loop state, owned by the calling task
+ * @param name Name in the statistics (must outlive the task)
+ * @param period_ms Release period
+ */
+void periodic_init(periodic_task_t *task, const char *name, uint32_t period_ms);
+
+/**
+ * @brief End the current cycle and sleep until the next release
+ * @param task Loop state
+ */
+void periodic_wait(periodic_task_t *task);
+
+/**
+ * @brief End the current cycle and sleep until the next release or a notification
+ *
+ * For periodic tasks that also react to events. A notification returns
+ * early and does not start a cycle; the next call keeps waiting for the
+ * same release. Once the release is due it is returned first and the
+ * notification stays pending, so a stream of events cannot hold the
+ * task past its release.
+ *
+ * @param task Loop state
+ * @param clear_bits Notification bits to clear on exit (as xTaskNotifyWait)
+ * @param notified Receives the notification value, may be NULL
+ * @return true if woken by a notification, false at the release
+ */
+bool periodic_wait_notify(periodic_task_t *task, uint32_t clear_bits, uint32_t *notified);
+
+/**
+ * @brief Get the number of registered periodic tasks
+ * @return Registered tasks; valid indexes are 0 to count - 1
+ */
+uint32_t periodic_get_task_count(void);
+
+/**
+ * @brief Copy the statistics of one periodic task
+ *
+ * Each counter is read atomically; counters may be one cycle apart.
+ *
+ * @param index Task index
+ * @param stats Receives the statistics
+ * @return false if the index is not registered
+ */
+bool periodic_get_stats(uint32_t index, periodic_stats_t *stats);
+
+/**
+ * @brief Get the upper limit of a histogram bucket
+ * @param bucket Bucket index
+ * @return Exclusive limit in microseconds; UINT32_MAX for the last bucket
+ */
+uint32_t periodic_get_bucket_limit_us(uint32_t bucket);
+
+/**
+ * @brief Format the statistics of all periodic tasks as text
+ * @param buffer Output buffer
+ * @param buffer_size Size of the buffer
+ * @return Number of characters written (excluding the terminator)
+ */
+int periodic_format(char *buffer, size_t buffer_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERIODIC_H */
@@ -0,0 +1,74 @@
+/**
+ * @file sensor_monitor.h
+ * @brief Sensor monitoring task for FACP iZone
+ * 
+ * The sensor monitor runs on Core 0 and turns zone input events into
+ * zone and system status, drives the zone alarm outputs from the
+ * verified status (alarm_output.h), and reduces the analog sample blocks. It blocks on its task notification and only
+ * runs when an input source signals new data.
+ * 
+ * Fire alarms latch in the zone table: the outputs and fire LEDs stay
+ * on after the fire input clears, until sensor_monitor_reset_alarms().
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef SENSOR_MONITOR_H
+#define SENSOR_MONITOR_H
+
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "system_init.h"
+#include "adc_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Zones served by the optocoupler inputs of one zone card */
+#define SENSOR_MONITOR_INPUT_ZONES  2
+#define SENSOR_MONITOR_ZONE_MASK    ((1UL << SENSOR_MONITOR_INPUT_ZONES) - 1u)  /* Zone table word 0 */
+
+/* Notification bit for a pending alarm reset, after the input and ADC bits */
+#define SENSOR_MONITOR_RESET_NOTIFY_BIT (ADC_STREAM_NOTIFY_BIT << 1)
+
+/* Longest sleep without input, so the task still checks in with the supervisor */
+#define SENSOR_MONITOR_IDLE_WAKE_MS 100
+
+/**
+ * @brief Get the handle of the sensor monitor task
+ * @return Task handle, or NULL before the task table created it
+ */
+TaskHandle_t sensor_monitor_get_task(void);
+
+/**
+ * @brief Get the status of an input zone as last seen by the monitor
+ * @param zone Zone index (0 to SENSOR_MONITOR_INPUT_ZONES - 1)
+ * @return Zone status
+ */
+zone_status_t sensor_monitor_get_zone_status(uint32_t zone);
+
+/**
+ * @brief Reset latched fire alarms (panel reset)
+ * 
+ * Any task. The sensor monitor clears the zones at its next wake-up and
+ * releases their outputs; a zone whose fire input is still active
+ * stays in alarm.
+ * 
+ * @param zones Zone bits (bit 0 = zone 1)
+ */
+void sensor_monitor_reset_alarms(uint32_t zones);
+
+/**
+ * @brief Sensor monitor task function (see task_table.h)
+ * @param pvParameters Task parameters (unused)
+ */
+void vSensorMonitorTask(void *pvParameters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSOR_MONITOR_H */
@@ -34,6 +34,7 @@ extern "C" {
  * - System diagnostics
  */
 
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
 /**
  * @brief Create a task with specified core affinity
  * 
@@ -58,63 +59,7 @@ BaseType_t xTaskCreateWithAffinity(
     TaskHandle_t * const pxCreatedTask,
     UBaseType_t uxCoreAffinityMask
 );
-
-/**
- * @brief Create a fire safety sensor monitoring task
- * 
- * Creates a task optimized for time-critical sensor monitoring operations
- * with affinity to Core 0 for deterministic response times.
- * 
- * @param pxTaskCode Task function pointer
- * @param pcName Task name string  
- * @param pvParameters Task parameters
- * @param pxCreatedTask Task handle (can be NULL)
- * @return pdPASS if successful, error code if failed
- */
-BaseType_t xCreateSensorTask(
-    TaskFunction_t pxTaskCode,
-    const char * const pcName,
-    void * const pvParameters,
-    TaskHandle_t * const pxCreatedTask
-);
-
-/**
- * @brief Create a communication task
- * 
- * Creates a task optimized for I2C/GSM communication operations
- * with affinity to Core 1 to avoid interference with sensor timing.
- * 
- * @param pxTaskCode Task function pointer
- * @param pcName Task name string
- * @param pvParameters Task parameters  
- * @param pxCreatedTask Task handle (can be NULL)
- * @return pdPASS if successful, error code if failed
- */
-BaseType_t xCreateCommunicationTask(
-    TaskFunction_t pxTaskCode,
-    const char * const pcName,
-    void * const pvParameters,
-    TaskHandle_t * const pxCreatedTask
-);
-
-/**
- * @brief Create an alarm control task
- * 
- * Creates a task optimized for time-critical alarm control operations
- * with affinity to Core 0 for immediate response capability.
- * 
- * @param pxTaskCode Task function pointer
- * @param pcName Task name string
- * @param pvParameters Task parameters
- * @param pxCreatedTask Task handle (can be NULL)
- * @return pdPASS if successful, error code if failed
- */
-BaseType_t xCreateAlarmTask(
-    TaskFunction_t pxTaskCode,
-    const char * const pcName,
-    void * const pvParameters,
-    TaskHandle_t * const pxCreatedTask
-);
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 
 /**
  * @brief Get the current core number for the calling task
@@ -127,10 +72,11 @@ BaseType_t xCreateAlarmTask(
 uint32_t ulGetCurrentCore(void);
 
 /**
- * @brief Print SMP status and task distribution
+ * @brief Log SMP status and task distribution
  * 
- * Outputs debug information about current task distribution across cores
- * and SMP configuration status. Useful for system monitoring and debugging.
+ * Writes the SMP configuration and the core affinity masks as log
+ * records, like every other task-side output; before the scheduler
+ * starts they wait in the log ring for the drain task.
  */
 void vPrintSMPStatus(void);
 
@@ -145,14 +91,13 @@ void vPrintSMPStatus(void);
 BaseType_t xValidateSMPConfiguration(void);
 
 /**
- * @brief Create SMP test tasks for demonstration
+ * @brief SMP demonstration task (see task_table.h)
  * 
- * Creates test tasks to demonstrate and validate SMP functionality.
- * Used for system validation and debugging.
+ * Reports which core it runs on every period.
  * 
- * @return pdTRUE if all test tasks created successfully, pdFALSE otherwise
+ * @param pvParameters Task label string
  */
-BaseType_t xCreateSMPTestTasks(void);
+void vSMPTestTask(void *pvParameters);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,95 @@
+/**
+ * @file stack_monitor.h
+ * @brief Task stack high-water monitoring for FACP iZone
+ *
+ * stack_monitor_update() samples the stack high-water mark of every task
+ * and logs a warning the first time a task's unused stack falls below
+ * STACK_MONITOR_WARN_WORDS. The report can be read from either core.
+ *
+ * STACK_INFO_RECORD() records a task entry function and its stack size in
+ * the non-loaded .facp_stackinfo section (config/stack_info.ld), where
+ * tools/stack_analysis.py finds the tasks whose worst-case depth it
+ * checks after every RP2040 build.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef STACK_MONITOR_H
+#define STACK_MONITOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STACK_MONITOR_MAX_TASKS     24  /* Tasks tracked per report */
+#define STACK_MONITOR_WARN_WORDS    64  /* Warn below this many unused words */
+#define STACK_MONITOR_PERIOD_S      10  /* System monitor sampling interval */
+
+#define STACK_INFO_NAME_LEN         28  /* Records are 32 bytes */
+
+/* One record of .facp_stackinfo, read by tools/stack_analysis.py */
+typedef struct {
+    char function[STACK_INFO_NAME_LEN];
+    uint32_t stack_bytes;
+} stack_info_t;
+
+#if defined(FACP_HOST_BUILD)
+#define STACK_INFO_RECORD(tag, function, words)                                         \
+    _Static_assert(1, #tag)
+#else
+#define STACK_INFO_RECORD(tag, function, words)                                         \
+    static const stack_info_t xStackInfo_##tag                                          \
+        __attribute__((section(".facp_stackinfo"), used)) = {                           \
+        #function, (uint32_t)((words) * sizeof(StackType_t))                            \
+    };                                                                                  \
+    _Static_assert(sizeof(#function) <= STACK_INFO_NAME_LEN, #function ": name too long")
+#endif
+
+/* Stack usage of one task */
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t stack_words;           /* Configured size; 0 if not known */
+    uint32_t unused_min_words;      /* Least unused stack since the task started */
+} stack_monitor_task_t;
+
+/**
+ * @brief Sample the high-water marks of all tasks
+ *
+ * Call periodically from one task (the system monitor calls it every
+ * STACK_MONITOR_PERIOD_S seconds).
+ */
+void stack_monitor_update(void);
+
+/**
+ * @brief Get the last sample
+ * @param tasks Receives up to max_tasks entries
+ * @param max_tasks Capacity of tasks
+ * @return Number of entries written
+ */
+uint32_t stack_monitor_get_tasks(stack_monitor_task_t *tasks, uint32_t max_tasks);
+
+/**
+ * @brief Get the least unused stack of any task in the last sample
+ * @return Words, or UINT32_MAX before the first sample
+ */
+uint32_t stack_monitor_get_min_unused(void);
+
+/**
+ * @brief Format the last sample as text
+ * @param buffer Output buffer
+ * @param buffer_size Size of the buffer
+ * @return Number of characters written (excluding the terminator)
+ */
+int stack_monitor_format(char *buffer, size_t buffer_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STACK_MONITOR_H */
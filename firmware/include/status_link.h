@@ -0,0 +1,179 @@
+/**
+ * @file status_link.h
+ * @brief I2C1 slave register map serving the zone card status frame
+ *
+ * The building controller polls each zone card on I2C1 (GPIO2/3) at
+ * g_system_config.device_address. Writing one byte sets the register
+ * offset, which stays until the next write (0 after start-up); every
+ * read starts at the offset in the current status frame, and bytes past
+ * the frame read as 0xFF. A read from offset 0 of
+ * STATUS_LINK_FRAME_BYTES returns one consistent, CRC'd frame.
+ *
+ * Register 0 is a change counter. It steps whenever the zone, system or
+ * output state in the frame changes, and at least every
+ * STATUS_LINK_FORCED_REFRESH_MS so the health fields and anything
+ * silently corrupted at the master get read again. A master that leaves
+ * the offset at 0 can poll with a one-byte read and fetch the frame only
+ * when the counter differs from the last one it saw.
+ *
+ * A state change (not a forced refresh) also pulls the wired-OR
+ * attention line (BOARD_PIN_EXPANSION_OUT, open drain, low = asserted)
+ * so the master can scan at once instead of at its next poll. The card
+ * releases it when a read from register 0 returns the counter of that
+ * change.
+ *
+ * Frames are double buffered. The sensor monitor builds the next frame
+ * in the idle buffer and publishes it by flipping the buffer index; the
+ * slave back end latches the index at the start of a transaction and
+ * serves the whole transaction from that buffer with DMA, so no task
+ * runs and nothing is copied per transaction. A buffer still being
+ * served is never rebuilt: the publish is deferred to the next call.
+ *
+ * The buffers hold one 16-bit I2C DATA_CMD word per frame byte, the
+ * form the TX DMA writes, so widening happens once per publish rather
+ * than once per read.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef STATUS_LINK_H
+#define STATUS_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "board_pins.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STATUS_LINK_BAUDRATE        400000
+#define STATUS_LINK_FRAME_VERSION   2
+#define STATUS_LINK_REFRESH_MS      100     /* Longest gap between publishes */
+#define STATUS_LINK_FORCED_REFRESH_MS 5000  /* Longest gap between change counter steps */
+#define STATUS_LINK_FILL_BYTE       0xFFu   /* Served past the end of the frame */
+
+/*
+ * Status frame, little-endian; the register offset is the byte offset.
+ * crc is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, crc16_ccitt() in
+ * crc.h) over all bytes before it.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t change;                     /* 0x00 Change counter */
+    uint8_t version;                    /* 0x01 STATUS_LINK_FRAME_VERSION */
+    uint16_t sequence;                  /* 0x02 Publish count */
+    uint32_t uptime_ms;                 /* 0x04 Time of the publish */
+    uint8_t system_status;              /* 0x08 system_status_t */
+    uint8_t zone_count;                 /* 0x09 Configured zones */
+    uint8_t alarm;                      /* 0x0A Input zones in alarm, bit 0 = zone 1 */
+    uint8_t fault;                      /* 0x0B Input zones in fault */
+    uint8_t disabled;                   /* 0x0C Disabled input zones */
+    uint8_t outputs;                    /* 0x0D Asserted alarm outputs */
+    uint8_t overdue_tasks;              /* 0x0E Supervised tasks past their deadline */
+    uint8_t length;                     /* 0x0F STATUS_LINK_FRAME_BYTES */
+    uint16_t cpu_load_permille[2];      /* 0x10 Per core, last second */
+    uint16_t heap_free_bytes;           /* 0x14 Saturated at 65535 */
+    uint16_t stack_min_unused_words;    /* 0x16 Least unused stack of any task */
+    uint16_t pool_exhausted;            /* 0x18 Message pool allocations that failed */
+    uint16_t deadline_misses;           /* 0x1A Periodic task overruns */
+    uint16_t crc;                       /* 0x1C */
+} status_link_frame_t;
+
+#define STATUS_LINK_FRAME_BYTES     ((uint32_t)sizeof(status_link_frame_t))
+
+/* Health fields, refreshed by the system monitor once a second */
+typedef struct {
+    uint8_t overdue_tasks;
+    uint16_t cpu_load_permille[2];
+    uint16_t heap_free_bytes;
+    uint16_t stack_min_unused_words;
+    uint16_t pool_exhausted;
+    uint16_t deadline_misses;
+} status_link_health_t;
+
+/* Link counters */
+typedef struct {
+    uint32_t publishes;
+    uint32_t deferred;                  /* Publishes skipped: buffer being served */
+    uint32_t reads;                     /* Read transactions */
+    uint32_t offset_writes;             /* Register offset writes */
+    uint32_t attentions;                /* Attention line assertions */
+} status_link_stats_t;
+
+/**
+ * @brief Publish the first frame and start the I2C1 slave
+ *
+ * The slave interrupt is serviced on the calling core.
+ *
+ * @param address 7-bit slave address
+ * @return true if the slave is running
+ */
+bool status_link_start(uint8_t address);
+
+/**
+ * @brief Build and publish a frame from the current status
+ *
+ * Single publisher (the sensor monitor).
+ *
+ * @return false if deferred because the idle buffer is still being served
+ */
+bool status_link_publish(void);
+
+/**
+ * @brief Replace the health fields of the next frame
+ * @param health Health fields
+ */
+void status_link_set_health(const status_link_health_t *health);
+
+/**
+ * @brief Copy the link counters
+ * @param stats Receives the counters
+ */
+void status_link_get_stats(status_link_stats_t *stats);
+
+/* Slave back end: DMA engine on the RP2040, a simulated device on the host */
+
+/**
+ * @brief Configure I2C1 as a slave and enable its interrupt
+ * @param address 7-bit slave address
+ * @return true if the slave is running
+ */
+bool status_link_hw_start(uint8_t address);
+
+/**
+ * @brief Drive the attention line
+ *
+ * Called from the publisher and from the slave interrupt.
+ *
+ * @param asserted true to pull the line low, false to release it
+ */
+void status_link_hw_set_attention(bool asserted);
+
+/**
+ * @brief Set the register offset from the first written byte
+ * @param offset Register offset
+ */
+void status_link_set_offset_from_isr(uint8_t offset);
+
+/**
+ * @brief Latch the frame for the current transaction and get the words to send
+ *
+ * The first call of a transaction latches the published buffer; later
+ * calls return the same buffer.
+ *
+ * @param words Receives the number of words from the offset to the end
+ * @return First DATA_CMD word to send, or NULL past the end of the frame
+ */
+const uint16_t *status_link_begin_read_from_isr(uint32_t *words);
+
+/**
+ * @brief End a transaction and release its buffer
+ */
+void status_link_end_from_isr(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STATUS_LINK_H */
@@ -0,0 +1,136 @@
+/**
+ * @file status_snapshot.h
+ * @brief Cross-core system and zone status snapshot
+ * 
+ * The system status and the zone status masks are published together as
+ * one sequence-numbered snapshot behind a seqlock. Writers serialise on
+ * a hardware spinlock and publish in constant time; readers on either
+ * core take no lock and simply retry if a write overlapped their copy.
+ * 
+ * Tasks that need to react to status changes subscribe with a
+ * notification bit instead of polling.
+ * 
+ * A system fault that no zone reflects (a configuration integrity
+ * failure) is latched here and folded into every status publish, so a
+ * status derived from the zones never downgrades it to normal.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef STATUS_SNAPSHOT_H
+#define STATUS_SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "system_init.h"
+#include "zone_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STATUS_SNAPSHOT_MAX_SUBSCRIBERS 4
+
+typedef struct {
+    uint32_t sequence;                  /* Even; advances by 2 per publish */
+    uint32_t timestamp_ms;              /* Time of the publish */
+    system_status_t system;
+    uint32_t alarm[ZONE_MASK_WORDS];
+    uint32_t fault[ZONE_MASK_WORDS];
+    uint32_t disabled[ZONE_MASK_WORDS];
+} status_snapshot_t;
+
+/**
+ * @brief Claim the writer spinlock and publish the initial snapshot
+ */
+void status_snapshot_init(void);
+
+/**
+ * @brief Notify a task on every published change
+ * @param xTask Subscriber task
+ * @param notify_bits Bits set on the task's notification value
+ * @return true if subscribed, false if the subscriber table is full
+ */
+bool status_snapshot_subscribe(TaskHandle_t xTask, uint32_t notify_bits);
+
+/**
+ * @brief Copy a consistent snapshot
+ * @param snapshot Receives the snapshot
+ * @return Sequence number of the copied snapshot
+ */
+uint32_t status_snapshot_read(status_snapshot_t *snapshot);
+
+/**
+ * @brief Get the published system status
+ * @return System status (a single word; no retry needed)
+ */
+system_status_t status_snapshot_get_system(void);
+
+/**
+ * @brief Get the current publish sequence number
+ * @return Sequence number, odd while a publish is in progress
+ */
+uint32_t status_snapshot_get_sequence(void);
+
+/**
+ * @brief Publish a new system status
+ * 
+ * A latched fault overrides SYSTEM_STATUS_NORMAL.
+ * 
+ * @param status New system status
+ * @return true if the status changed and subscribers were notified
+ */
+bool status_snapshot_set_system(system_status_t status);
+
+/**
+ * @brief Latch a system fault until the next restart
+ * 
+ * From now on a normal status is published as SYSTEM_STATUS_FAULT;
+ * alarm and test mode still take precedence.
+ * 
+ * @return true if the status changed and subscribers were notified
+ */
+bool status_snapshot_latch_fault(void);
+
+/**
+ * @brief Publish the zone table masks and the status derived from them
+ * 
+ * derived is applied unless the system is in test mode; both happen in
+ * the same publish, so readers never see zones and status disagree. A
+ * latched fault turns a normal derived status into a fault.
+ * 
+ * @param derived System status derived from the zones
+ * @return true if anything changed and subscribers were notified
+ */
+bool status_snapshot_publish_zones(system_status_t derived);
+
+/**
+ * @brief Publish explicit zone masks and the status derived from them
+ * @param alarm Alarm mask words (ZONE_MASK_WORDS)
+ * @param fault Fault mask words
+ * @param disabled Disabled mask words
+ * @param derived System status, applied unless in test mode
+ *                (a latched fault overrides normal)
+ * @return true if anything changed and subscribers were notified
+ */
+bool status_snapshot_publish_masks(const uint32_t *alarm, const uint32_t *fault,
+                                   const uint32_t *disabled, system_status_t derived);
+
+/**
+ * @brief Publish a system status from a fatal error hook
+ * 
+ * Safe with the scheduler stopped or interrupts disabled; subscribers
+ * are not notified.
+ * 
+ * @param status New system status
+ */
+void status_snapshot_set_system_from_fatal(system_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STATUS_SNAPSHOT_H */
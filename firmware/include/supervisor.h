@@ -0,0 +1,92 @@
+/**
+ * @file supervisor.h
+ * @brief Task liveness supervisor and watchdog feeding for FACP iZone
+ *
+ * Critical tasks register with a deadline and call supervisor_heartbeat()
+ * at least that often. The heartbeat is a single counter store in the
+ * task's own slot, so it is lock-free and safe from either core. The
+ * system monitor calls supervisor_check() every SUPERVISOR_PERIOD_MS and
+ * the hardware watchdog is fed only while every registered task has
+ * beaten within its deadline; a stalled task therefore resets the panel
+ * within its deadline plus TIMEOUT_WATCHDOG_RESET_MS. The first task
+ * found overdue is kept in the watchdog scratch registers and reported
+ * after the reboot.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUPERVISOR_MAX_TASKS        8
+#define SUPERVISOR_PERIOD_MS        50      /* Check and feed rate: 20 Hz */
+#define SUPERVISOR_INVALID_ID       (-1)
+
+typedef int32_t supervisor_id_t;
+
+/* Liveness record of one registered task */
+typedef struct {
+    const char *name;
+    uint32_t deadline_ms;           /* Longest allowed gap between heartbeats */
+    uint32_t beats;                 /* Heartbeats so far */
+    uint32_t last_beat_ms;          /* When the supervisor last saw a new beat */
+    uint32_t overruns;              /* Deadline misses */
+    uint32_t worst_gap_ms;          /* Longest gap seen while overdue */
+    bool overdue;                   /* Currently past its deadline */
+} supervisor_task_status_t;
+
+/**
+ * @brief Reset the task table and report a supervised watchdog reboot
+ */
+void supervisor_init(void);
+
+/**
+ * @brief Register the calling task for supervision
+ * @param name Task name (must outlive the registration)
+ * @param deadline_ms Longest allowed gap between heartbeats
+ * @return Heartbeat ID, or SUPERVISOR_INVALID_ID if the table is full
+ */
+supervisor_id_t supervisor_register(const char *name, uint32_t deadline_ms);
+
+/**
+ * @brief Record that a registered task is alive
+ * @param id ID from supervisor_register()
+ */
+void supervisor_heartbeat(supervisor_id_t id);
+
+/**
+ * @brief Check all deadlines and feed the watchdog if every task is alive
+ *
+ * Cost is bounded by SUPERVISOR_MAX_TASKS. Call from one task only.
+ *
+ * @return true if the watchdog was fed
+ */
+bool supervisor_check(void);
+
+/**
+ * @brief Get the liveness record of one task
+ * @param id ID from supervisor_register()
+ * @param status Receives the record
+ * @return false if the ID is not registered
+ */
+bool supervisor_get_status(supervisor_id_t id, supervisor_task_status_t *status);
+
+/**
+ * @brief Get the number of registered tasks
+ * @return Registered tasks; valid IDs are 0 to count - 1
+ */
+uint32_t supervisor_get_task_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SUPERVISOR_H */
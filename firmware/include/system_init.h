@@ -30,7 +30,12 @@
 
 /* Hardware configuration */
 #define HARDWARE_VERSION        "RP2040-Zero Fire Safety v1.0"
-#define MAX_ZONES               4    /* Maximum number of fire zones supported */
+
+/* Maximum number of fire zones supported; set with -DFACP_MAX_ZONES=<n> */
+#ifndef FACP_MAX_ZONES
+#define FACP_MAX_ZONES          32
+#endif
+#define MAX_ZONES               FACP_MAX_ZONES
 
 /* System status definitions */
 typedef enum {
@@ -51,14 +56,19 @@ typedef enum {
 
 /* System configuration structure */
 typedef struct {
-    uint8_t zone_count;                 /* Number of configured zones */
+    uint16_t zone_count;                /* Number of configured zones */
     uint8_t device_address;             /* I2C slave address */
     bool watchdog_enabled;              /* Watchdog timer enable flag */
-    uint16_t sensor_threshold[MAX_ZONES]; /* Sensor trigger thresholds */
+    bool input_filter_enabled;          /* Use the PIO glitch filter on zone inputs */
+    uint32_t input_filter_sample_hz;    /* Zone input sample rate */
+    uint8_t input_filter_confirm_samples; /* Consecutive samples to accept a change */
+    bool alarm_fast_path_enabled;       /* Filter interrupt asserts alarm outputs directly */
+    uint32_t adc_sample_hz;             /* Analog frames per second, per channel */
+    uint8_t adc_oversample;             /* Conversions averaged per reading */
+    bool adc_temp_sensor_enabled;       /* Also sample the ADC4 temperature sensor */
 } system_config_t;
 
-/* Global system variables */
-extern system_status_t g_system_status;
+/* Global system variables; the system status lives in status_snapshot.h */
 extern system_config_t g_system_config;
 
 /* Function prototypes */
@@ -68,6 +78,29 @@ extern system_config_t g_system_config;
  */
 void system_config_init(void);
 
+/**
+ * @brief Seal the configuration after changing it
+ *
+ * Stores its CRC-32 for system_config_check().
+ */
+void system_config_seal(void);
+
+/**
+ * @brief Check the configuration against its seal
+ * @return true if unchanged since the last system_config_seal()
+ */
+bool system_config_check(void);
+
+/**
+ * @brief Check the DMA sniffer CRC against the CPU on the configuration
+ *
+ * One-shot start-up check: claims a DMA channel for the sniffer, computes
+ * the configuration's CRC-32 with it and releases the channel again.
+ *
+ * @return true if the sniffer agrees with the seal, or no channel was free
+ */
+bool system_config_check_dma(void);
+
 /**
  * @brief Get current system status
  * @return Current system status
@@ -75,7 +108,7 @@ void system_config_init(void);
 system_status_t system_get_status(void);
 
 /**
- * @brief Set system status
+ * @brief Set system status and notify status subscribers
  * @param status New system status
  */
 void system_set_status(system_status_t status);
@@ -88,6 +121,12 @@ void system_set_status(system_status_t status);
  */
 int system_get_version_string(char *buffer, size_t buffer_size);
 
+/**
+ * @brief Get the free kernel heap
+ * @return Free heap in bytes; 0 in the static allocation build, which has no heap
+ */
+size_t system_get_free_heap(void);
+
 /**
  * @brief Perform system self-test
  * @return true if all tests passed, false otherwise
@@ -127,7 +166,7 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName);
  */
 void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
                                    StackType_t **ppxIdleTaskStackBuffer,
-                                   uint32_t *pulIdleTaskStackSize);
+                                   configSTACK_DEPTH_TYPE *pulIdleTaskStackSize);
 
 /**
  * @brief Get timer task memory (static allocation)
@@ -137,6 +176,6 @@ void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
  */
 void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
                                     StackType_t **ppxTimerTaskStackBuffer,
-                                    uint32_t *pulTimerTaskStackSize);
+                                    configSTACK_DEPTH_TYPE *pulTimerTaskStackSize);
 
 #endif /* SYSTEM_INIT_H */ 
\ No newline at end of file
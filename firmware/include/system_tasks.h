@@ -0,0 +1,42 @@
+/**
+ * @file system_tasks.h
+ * @brief System monitor and status LED tasks for FACP iZone
+ * 
+ * Both tasks are created from the task table (task_table.h).
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef SYSTEM_TASKS_H
+#define SYSTEM_TASKS_H
+
+#include "board_pins.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Pin definitions based on RP2040-Zero and custom hardware */
+#define LED_STATUS_PIN      25      /* Built-in LED on RP2040-Zero */
+#define LED_POWER_PIN       BOARD_PIN_LED_POWER     /* Power status LED */
+#define LED_NORMAL_PIN      BOARD_PIN_LED_NORMAL    /* Normal operation LED */
+#define LED_FAULT_PIN       BOARD_PIN_LED_FAULT_1   /* Fault status LED */
+
+/**
+ * @brief System monitor task: liveness supervisor and health report
+ * @param pvParameters Task parameters (unused)
+ */
+void vSystemMonitorTask(void *pvParameters);
+
+/**
+ * @brief Status LED task: heartbeat blink and status LEDs
+ * @param pvParameters Task parameters (unused)
+ */
+void vStatusLedTask(void *pvParameters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYSTEM_TASKS_H */
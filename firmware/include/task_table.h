@@ -0,0 +1,124 @@
+/**
+ * @file task_table.h
+ * @brief Static task table for FACP iZone
+ *
+ * Every application task is one row of FACP_TASK_TABLE: function, name,
+ * stack, priority, core affinity, parameter and period. The table is the
+ * single place where scheduling is tuned; stacks and TCBs are static
+ * storage generated from it, and task_table.c checks the per-core RAM
+ * budget and the priority ordering at compile time. task_table_start()
+ * creates every task in table order before the scheduler starts.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef TASK_TABLE_H
+#define TASK_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * X(id, function, name, stack words, priority, core affinity, parameter, period ms)
+ * Period 0 marks an event-driven task.
+ */
+#define FACP_TASK_TABLE(X)                                                                  \
+    X(SYSTEM_MONITOR, vSystemMonitorTask, "SysMonitor",                                     \
+      TASK_STACK_SIZE_WATCHDOG, TASK_PRIORITY_WATCHDOG, TASK_CORE_AFFINITY_WATCHDOG,        \
+      NULL, SUPERVISOR_PERIOD_MS)                                                           \
+    X(SENSOR_MONITOR, vSensorMonitorTask, "SensorMon",                                      \
+      TASK_STACK_SIZE_SENSOR_MONITOR, TASK_PRIORITY_SENSOR_MONITOR,                         \
+      TASK_CORE_AFFINITY_SENSOR_MONITOR, NULL, 0)                                           \
+    X(STATUS_LED, vStatusLedTask, "LED_Blink",                                              \
+      TASK_STACK_SIZE_STATUS_LED, TASK_PRIORITY_STATUS_LED, TASK_CORE_AFFINITY_STATUS_LED,  \
+      NULL, TASK_PERIOD_MS_STATUS_LED)                                                      \
+    X(SMP_TEST_CORE0, vSMPTestTask, "SMPTest_Core0",                                        \
+      TASK_STACK_SIZE_SMP_TEST, TASK_PRIORITY_SMP_TEST, CORE_AFFINITY_SENSORS,              \
+      "Core0_Test", TASK_PERIOD_MS_SMP_TEST)                                                \
+    X(SMP_TEST_CORE1, vSMPTestTask, "SMPTest_Core1",                                        \
+      TASK_STACK_SIZE_SMP_TEST, TASK_PRIORITY_SMP_TEST, CORE_AFFINITY_COMMUNICATION,        \
+      "Core1_Test", TASK_PERIOD_MS_SMP_TEST)                                                \
+    X(LOG_DRAIN, vLogDrainTask, "LogDrain",                                                 \
+      TASK_STACK_SIZE_LOG_DRAIN, TASK_PRIORITY_LOG_DRAIN, TASK_CORE_AFFINITY_LOG_DRAIN,     \
+      NULL, LOG_DRAIN_PERIOD_MS)                                                            \
+    FACP_CONTROLLER_TASK_TABLE(X)
+
+/* Rows of building controller builds only (FACP_BUILDING_CONTROLLER) */
+#if FACP_BUILDING_CONTROLLER
+#define FACP_CONTROLLER_TASK_TABLE(X)                                                       \
+    X(CARD_POLLER, vCardPollerTask, "CardPoller",                                           \
+      TASK_STACK_SIZE_COMMUNICATION, TASK_PRIORITY_COMMUNICATION,                           \
+      TASK_CORE_AFFINITY_COMMUNICATION, NULL, CARD_POLLER_HOT_MS)
+#else
+#define FACP_CONTROLLER_TASK_TABLE(X)
+#endif
+
+typedef enum {
+#define TASK_TABLE_ID(id, task, label, words, prio, mask, arg, period) \
+    TASK_ID_##id,
+    FACP_TASK_TABLE(TASK_TABLE_ID)
+#undef TASK_TABLE_ID
+    TASK_ID_COUNT
+} task_id_t;
+
+/* One row of the table */
+typedef struct {
+    TaskFunction_t function;
+    const char *name;
+    configSTACK_DEPTH_TYPE stack_words;
+    UBaseType_t priority;
+    UBaseType_t affinity;
+    void *parameter;
+    uint32_t period_ms;
+    StackType_t *stack;
+    StaticTask_t *tcb;
+} task_descriptor_t;
+
+/**
+ * @brief Create every task in the table
+ *
+ * Call once, before vTaskStartScheduler(). Stops at the first failure.
+ *
+ * @return true if all tasks were created
+ */
+bool task_table_start(void);
+
+/**
+ * @brief Create a single task from the table (host benchmarks)
+ * @param id Task to create
+ * @return true if the task was created
+ */
+bool task_table_create(task_id_t id);
+
+/**
+ * @brief Get the descriptor of a task
+ * @param id Task ID
+ * @return Descriptor, or NULL for an invalid ID
+ */
+const task_descriptor_t *task_table_get(task_id_t id);
+
+/**
+ * @brief Get the descriptor of the calling task
+ * @return Descriptor, or NULL if the caller is not a table task
+ */
+const task_descriptor_t *task_table_self(void);
+
+/**
+ * @brief Get the handle of a created task
+ * @param id Task ID
+ * @return Task handle, or NULL before the task is created
+ */
+TaskHandle_t task_table_get_handle(task_id_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_TABLE_H */
@@ -0,0 +1,94 @@
+/**
+ * @file trace.h
+ * @brief Kernel and ISR event trace recorder for FACP iZone
+ *
+ * Built with -DFACP_TRACE=ON, the FreeRTOS trace macros in
+ * config/trace_hooks.h record task switches, queue/semaphore/mutex
+ * operations, notifications and priority inheritance, and firmware ISRs
+ * mark their entry and exit with TRACE_ISR_ENTER/EXIT. Each event is an
+ * 8-byte record with a microsecond timestamp in a ring owned by the
+ * core it happened on; the rings keep the newest events. trace_dump()
+ * prints them as "TRACE" text lines that tools/trace_convert.py turns
+ * into a Perfetto trace. Without FACP_TRACE all of this compiles out.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "trace_hooks.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef TRACE_RING_EVENTS
+#define TRACE_RING_EVENTS           1024    /* Per core, power of two */
+#endif
+
+/* Firmware interrupt handlers, named in the dump */
+typedef enum {
+    TRACE_ISR_ZONE_GPIO = 1,                /* Zone input edge (GPIO bank 0) */
+    TRACE_ISR_ZONE_PIO,                     /* Zone glitch filter RX FIFO */
+    TRACE_ISR_ADC_DMA,                      /* ADC stream block complete */
+    TRACE_ISR_STATUS_LINK,                  /* I2C1 slave events */
+    TRACE_ISR_CARD_POLLER,                  /* I2C1 master transaction end */
+    TRACE_ISR_CARD_ATTENTION,               /* Zone card attention line edge */
+    TRACE_ISR_COUNT
+} trace_isr_t;
+
+/* One recorded event */
+typedef struct {
+    uint32_t timestamp_us;                  /* Low 32 bits of time_us_64() */
+    uint8_t type;                           /* TRACE_EVT_* */
+    uint8_t arg;
+    uint16_t id;
+} trace_event_t;
+
+#if FACP_TRACE
+#define TRACE_ISR_ENTER(isr)        trace_record(TRACE_EVT_ISR_ENTER, 0, (uint16_t)(isr))
+#define TRACE_ISR_EXIT(isr)         trace_record(TRACE_EVT_ISR_EXIT, 0, (uint16_t)(isr))
+/* Alarm output change (alarm_output_source_t); latency saturates at 65535 us */
+#define TRACE_ALARM_OUTPUT(zone, source, latency_us)                            \
+    trace_record(TRACE_EVT_ALARM_OUTPUT, (uint8_t)((zone) | ((uint32_t)(source) << 4)), \
+                 (uint16_t)(((latency_us) > 0xFFFFu) ? 0xFFFFu : (latency_us)))
+#else
+#define TRACE_ISR_ENTER(isr)        ((void)0)
+#define TRACE_ISR_EXIT(isr)         ((void)0)
+#define TRACE_ALARM_OUTPUT(zone, source, latency_us) ((void)0)
+#endif
+
+/**
+ * @brief Resume recording (recording is on from boot)
+ */
+void trace_start(void);
+
+/**
+ * @brief Freeze the rings so their contents can be dumped
+ */
+void trace_stop(void);
+
+/**
+ * @brief Print the task table and both rings, then resume recording
+ *
+ * Call from a task. The rings are frozen while they are printed.
+ */
+void trace_dump(void);
+
+/**
+ * @brief Print the rings from a fatal error hook
+ *
+ * Skips the task table, which needs the scheduler; the converter names
+ * tasks by number instead.
+ */
+void trace_panic_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_H */
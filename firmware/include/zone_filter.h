@@ -0,0 +1,95 @@
+/**
+ * @file zone_filter.h
+ * @brief PIO glitch filter for the zone inputs and its C model
+ * 
+ * A PIO state machine samples GPIO4-7 at a configurable rate and only
+ * reports a new input state after a configurable number of consecutive
+ * samples agree on it. The sensor core then handles one event per real
+ * transition instead of every noisy edge.
+ * 
+ * zone_filter_model_step() reproduces the PIO program sample by sample,
+ * including the event word it pushes, so thresholds can be evaluated on
+ * the host against recorded noise traces.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef ZONE_FILTER_H
+#define ZONE_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZONE_FILTER_INPUT_COUNT             4
+#define ZONE_FILTER_INPUT_MASK              0xFu
+#define ZONE_FILTER_CYCLES_PER_SAMPLE       11   /* PIO cycles per sampling loop */
+#define ZONE_FILTER_MAX_CONFIRM_SAMPLES     32   /* Limited by the OSR shift count */
+
+/* Default filter parameters */
+#define ZONE_FILTER_DEFAULT_SAMPLE_HZ       10000
+#define ZONE_FILTER_DEFAULT_CONFIRM_SAMPLES 8
+
+/* Event word fields */
+#define ZONE_FILTER_EVENT_NEW_STATE(w)      ((w) & ZONE_FILTER_INPUT_MASK)
+#define ZONE_FILTER_EVENT_OLD_STATE(w)      (((w) >> 4) & ZONE_FILTER_INPUT_MASK)
+
+/* C model of the PIO filter state machine */
+typedef struct {
+    uint32_t stable;                    /* X register: stable state in every nibble */
+    uint32_t candidate;                 /* Y register: (stable << 4) | candidate state */
+    uint32_t count;                     /* OSR shift count */
+    uint32_t confirm_samples;           /* PULL_THRESH */
+    bool confirming;                    /* Executing the confirm loop */
+    bool started;                       /* Initial state has been pushed */
+} zone_filter_model_t;
+
+/**
+ * @brief Reset the filter model
+ * @param model Model state
+ * @param confirm_samples Consecutive agreeing samples needed (1-32)
+ */
+void zone_filter_model_init(zone_filter_model_t *model, uint32_t confirm_samples);
+
+/**
+ * @brief Feed one input sample to the filter model
+ * @param model Model state
+ * @param sample Input pin levels (bits 3:0)
+ * @param event_word Receives the word the PIO program would push
+ * @return true if an event word was produced
+ */
+bool zone_filter_model_step(zone_filter_model_t *model, uint32_t sample,
+                            uint32_t *event_word);
+
+/**
+ * @brief Load the filter program and start sampling the zone inputs
+ * 
+ * Events are decoded in the PIO interrupt on the calling core and queued
+ * through zone_input_push_from_isr().
+ * 
+ * @param sample_hz Sampling rate in Hz
+ * @param confirm_samples Consecutive agreeing samples needed (1-32)
+ * @return true if the filter is running, false if unavailable
+ */
+bool zone_filter_start(uint32_t sample_hz, uint32_t confirm_samples);
+
+/**
+ * @brief Stop the filter and release its state machine
+ */
+void zone_filter_stop(void);
+
+/**
+ * @brief Get the number of event words received from the filter
+ * @return Event count since zone_filter_start()
+ */
+uint32_t zone_filter_get_event_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZONE_FILTER_H */
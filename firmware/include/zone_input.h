@@ -0,0 +1,115 @@
+/**
+ * @file zone_input.h
+ * @brief Interrupt-driven zone input capture for FACP iZone
+ * 
+ * Edges on the fire and fault optocoupler inputs (GPIO4-7) are stamped
+ * with time_us_64() in the GPIO interrupt, queued in a lock-free ring per
+ * input and signalled to the consuming task with a direct task
+ * notification. The consumer sleeps while the zones are quiet.
+ * 
+ * When enabled in g_system_config, the PIO glitch filter (zone_filter.h)
+ * replaces the GPIO interrupts as the producer.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef ZONE_INPUT_H
+#define ZONE_INPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "board_pins.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Zone input channels, in GPIO order starting at ZONE_INPUT_FIRST_GPIO */
+typedef enum {
+    ZONE_INPUT_FIRE_1 = 0,
+    ZONE_INPUT_FIRE_2,
+    ZONE_INPUT_FAULT_1,
+    ZONE_INPUT_FAULT_2,
+    ZONE_INPUT_CHANNEL_COUNT
+} zone_input_channel_t;
+
+#define ZONE_INPUT_FIRST_GPIO       BOARD_PIN_FIRE_ZONE_1
+#define ZONE_INPUT_RING_SIZE        16   /* Edges buffered per channel, power of two */
+
+/* Notification bit set on the consumer task when a channel has edges */
+#define ZONE_INPUT_NOTIFY_BIT(ch)   (1UL << (ch))
+#define ZONE_INPUT_NOTIFY_MASK      ((1UL << ZONE_INPUT_CHANNEL_COUNT) - 1UL)
+
+/* Timestamped input edge */
+typedef struct {
+    uint64_t timestamp_us;              /* time_us_64() at the interrupt */
+    bool level;                         /* Input level after the edge */
+} zone_edge_t;
+
+/* Per-channel capture statistics */
+typedef struct {
+    uint32_t edges;                     /* Edges consumed */
+    uint32_t overruns;                  /* Edges dropped because the ring was full */
+    uint32_t last_latency_us;           /* Edge-to-consumer latency of the last edge */
+    uint32_t max_latency_us;            /* Worst edge-to-consumer latency */
+    uint64_t total_latency_us;          /* Sum of latencies, for averaging */
+} zone_input_stats_t;
+
+/**
+ * @brief Configure the zone inputs and enable edge interrupts
+ * 
+ * Must be called from the task that consumes the edges; the GPIO
+ * interrupt is serviced on the core this is called from.
+ * 
+ * @param xNotifyTask Task notified with ZONE_INPUT_NOTIFY_BIT() on edges
+ */
+void zone_input_init(TaskHandle_t xNotifyTask);
+
+/**
+ * @brief Queue an edge from interrupt context and notify the consumer
+ * 
+ * Used by the GPIO interrupt and by alternative input front ends.
+ * 
+ * @param channel Zone input channel
+ * @param level Input level after the edge
+ * @param timestamp_us Time of the edge
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if a context switch is needed
+ */
+void zone_input_push_from_isr(zone_input_channel_t channel, bool level,
+                              uint64_t timestamp_us,
+                              BaseType_t *pxHigherPriorityTaskWoken);
+
+/**
+ * @brief Take the oldest queued edge of a channel
+ * @param channel Zone input channel
+ * @param edge Receives the edge
+ * @return true if an edge was returned, false if the ring was empty
+ */
+bool zone_input_pop(zone_input_channel_t channel, zone_edge_t *edge);
+
+/**
+ * @brief Get the last level consumed on a channel
+ * 
+ * After edges were dropped to a full ring, this is the newest level the
+ * interrupt saw, once zone_input_pop() has found the ring empty.
+ * 
+ * @param channel Zone input channel
+ * @return true if the input is active
+ */
+bool zone_input_get_level(zone_input_channel_t channel);
+
+/**
+ * @brief Get capture statistics for a channel
+ * @param channel Zone input channel
+ * @param stats Receives the statistics
+ */
+void zone_input_get_stats(zone_input_channel_t channel, zone_input_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZONE_INPUT_H */
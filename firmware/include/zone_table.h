@@ -0,0 +1,134 @@
+/**
+ * @file zone_table.h
+ * @brief Struct-of-arrays zone table for FACP iZone
+ * 
+ * Zone state is kept column by column. Status flags are bit masks, one
+ * bit per zone in 32-bit words, so "which zones are in alarm" is a few
+ * word operations and a full status scan touches only the mask words.
+ * Per-zone columns (thresholds, last-change times, counters) are only
+ * touched for zones whose status changed.
+ * 
+ * Alarm bits latch: a fire input that clears again, or an intermittent
+ * detector, leaves its zone in alarm until an explicit reset
+ * (zone_table_reset_alarm()). Fault bits follow the inputs.
+ * 
+ * The table is sized by the FACP_MAX_ZONES build option. Each mask word
+ * has a single writer (the module owning those zones); readers may see
+ * words from different updates.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#ifndef ZONE_TABLE_H
+#define ZONE_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "system_init.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZONE_MASK_WORDS         ((MAX_ZONES + 31) / 32)
+#define ZONE_MASK_WORD(zone)    ((zone) >> 5)
+#define ZONE_MASK_BIT(zone)     (1UL << ((zone) & 31u))
+
+/* Default level threshold: mid-range of the 12-bit ADC */
+#define ZONE_DEFAULT_THRESHOLD  2048
+
+typedef struct {
+    /* Status masks, one bit per zone */
+    uint32_t configured[ZONE_MASK_WORDS];
+    uint32_t alarm[ZONE_MASK_WORDS];
+    uint32_t fault[ZONE_MASK_WORDS];
+    uint32_t disabled[ZONE_MASK_WORDS];
+
+    /* Per-zone columns */
+    uint16_t threshold[MAX_ZONES];      /* Level threshold, 12-bit ADC units */
+    uint32_t last_change_ms[MAX_ZONES]; /* Time of the last status change */
+    uint16_t alarm_count[MAX_ZONES];    /* Transitions into alarm */
+    uint16_t fault_count[MAX_ZONES];    /* Transitions into fault */
+
+    uint32_t zone_count;
+} zone_table_t;
+
+extern zone_table_t g_zone_table;
+
+/**
+ * @brief Reset the table and mark the first zone_count zones configured
+ * @param zone_count Configured zones (at most MAX_ZONES)
+ */
+void zone_table_init(uint32_t zone_count);
+
+/**
+ * @brief Update the alarm and fault bits of the zones in one mask word
+ * 
+ * Only bits set in owned are changed. Alarm bits are only set here:
+ * a zone stays in alarm until zone_table_reset_alarm(). Zones whose
+ * status changes get their last-change time and counters updated.
+ * 
+ * @param word Mask word index (zones 32*word to 32*word+31)
+ * @param owned Zones updated by the caller
+ * @param alarm Zones now in alarm (latched)
+ * @param fault New fault bits
+ * @param now_ms Current time in ms since boot
+ * @return Mask of zones whose status changed
+ */
+uint32_t zone_table_update(uint32_t word, uint32_t owned, uint32_t alarm,
+                           uint32_t fault, uint32_t now_ms);
+
+/**
+ * @brief Clear latched alarm bits (panel reset)
+ * 
+ * Called by the writer of the mask word. A zone whose input is still
+ * in alarm latches again at the writer's next update.
+ * 
+ * @param word Mask word index
+ * @param zones Zones to reset
+ * @param now_ms Current time in ms since boot
+ * @return Mask of zones that were in alarm
+ */
+uint32_t zone_table_reset_alarm(uint32_t word, uint32_t zones, uint32_t now_ms);
+
+/**
+ * @brief Enable or disable a zone
+ * @param zone Zone index
+ * @param disabled true to disable
+ */
+void zone_table_set_disabled(uint32_t zone, bool disabled);
+
+/**
+ * @brief Get the status of one zone
+ * 
+ * Disabled takes precedence over alarm, and alarm over fault.
+ * 
+ * @param zone Zone index
+ * @return Zone status; ZONE_STATUS_DISABLED for unconfigured zones
+ */
+zone_status_t zone_table_get_status(uint32_t zone);
+
+/**
+ * @brief Count enabled zones in alarm
+ * @return Number of zones
+ */
+uint32_t zone_table_count_alarm(void);
+
+/**
+ * @brief Count enabled zones in fault that are not in alarm
+ * @return Number of zones
+ */
+uint32_t zone_table_count_fault(void);
+
+/**
+ * @brief Derive the system status from the zone masks
+ * @return SYSTEM_STATUS_ALARM, SYSTEM_STATUS_FAULT or SYSTEM_STATUS_NORMAL
+ */
+system_status_t zone_table_system_status(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZONE_TABLE_H */
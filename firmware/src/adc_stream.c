@@ -0,0 +1,216 @@
+/**
+ * @file adc_stream.c
+ * @brief Free-running ADC sampling: block bookkeeping and reduction
+ * 
+ * The sampler back end (adc_stream_dma.c, or the simulated sampler in the
+ * host build) fills the two block buffers alternately and calls
+ * adc_stream_block_from_isr() after each one. Block n lives in buffer
+ * (n - 1) & 1, and the back end starts overwriting it as soon as block
+ * n + 1 completes, so the consumer has one block period to reduce it.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "adc_stream.h"
+#include "zone_table.h"
+#include "log.h"
+
+#define ADC_STREAM_MAX_RATE_HZ  500000u  /* 48 MHz ADC clock, 96 cycles per conversion */
+
+static uint16_t usAdcBuffers[2][ADC_STREAM_BLOCK_SAMPLES] __attribute__((aligned(4)));
+
+static TaskHandle_t xAdcNotifyTask = NULL;
+static volatile uint32_t ulAdcBlockSeq;  /* Advanced by the back end only */
+static uint32_t ulAdcProcessedSeq;
+static uint32_t ulAdcProcessed;
+static uint32_t ulAdcDropped;
+static uint32_t ulAdcChannels;
+static uint32_t ulAdcOversampleShift;
+static uint32_t ulAdcFrames;
+static uint32_t ulAdcBlockPeriodUs;
+static uint16_t usAdcThresholds[ADC_STREAM_MAX_CHANNELS];
+static adc_channel_stats_t xAdcStats[ADC_STREAM_MAX_CHANNELS];
+static bool xAdcHasData = false;
+static bool xAdcRunning = false;
+
+void adc_stream_reduce(const uint16_t *samples, uint32_t frames,
+                       uint32_t channels, uint32_t oversample_shift,
+                       const uint16_t *thresholds, adc_channel_stats_t *stats)
+{
+    uint32_t ulMin[ADC_STREAM_MAX_CHANNELS];
+    uint32_t ulMax[ADC_STREAM_MAX_CHANNELS];
+    uint32_t ulSum[ADC_STREAM_MAX_CHANNELS];
+    uint32_t ulPasses = 1u << oversample_shift;
+
+    for (uint32_t c = 0; c < channels; c++) {
+        ulMin[c] = UINT32_MAX;
+        ulMax[c] = 0;
+        ulSum[c] = 0;
+        stats[c].crossings = 0;
+    }
+
+    for (uint32_t f = 0; f < frames; f++) {
+        uint32_t ulAcc[ADC_STREAM_MAX_CHANNELS] = { 0 };
+
+        /* One linear pass over the frame; channels interleave */
+        for (uint32_t p = 0; p < ulPasses; p++) {
+            for (uint32_t c = 0; c < channels; c++) {
+                ulAcc[c] += *samples++;
+            }
+        }
+
+        for (uint32_t c = 0; c < channels; c++) {
+            uint32_t ulValue = ulAcc[c] >> oversample_shift;
+            bool xAbove;
+
+            ulMin[c] = (ulValue < ulMin[c]) ? ulValue : ulMin[c];
+            ulMax[c] = (ulValue > ulMax[c]) ? ulValue : ulMax[c];
+            ulSum[c] += ulValue;
+
+            if (thresholds[c] != 0) {
+                xAbove = (ulValue >= thresholds[c]);
+                stats[c].crossings += (uint16_t)(xAbove != stats[c].above);
+                stats[c].above = xAbove;
+            }
+            stats[c].last = (uint16_t)ulValue;
+        }
+    }
+
+    for (uint32_t c = 0; c < channels; c++) {
+        stats[c].min = (uint16_t)ulMin[c];
+        stats[c].max = (uint16_t)ulMax[c];
+        stats[c].mean = (uint16_t)(frames ? (ulSum[c] / frames) : 0);
+    }
+}
+
+bool adc_stream_start(TaskHandle_t xNotifyTask, uint32_t sample_hz,
+                      uint32_t oversample, bool temp_sensor)
+{
+    uint16_t *pusBuffers[2] = { usAdcBuffers[0], usAdcBuffers[1] };
+    uint32_t ulChannelMask = (1u << ADC_STREAM_SENSOR_CHANNELS) - 1u;
+    uint32_t ulAdcRate;
+
+    if (xAdcRunning || (sample_hz == 0) || (oversample == 0) ||
+        (oversample > ADC_STREAM_MAX_OVERSAMPLE) ||
+        ((oversample & (oversample - 1u)) != 0)) {
+        return false;
+    }
+
+    ulAdcChannels = ADC_STREAM_SENSOR_CHANNELS;
+    if (temp_sensor) {
+        ulChannelMask |= 1u << ADC_STREAM_TEMP_CHANNEL;
+        ulAdcChannels++;
+    }
+
+    ulAdcRate = sample_hz * ulAdcChannels * oversample;
+    if (ulAdcRate > ADC_STREAM_MAX_RATE_HZ) {
+        LOG_WARN("ADC stream: %u Hz x%u exceeds the ADC rate",
+                 (unsigned)sample_hz, (unsigned)oversample);
+        return false;
+    }
+
+    /* Whole frames per block keep the round-robin order aligned */
+    ulAdcOversampleShift = (uint32_t)__builtin_ctz(oversample);
+    ulAdcFrames = ADC_STREAM_BLOCK_SAMPLES / (ulAdcChannels * oversample);
+    ulAdcBlockPeriodUs = (uint32_t)(((uint64_t)ulAdcFrames * 1000000u) / sample_hz);
+
+    memset(xAdcStats, 0, sizeof(xAdcStats));
+    memset(usAdcThresholds, 0, sizeof(usAdcThresholds));
+    for (uint32_t c = 0; c < ADC_STREAM_SENSOR_CHANNELS; c++) {
+        usAdcThresholds[c] = g_zone_table.threshold[c];
+    }
+
+    ulAdcBlockSeq = 0;
+    ulAdcProcessedSeq = 0;
+    ulAdcProcessed = 0;
+    ulAdcDropped = 0;
+    xAdcHasData = false;
+    xAdcNotifyTask = xNotifyTask;
+
+    if (!adc_stream_hw_start(pusBuffers, ulAdcFrames * ulAdcChannels * oversample,
+                             ulChannelMask, ulAdcRate)) {
+        return false;
+    }
+    xAdcRunning = true;
+
+    LOG_INFO("ADC stream: %u channels, %u Hz x%u, %u frames per block (%u us)",
+             (unsigned)ulAdcChannels, (unsigned)sample_hz, (unsigned)oversample,
+             (unsigned)ulAdcFrames, (unsigned)ulAdcBlockPeriodUs);
+    return true;
+}
+
+void adc_stream_stop(void)
+{
+    if (xAdcRunning) {
+        adc_stream_hw_stop();
+        xAdcRunning = false;
+    }
+}
+
+void adc_stream_block_from_isr(BaseType_t *pxHigherPriorityTaskWoken)
+{
+    ulAdcBlockSeq++;
+
+    if (xAdcNotifyTask != NULL) {
+        xTaskNotifyFromISR(xAdcNotifyTask, ADC_STREAM_NOTIFY_BIT, eSetBits,
+                           pxHigherPriorityTaskWoken);
+    }
+}
+
+bool adc_stream_process(void)
+{
+    adc_channel_stats_t xWork[ADC_STREAM_MAX_CHANNELS];
+    uint32_t ulSeq = ulAdcBlockSeq;
+
+    if (ulSeq == ulAdcProcessedSeq) {
+        return false;
+    }
+
+    /* Only the latest block is still intact */
+    ulAdcDropped += ulSeq - ulAdcProcessedSeq - 1u;
+    ulAdcProcessedSeq = ulSeq;
+
+    /* Threshold state carries over from the previous block */
+    memcpy(xWork, xAdcStats, sizeof(xWork));
+
+    __dmb();
+    adc_stream_reduce(usAdcBuffers[(ulSeq - 1u) & 1u], ulAdcFrames,
+                      ulAdcChannels, ulAdcOversampleShift, usAdcThresholds, xWork);
+    __dmb();
+
+    /* The sampler wrapped into this buffer while it was being read */
+    if (ulAdcBlockSeq != ulSeq) {
+        ulAdcDropped++;
+        return false;
+    }
+
+    memcpy(xAdcStats, xWork, sizeof(xAdcStats));
+    xAdcHasData = true;
+    ulAdcProcessed++;
+    return true;
+}
+
+bool adc_stream_get_stats(uint32_t channel, adc_channel_stats_t *stats)
+{
+    if (!xAdcHasData || (channel >= ulAdcChannels)) {
+        return false;
+    }
+
+    *stats = xAdcStats[channel];
+    return true;
+}
+
+void adc_stream_get_counters(adc_stream_counters_t *counters)
+{
+    counters->blocks = ulAdcBlockSeq;
+    counters->processed = ulAdcProcessed;
+    counters->dropped = ulAdcDropped;
+    counters->frames_per_block = ulAdcFrames;
+    counters->block_period_us = ulAdcBlockPeriodUs;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file adc_stream_dma.c
+ * @brief ADC round-robin sampling into ping-pong buffers by DMA
+ * 
+ * Two DMA channels are chained to each other, each owning one block
+ * buffer. When one finishes it triggers the other, so no conversion is
+ * lost between blocks; its completion interrupt only rewinds its write
+ * address and reports the block.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "adc_stream.h"
+#include "board_pins.h"
+#include "trace.h"
+
+#define ADC_STREAM_DMA_IRQ      DMA_IRQ_1
+
+static int lAdcDmaChannel[2] = { -1, -1 };
+static uint16_t *pusAdcBuffers[2];
+
+/**
+ * @brief DMA completion interrupt: rewind the finished channel
+ */
+static void prvAdcDmaIrqHandler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    TRACE_ISR_ENTER(TRACE_ISR_ADC_DMA);
+
+    for (uint32_t i = 0; i < 2u; i++) {
+        uint ch = (uint)lAdcDmaChannel[i];
+
+        if ((lAdcDmaChannel[i] >= 0) && dma_channel_get_irq1_status(ch)) {
+            dma_channel_acknowledge_irq1(ch);
+            dma_channel_set_write_addr(ch, pusAdcBuffers[i], false);
+            adc_stream_block_from_isr(&xHigherPriorityTaskWoken);
+        }
+    }
+
+    TRACE_ISR_EXIT(TRACE_ISR_ADC_DMA);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+static void prvReleaseChannels(void)
+{
+    for (uint32_t i = 0; i < 2u; i++) {
+        if (lAdcDmaChannel[i] >= 0) {
+            dma_channel_set_irq1_enabled((uint)lAdcDmaChannel[i], false);
+            dma_channel_abort((uint)lAdcDmaChannel[i]);
+            dma_channel_unclaim((uint)lAdcDmaChannel[i]);
+            lAdcDmaChannel[i] = -1;
+        }
+    }
+}
+
+bool adc_stream_hw_start(uint16_t *buffers[2], uint32_t block_samples,
+                         uint32_t channel_mask, uint32_t adc_rate_hz)
+{
+    uint32_t ulAdcClock = clock_get_hz(clk_adc);
+    uint32_t ulDiv;
+
+    for (uint32_t i = 0; i < 2u; i++) {
+        lAdcDmaChannel[i] = dma_claim_unused_channel(false);
+        if (lAdcDmaChannel[i] < 0) {
+            prvReleaseChannels();
+            return false;
+        }
+        pusAdcBuffers[i] = buffers[i];
+    }
+
+    adc_init();
+    for (uint32_t ch = 0; ch < ADC_STREAM_SENSOR_CHANNELS; ch++) {
+        adc_gpio_init(BOARD_PIN_ADC0 + ch);
+    }
+    adc_set_temp_sensor_enabled((channel_mask & (1u << ADC_STREAM_TEMP_CHANNEL)) != 0);
+    adc_select_input(0);
+    adc_set_round_robin(channel_mask);
+    adc_fifo_setup(true, true, 1, false, false);
+    /* DIV is 16.8 fixed point, one conversion per (DIV + 1) cycles; written
+     * directly because adc_set_clkdiv() takes a float */
+    ulDiv = (uint32_t)((((uint64_t)ulAdcClock << 8) / adc_rate_hz) - 0x100u);
+    adc_hw->div = ulDiv;
+
+    for (uint32_t i = 0; i < 2u; i++) {
+        dma_channel_config c = dma_channel_get_default_config((uint)lAdcDmaChannel[i]);
+
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, DREQ_ADC);
+        channel_config_set_chain_to(&c, (uint)lAdcDmaChannel[i ^ 1u]);
+
+        dma_channel_configure((uint)lAdcDmaChannel[i], &c, buffers[i],
+                              &adc_hw->fifo, block_samples, false);
+        dma_channel_set_irq1_enabled((uint)lAdcDmaChannel[i], true);
+    }
+
+    irq_add_shared_handler(ADC_STREAM_DMA_IRQ, prvAdcDmaIrqHandler,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(ADC_STREAM_DMA_IRQ, true);
+
+    dma_channel_start((uint)lAdcDmaChannel[0]);
+    adc_run(true);
+    return true;
+}
+
+void adc_stream_hw_stop(void)
+{
+    adc_run(false);
+    prvReleaseChannels();
+    irq_remove_handler(ADC_STREAM_DMA_IRQ, prvAdcDmaIrqHandler);
+    adc_set_round_robin(0);
+    adc_fifo_drain();
+}
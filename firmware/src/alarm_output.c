@@ -0,0 +1,168 @@
+/**
+ * @file alarm_output.c
+ * @brief Zone alarm outputs and fire LEDs
+ *
+ * The fast path and the sensor monitor share the output state. The zone
+ * filter interrupt is serviced on the monitor's core, so the monitor
+ * only has to mask its own core's interrupts while it updates it. Pins
+ * change through the SIO set and clear registers, which are single
+ * writes and never race with the other core's GPIOs.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "alarm_output.h"
+#include "zone_table.h"
+#include "log.h"
+#include "trace.h"
+
+_Static_assert(ALARM_OUTPUT_ZONES <= 32, "zones must fit zone table word 0");
+
+/* Alarm output and fire LED of each zone */
+static const uint32_t ulZonePins[ALARM_OUTPUT_ZONES] = {
+    (1UL << BOARD_PIN_ALARM_OUT_1) | (1UL << BOARD_PIN_LED_FIRE_1),
+    (1UL << BOARD_PIN_ALARM_OUT_2) | (1UL << BOARD_PIN_LED_FIRE_2),
+};
+
+static bool xFastPath;
+static volatile uint32_t ulActive;      /* Asserted zones */
+static volatile uint32_t ulFastPending; /* Asserted by the fast path, not yet verified */
+static alarm_output_stats_t xStats;
+
+static uint32_t prvPins(uint32_t ulZones)
+{
+    uint32_t ulPins = 0;
+
+    for (; ulZones != 0; ulZones &= ulZones - 1u) {
+        ulPins |= ulZonePins[__builtin_ctz(ulZones)];
+    }
+    return ulPins;
+}
+
+static void prvRecordAssert(uint32_t ulZone, alarm_output_source_t xSource, uint32_t ulLatencyUs)
+{
+    xStats.last_latency_us = ulLatencyUs;
+    if (xSource == ALARM_OUTPUT_SOURCE_FAST) {
+        xStats.fast_asserts++;
+        if (ulLatencyUs > xStats.max_fast_latency_us) {
+            xStats.max_fast_latency_us = ulLatencyUs;
+        }
+    } else {
+        xStats.task_asserts++;
+        if (ulLatencyUs > xStats.max_task_latency_us) {
+            xStats.max_task_latency_us = ulLatencyUs;
+        }
+    }
+    TRACE_ALARM_OUTPUT(ulZone, xSource, ulLatencyUs);
+}
+
+void alarm_output_init(bool fast_path)
+{
+    uint32_t ulPins = prvPins(ALARM_OUTPUT_ZONE_MASK);
+
+    gpio_init_mask(ulPins);
+    gpio_clr_mask(ulPins);
+    gpio_set_dir_out_masked(ulPins);
+
+    ulActive = 0;
+    ulFastPending = 0;
+    memset(&xStats, 0, sizeof(xStats));
+    xFastPath = fast_path;
+}
+
+void alarm_output_fast_from_isr(uint32_t zones, uint64_t edge_us)
+{
+    uint32_t ulNew;
+    uint32_t ulLatencyUs;
+
+    if (!xFastPath) {
+        return;
+    }
+
+    /* Disabled zones never sound, whoever drives them */
+    ulNew = zones & ALARM_OUTPUT_ZONE_MASK & ~g_zone_table.disabled[0] & ~ulActive;
+    if (ulNew == 0) {
+        return;
+    }
+
+    gpio_set_mask(prvPins(ulNew));
+    ulLatencyUs = (uint32_t)(time_us_64() - edge_us);
+
+    ulActive |= ulNew;
+    ulFastPending |= ulNew;
+    for (; ulNew != 0; ulNew &= ulNew - 1u) {
+        prvRecordAssert((uint32_t)__builtin_ctz(ulNew), ALARM_OUTPUT_SOURCE_FAST, ulLatencyUs);
+    }
+}
+
+uint32_t alarm_output_get_fast_pending(void)
+{
+    return ulFastPending;
+}
+
+void alarm_output_update(uint32_t alarm, uint32_t fast_seen, const uint64_t *edge_us)
+{
+    UBaseType_t uxSaved;
+    uint32_t ulRaise;
+    uint32_t ulRelease;
+    uint32_t ulConfirmed;
+    uint32_t ulUnconfirmed;
+    uint64_t ullNow;
+
+    alarm &= ALARM_OUTPUT_ZONE_MASK;
+
+    /* The fast path runs in an interrupt on this core */
+    uxSaved = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    /* Fast assertions after fast_seen have edges the caller has not read */
+    fast_seen &= ulFastPending;
+    ulRaise = alarm & ~ulActive;
+    ulRelease = ulActive & ~alarm & ~(ulFastPending & ~fast_seen);
+    ulConfirmed = fast_seen & alarm;
+    ulUnconfirmed = fast_seen & ulRelease;
+
+    if (ulRaise != 0) {
+        gpio_set_mask(prvPins(ulRaise));
+    }
+    if (ulRelease != 0) {
+        gpio_clr_mask(prvPins(ulRelease));
+    }
+    ullNow = time_us_64();
+
+    ulActive = (ulActive | ulRaise) & ~ulRelease;
+    ulFastPending &= ~fast_seen;
+    xStats.confirmed += (uint32_t)__builtin_popcount(ulConfirmed);
+    xStats.unconfirmed += (uint32_t)__builtin_popcount(ulUnconfirmed);
+    for (uint32_t ulBits = ulRaise; ulBits != 0; ulBits &= ulBits - 1u) {
+        uint32_t zone = (uint32_t)__builtin_ctz(ulBits);
+
+        prvRecordAssert(zone, ALARM_OUTPUT_SOURCE_TASK, (uint32_t)(ullNow - edge_us[zone]));
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSaved);
+
+    for (uint32_t ulBits = ulRelease; ulBits != 0; ulBits &= ulBits - 1u) {
+        uint32_t zone = (uint32_t)__builtin_ctz(ulBits);
+
+        TRACE_ALARM_OUTPUT(zone, ALARM_OUTPUT_SOURCE_RELEASE, 0u);
+        if (ulUnconfirmed & (1UL << zone)) {
+            LOG_WARN("Zone %u: fast alarm output not confirmed, released", (unsigned)(zone + 1u));
+        }
+    }
+}
+
+uint32_t alarm_output_get_active(void)
+{
+    return ulActive;
+}
+
+void alarm_output_get_stats(alarm_output_stats_t *stats)
+{
+    *stats = xStats;
+}
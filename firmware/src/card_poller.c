@@ -0,0 +1,531 @@
+/**
+ * @file card_poller.c
+ * @brief Pass planning, frame checking and card records of the poller
+ *
+ * The plan and its progress counter are shared with the back end
+ * interrupt, which runs on the poller's core: the task only touches
+ * them with that interrupt masked (taskENTER_CRITICAL), and reads a
+ * plan slot's frame only after the counter has passed it. Only the task
+ * appends to the plan, so it may read the plan count unmasked. Card records
+ * and pass timing are written by the poller task under the same
+ * critical section so other tasks can copy them.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "card_poller.h"
+#include "status_link.h"
+#include "crc.h"
+#include "system_init.h"
+#include "supervisor.h"
+#include "periodic.h"
+#include "task_table.h"
+#include "log.h"
+
+_Static_assert((CARD_POLLER_FIRST_ADDRESS + CARD_POLLER_MAX_CARDS) <= 0x78,
+               "card addresses run into the reserved I2C range");
+_Static_assert((CARD_POLLER_SWEEP_MS % CARD_POLLER_HOT_MS) == 0,
+               "a sweep must start on a hot pass");
+
+/* A card's frame read plus the change counter reads that triggered it */
+#define CARD_POLLER_PLAN_SLOTS  (2u * CARD_POLLER_MAX_CARDS)
+
+typedef enum {
+    CARD_POLL_PASS_HOT = 0,
+    CARD_POLL_PASS_SWEEP,
+    CARD_POLL_PASS_ATTENTION
+} card_poll_pass_t;
+
+/* One transaction of the running pass */
+typedef struct {
+    uint8_t card;
+    uint8_t result;                         /* card_poll_result_t */
+    bool quick;                             /* Change counter only */
+    uint32_t start_us;
+    uint32_t rtt_us;
+} card_poll_slot_t;
+
+static card_poller_card_t xCards[CARD_POLLER_MAX_CARDS];
+static uint32_t ulCardCount;
+static card_poller_mode_t eMode;
+static card_poller_stats_t xStats;
+
+/* Running pass, shared with the back end interrupt; frames are per card
+ * since a card's frame read follows its change counter read */
+static card_poll_slot_t xPlan[CARD_POLLER_PLAN_SLOTS];
+static uint8_t ucFrames[CARD_POLLER_MAX_CARDS][STATUS_LINK_FRAME_BYTES];
+static volatile uint32_t ulPlanCount;
+static volatile uint32_t ulCompleted;
+static TaskHandle_t xPollerTask;
+static uint32_t ulPassChanges;              /* Cards of the running pass seen changing */
+
+/* Attention line, set by the back end interrupt */
+static volatile bool xAttentionEnabled;
+static volatile bool xAttentionPending;
+
+/**
+ * @brief Put a slot on the bus (poller interrupt masked)
+ */
+static void prvBeginSlot(uint32_t ulSlot)
+{
+    card_poll_slot_t *pxSlot = &xPlan[ulSlot];
+
+    pxSlot->start_us = time_us_32();
+    card_poller_hw_begin(xCards[pxSlot->card].address, ucFrames[pxSlot->card],
+                         pxSlot->quick ? 1u : STATUS_LINK_FRAME_BYTES, !pxSlot->quick);
+}
+
+/**
+ * @brief Close the running slot and start the next (poller interrupt masked)
+ */
+static void prvFinishSlot(card_poll_result_t eResult)
+{
+    uint32_t ulSlot = ulCompleted;
+
+    xPlan[ulSlot].rtt_us = time_us_32() - xPlan[ulSlot].start_us;
+    xPlan[ulSlot].result = (uint8_t)eResult;
+    ulCompleted = ulSlot + 1u;
+
+    if ((ulSlot + 1u) < ulPlanCount) {
+        prvBeginSlot(ulSlot + 1u);
+    }
+}
+
+void card_poller_attention_from_isr(BaseType_t *higher_priority_woken)
+{
+    if (!xAttentionEnabled) {
+        return;
+    }
+
+    xStats.attention_edges++;
+    xAttentionPending = true;
+    if (xPollerTask != NULL) {
+        vTaskNotifyGiveFromISR(xPollerTask, higher_priority_woken);
+    }
+}
+
+void card_poller_done_from_isr(bool acked, BaseType_t *higher_priority_woken)
+{
+    /* A completion after a timeout abort belongs to no slot */
+    if (ulCompleted >= ulPlanCount) {
+        return;
+    }
+
+    prvFinishSlot(acked ? CARD_POLL_OK : CARD_POLL_NAK);
+    if (xPollerTask != NULL) {
+        vTaskNotifyGiveFromISR(xPollerTask, higher_priority_woken);
+    }
+}
+
+/**
+ * @brief A card that must also be read on hot passes
+ *
+ * Offline cards wait for the full sweep, so a missing card costs one
+ * NAK per second rather than one per hot pass.
+ */
+static bool prvIsHot(const card_poller_card_t *pxCard)
+{
+    if ((pxCard->failures > 0) && (pxCard->failures < CARD_POLLER_FAIL_LIMIT)) {
+        return true;
+    }
+    return pxCard->online && ((pxCard->alarm != 0) || (pxCard->fault != 0) ||
+                              (pxCard->system_status == SYSTEM_STATUS_ALARM) ||
+                              (pxCard->system_status == SYSTEM_STATUS_FAULT));
+}
+
+/**
+ * @brief A card that can be polled by its change counter alone
+ */
+static bool prvIsQuick(const card_poller_card_t *pxCard, uint32_t ulNowMs)
+{
+    return (eMode == CARD_POLLER_MODE_CHANGE) && pxCard->synced &&
+           ((ulNowMs - pxCard->last_frame_ms) < CARD_POLLER_FRAME_REFRESH_MS);
+}
+
+static uint32_t prvPlan(bool xFullSweep)
+{
+    uint32_t ulNowMs = to_ms_since_boot(get_absolute_time());
+    uint32_t ulCount = 0;
+
+    for (uint32_t i = 0; i < ulCardCount; i++) {
+        if (xFullSweep || prvIsHot(&xCards[i])) {
+            xPlan[ulCount].card = (uint8_t)i;
+            xPlan[ulCount].result = CARD_POLL_TIMEOUT;
+            xPlan[ulCount].quick = prvIsQuick(&xCards[i], ulNowMs);
+            ulCount++;
+        }
+    }
+    return ulCount;
+}
+
+/**
+ * @brief Queue a frame read straight after the transaction on the bus
+ *
+ * Only slots not yet started move up; the read starts at once if the
+ * bus has gone idle.
+ */
+static void prvQueueFrameRead(uint32_t ulCard)
+{
+    uint32_t ulSlot;
+
+    taskENTER_CRITICAL();
+    ulSlot = (ulCompleted < ulPlanCount) ? (ulCompleted + 1u) : ulPlanCount;
+    memmove(&xPlan[ulSlot + 1u], &xPlan[ulSlot], (ulPlanCount - ulSlot) * sizeof(xPlan[0]));
+    xPlan[ulSlot].card = (uint8_t)ulCard;
+    xPlan[ulSlot].result = CARD_POLL_TIMEOUT;
+    xPlan[ulSlot].quick = false;
+    ulPlanCount = ulPlanCount + 1u;
+    if (ulCompleted == ulSlot) {
+        prvBeginSlot(ulSlot);
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Drop the change counter reads not yet started
+ *
+ * Queued frame reads sit before them and still run.
+ */
+static void prvEndScan(void)
+{
+    taskENTER_CRITICAL();
+    for (uint32_t i = ulCompleted + 1u; i < ulPlanCount; i++) {
+        if (xPlan[i].quick) {
+            ulPlanCount = i;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Result of a completed slot after the frame checks
+ */
+static card_poll_result_t prvCheckFrame(uint32_t ulSlot)
+{
+    const uint8_t *pucFrame = ucFrames[xPlan[ulSlot].card];
+    const status_link_frame_t *pxFrame = (const status_link_frame_t *)pucFrame;
+    uint16_t usCrc;
+
+    if ((xPlan[ulSlot].result != CARD_POLL_OK) || xPlan[ulSlot].quick) {
+        return (card_poll_result_t)xPlan[ulSlot].result;
+    }
+
+    usCrc = (uint16_t)(pucFrame[STATUS_LINK_FRAME_BYTES - 2u] |
+                       ((uint16_t)pucFrame[STATUS_LINK_FRAME_BYTES - 1u] << 8));
+    if ((pxFrame->version != STATUS_LINK_FRAME_VERSION) ||
+        (pxFrame->length != STATUS_LINK_FRAME_BYTES) ||
+        (crc16_ccitt(pucFrame, STATUS_LINK_FRAME_BYTES - 2u) != usCrc)) {
+        return CARD_POLL_CRC;
+    }
+    return CARD_POLL_OK;
+}
+
+/**
+ * @brief Check a slot's frame and update its card
+ *
+ * Runs while the next slot is on the bus. A change counter that differs
+ * from the one of the held frame queues a frame read of the card.
+ */
+static void prvCheckSlot(uint32_t ulSlot)
+{
+    uint32_t ulIndex = xPlan[ulSlot].card;
+    const status_link_frame_t *pxFrame = (const status_link_frame_t *)ucFrames[ulIndex];
+    card_poller_card_t *pxCard = &xCards[ulIndex];
+    card_poll_result_t eResult = prvCheckFrame(ulSlot);
+    bool xQuick = xPlan[ulSlot].quick;
+    uint32_t ulRtt = xPlan[ulSlot].rtt_us;
+    bool xWasOnline = pxCard->online;
+    uint8_t ucOldAlarm = pxCard->alarm;
+    uint8_t ucOldFault = pxCard->fault;
+    bool xChanged = false;
+    bool xEvent = false;
+
+    taskENTER_CRITICAL();
+    pxCard->polls++;
+    pxCard->rtt_last_us = ulRtt;
+    if (xQuick) {
+        pxCard->quick_polls++;
+        xStats.quick_reads++;
+    } else {
+        xStats.frame_reads++;
+    }
+    switch (eResult) {
+    case CARD_POLL_OK:
+        pxCard->online = true;
+        pxCard->failures = 0;
+        pxCard->last_ok_ms = to_ms_since_boot(get_absolute_time());
+        pxCard->rtt_total_us += ulRtt;
+        if (ulRtt > pxCard->rtt_max_us) {
+            pxCard->rtt_max_us = ulRtt;
+        }
+        if (xQuick) {
+            xChanged = (pxFrame->change != pxCard->change);
+            break;
+        }
+        pxCard->change = pxFrame->change;
+        pxCard->synced = true;
+        pxCard->last_frame_ms = pxCard->last_ok_ms;
+        if ((pxFrame->alarm != pxCard->alarm) || (pxFrame->fault != pxCard->fault)) {
+            pxCard->event_us = time_us_32();
+            xEvent = true;
+        }
+        pxCard->system_status = pxFrame->system_status;
+        pxCard->alarm = pxFrame->alarm;
+        pxCard->fault = pxFrame->fault;
+        pxCard->disabled = pxFrame->disabled;
+        pxCard->outputs = pxFrame->outputs;
+        pxCard->sequence = pxFrame->sequence;
+        break;
+    case CARD_POLL_NAK:
+        pxCard->naks++;
+        break;
+    case CARD_POLL_CRC:
+        pxCard->crc_errors++;
+        break;
+    default:
+        pxCard->timeouts++;
+        break;
+    }
+    if (eResult != CARD_POLL_OK) {
+        /* The card may have restarted with a matching counter */
+        pxCard->synced = false;
+        pxCard->failures++;
+        if (pxCard->failures >= CARD_POLLER_FAIL_LIMIT) {
+            pxCard->online = false;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (xChanged) {
+        prvQueueFrameRead(ulIndex);
+    }
+    if (xChanged || xEvent) {
+        ulPassChanges++;
+    }
+
+    /* FR-BC-005: report card failures, including cards never seen, and recoveries */
+    if (pxCard->online && !xWasOnline) {
+        LOG_INFO("Card %u (0x%02x) online", (unsigned)ulIndex, (unsigned)pxCard->address);
+    } else if (pxCard->failures == CARD_POLLER_FAIL_LIMIT) {
+        LOG_WARN("Card %u (0x%02x) not answering", (unsigned)ulIndex,
+                 (unsigned)pxCard->address);
+    }
+    if ((ucOldAlarm != pxCard->alarm) || (ucOldFault != pxCard->fault)) {
+        LOG_INFO("Card %u: alarm 0x%02x fault 0x%02x", (unsigned)ulIndex,
+                 (unsigned)pxCard->alarm, (unsigned)pxCard->fault);
+    }
+}
+
+bool card_poller_init(uint32_t card_count, uint32_t baudrate, card_poller_mode_t mode)
+{
+    if (card_count > CARD_POLLER_MAX_CARDS) {
+        card_count = CARD_POLLER_MAX_CARDS;
+    }
+
+    memset(xCards, 0, sizeof(xCards));
+    memset(&xStats, 0, sizeof(xStats));
+    for (uint32_t i = 0; i < card_count; i++) {
+        xCards[i].address = (uint8_t)(CARD_POLLER_FIRST_ADDRESS + i);
+    }
+    ulCardCount = card_count;
+    eMode = mode;
+    xAttentionPending = false;
+    ulPlanCount = 0;
+    ulCompleted = 0;
+
+    if (!card_poller_hw_init(baudrate)) {
+        LOG_WARN("Card poller: I2C1 master unavailable");
+        return false;
+    }
+    LOG_INFO("Card poller: %u cards from 0x%02x at %u Hz, %s reads", (unsigned)card_count,
+             (unsigned)CARD_POLLER_FIRST_ADDRESS, (unsigned)baudrate,
+             (mode == CARD_POLLER_MODE_CHANGE) ? "change counter" : "full frame");
+    return true;
+}
+
+/**
+ * @brief Record the time of a pass
+ */
+static void prvPassTime(uint32_t *pulLast, uint32_t *pulMax, uint32_t ulPassUs)
+{
+    *pulLast = ulPassUs;
+    if (ulPassUs > *pulMax) {
+        *pulMax = ulPassUs;
+    }
+}
+
+static uint32_t prvRun(card_poll_pass_t ePass)
+{
+    uint32_t ulCount = prvPlan(ePass != CARD_POLL_PASS_HOT);
+    uint64_t ullStart = time_us_64();
+    uint32_t ulPassUs;
+
+    if (ulCount == 0) {
+        return 0;
+    }
+
+    xPollerTask = xTaskGetCurrentTaskHandle();
+    (void)ulTaskNotifyTake(pdTRUE, 0);
+
+    taskENTER_CRITICAL();
+    ulCompleted = 0;
+    ulPassChanges = 0;
+    ulPlanCount = ulCount;
+    prvBeginSlot(0);
+    taskEXIT_CRITICAL();
+
+    /* Frame reads queued by changed counters extend the pass */
+    for (uint32_t ulSlot = 0; ulSlot < ulPlanCount; ulSlot++) {
+        while (ulCompleted <= ulSlot) {
+            if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CARD_POLLER_TIMEOUT_MS)) != 0) {
+                continue;
+            }
+
+            /* Still the same transaction: give up on it and move on */
+            taskENTER_CRITICAL();
+            if (ulCompleted == ulSlot) {
+                card_poller_hw_abort();
+                prvFinishSlot(CARD_POLL_TIMEOUT);
+            }
+            taskEXIT_CRITICAL();
+        }
+        prvCheckSlot(ulSlot);
+
+        /* Every card holding the line has been read */
+        if ((ePass == CARD_POLL_PASS_ATTENTION) && (ulPassChanges != 0) &&
+            !card_poller_hw_attention()) {
+            prvEndScan();
+        }
+    }
+
+    /* Completions that came in while the task was checking */
+    (void)ulTaskNotifyTake(pdTRUE, 0);
+
+    taskENTER_CRITICAL();
+    ulCount = ulPlanCount;
+    ulPlanCount = 0;
+    ulPassUs = (uint32_t)(time_us_64() - ullStart);
+    switch (ePass) {
+    case CARD_POLL_PASS_SWEEP:
+        xStats.sweeps++;
+        prvPassTime(&xStats.sweep_last_us, &xStats.sweep_max_us, ulPassUs);
+        break;
+    case CARD_POLL_PASS_ATTENTION:
+        xStats.attention_scans++;
+        prvPassTime(&xStats.attention_last_us, &xStats.attention_max_us, ulPassUs);
+        break;
+    default:
+        xStats.hot_passes++;
+        prvPassTime(&xStats.hot_last_us, &xStats.hot_max_us, ulPassUs);
+        break;
+    }
+
+    /* A card that asserted after its read holds the line; a scan that
+     * found nothing waits for the next edge, so a stuck line is not
+     * scanned over and over */
+    if ((ePass == CARD_POLL_PASS_ATTENTION) && (ulPassChanges != 0) &&
+        card_poller_hw_attention()) {
+        xAttentionPending = true;
+    }
+    taskEXIT_CRITICAL();
+
+    return ulCount;
+}
+
+uint32_t card_poller_run(bool full_sweep)
+{
+    return prvRun(full_sweep ? CARD_POLL_PASS_SWEEP : CARD_POLL_PASS_HOT);
+}
+
+void card_poller_wait(periodic_task_t *periodic)
+{
+    bool xRescan = true;
+
+    for (;;) {
+        bool xScan;
+
+        /* A pending edge may have been notified, and taken, during a
+         * pass, and a scan re-arms itself while the line is held: one
+         * scan for those per wait, then only new edges until the
+         * release, so a card that keeps changing cannot hold the
+         * poller (and its heartbeat) here */
+        if (!(xRescan && xAttentionPending) &&
+            !periodic_wait_notify(periodic, UINT32_MAX, NULL)) {
+            return;
+        }
+        xRescan = false;
+
+        taskENTER_CRITICAL();
+        xScan = xAttentionPending;
+        xAttentionPending = false;
+        taskEXIT_CRITICAL();
+
+        if (xScan) {
+            (void)prvRun(CARD_POLL_PASS_ATTENTION);
+        }
+    }
+}
+
+void card_poller_set_attention(bool enabled)
+{
+    taskENTER_CRITICAL();
+    xAttentionEnabled = enabled;
+    xAttentionPending = false;
+    taskEXIT_CRITICAL();
+}
+
+bool card_poller_get_card(uint32_t index, card_poller_card_t *card)
+{
+    if (index >= ulCardCount) {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    *card = xCards[index];
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+void card_poller_get_stats(card_poller_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = xStats;
+    taskEXIT_CRITICAL();
+}
+
+void vCardPollerTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    static periodic_task_t xPeriodic;
+    const task_descriptor_t *pxSelf = task_table_self();
+    const uint32_t ulPassesPerSweep = CARD_POLLER_SWEEP_MS / CARD_POLLER_HOT_MS;
+    uint32_t ulPass = 0;
+    supervisor_id_t xHeartbeat;
+
+    LOG_INFO("Card Poller Task started on core %d", get_core_num());
+
+    /* The master interrupt is serviced on this (communication) core */
+    (void)card_poller_init(CARD_POLLER_MAX_CARDS, CARD_POLLER_BAUDRATE, CARD_POLLER_MODE_CHANGE);
+    card_poller_set_attention(true);
+    xHeartbeat = supervisor_register(pxSelf->name, TIMEOUT_HEARTBEAT_CARD_POLLER_MS);
+    periodic_init(&xPeriodic, pxSelf->name, pxSelf->period_ms);
+
+    for (;;)
+    {
+        supervisor_heartbeat(xHeartbeat);
+
+        (void)card_poller_run(ulPass == 0);
+        if (++ulPass >= ulPassesPerSweep) {
+            ulPass = 0;
+        }
+
+        card_poller_wait(&xPeriodic);
+    }
+}
@@ -0,0 +1,251 @@
+/**
+ * @file card_poller_i2c.c
+ * @brief I2C1 master engine for the card poller
+ *
+ * A transaction is two DMA channels and one interrupt. The TX channel
+ * writes a fixed command list to DATA_CMD, paced by the TX FIFO: the
+ * offset byte, then one read command per frame byte, the first with a
+ * repeated start and the last with a stop. The RX channel drains the
+ * frame into the card's buffer. A change counter read leaves out the
+ * offset write and reads from where the last frame read left the card.
+ * The stop interrupt (which follows a
+ * NAK abort too) reports the transaction and, through
+ * card_poller_done_from_isr(), retargets the controller and starts the
+ * next card before returning.
+ *
+ * The attention line has a raw GPIO handler of its own, so the zone
+ * input callback on the other core is left alone.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "card_poller.h"
+#include "board_pins.h"
+#include "trace.h"
+
+#define CARD_POLLER_I2C         i2c1
+#define CARD_POLLER_I2C_IRQ     I2C1_IRQ
+#define CARD_POLLER_SPIN_LIMIT  10000u  /* Polls of a bit that clears within a byte time */
+
+/* Offset write plus one read command per frame byte, and the read
+ * commands alone; each is rebuilt when the length changes */
+static uint32_t ulFrameCommands[1u + STATUS_LINK_FRAME_BYTES];
+static uint32_t ulFrameCommandBytes;
+static uint32_t ulReadCommands[STATUS_LINK_FRAME_BYTES];
+static uint32_t ulReadCommandBytes;
+
+static int lTxChannel = -1;
+static int lRxChannel = -1;
+static dma_channel_config xTxConfig;
+static dma_channel_config xRxConfig;
+static volatile bool xActive;
+static volatile bool xAborted;
+static bool xAttentionHooked;
+
+static void prvBuildFrameCommands(uint32_t ulLength)
+{
+    ulFrameCommands[0] = 0u;    /* Register offset */
+    for (uint32_t i = 1; i <= ulLength; i++) {
+        ulFrameCommands[i] = I2C_IC_DATA_CMD_CMD_BITS;
+    }
+    ulFrameCommands[1] |= I2C_IC_DATA_CMD_RESTART_BITS;
+    ulFrameCommands[ulLength] |= I2C_IC_DATA_CMD_STOP_BITS;
+    ulFrameCommandBytes = ulLength;
+}
+
+static void prvBuildReadCommands(uint32_t ulLength)
+{
+    for (uint32_t i = 0; i < ulLength; i++) {
+        ulReadCommands[i] = I2C_IC_DATA_CMD_CMD_BITS;
+    }
+    ulReadCommands[ulLength - 1u] |= I2C_IC_DATA_CMD_STOP_BITS;
+    ulReadCommandBytes = ulLength;
+}
+
+/**
+ * @brief I2C1 interrupt: NAK aborts and the end of a transaction
+ */
+static void prvCardPollerIrqHandler(void)
+{
+    i2c_hw_t *pxHw = i2c_get_hw(CARD_POLLER_I2C);
+    uint32_t ulStatus = pxHw->intr_stat;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    TRACE_ISR_ENTER(TRACE_ISR_CARD_POLLER);
+
+    if (ulStatus & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        /* The FIFO is flushed; stop feeding it before releasing it */
+        dma_channel_abort((uint)lTxChannel);
+        dma_channel_abort((uint)lRxChannel);
+        (void)pxHw->clr_tx_abrt;
+        xAborted = true;
+    }
+
+    if (ulStatus & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)pxHw->clr_stop_det;
+        if (xActive) {
+            uint32_t ulSpins = CARD_POLLER_SPIN_LIMIT;
+            bool xAcked;
+
+            /* The last byte can still be on its way to memory */
+            while (!xAborted && dma_channel_is_busy((uint)lRxChannel) && (--ulSpins > 0u)) {
+            }
+            xAcked = !xAborted && !dma_channel_is_busy((uint)lRxChannel);
+            if (!xAcked) {
+                dma_channel_abort((uint)lRxChannel);
+            }
+
+            xActive = false;
+            card_poller_done_from_isr(xAcked, &xHigherPriorityTaskWoken);
+        }
+    }
+
+    TRACE_ISR_EXIT(TRACE_ISR_CARD_POLLER);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief Attention line falling edge
+ */
+static void prvAttentionIrqHandler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (gpio_get_irq_event_mask(BOARD_PIN_EXPANSION_IN) & GPIO_IRQ_EDGE_FALL) {
+        TRACE_ISR_ENTER(TRACE_ISR_CARD_ATTENTION);
+        gpio_acknowledge_irq(BOARD_PIN_EXPANSION_IN, GPIO_IRQ_EDGE_FALL);
+        card_poller_attention_from_isr(&xHigherPriorityTaskWoken);
+        TRACE_ISR_EXIT(TRACE_ISR_CARD_ATTENTION);
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void card_poller_hw_begin(uint8_t address, uint8_t *frame, uint32_t length, bool set_offset)
+{
+    i2c_hw_t *pxHw = i2c_get_hw(CARD_POLLER_I2C);
+    const uint32_t *pulCommands;
+    uint32_t ulCommandCount;
+
+    if (set_offset) {
+        if (length != ulFrameCommandBytes) {
+            prvBuildFrameCommands(length);
+        }
+        pulCommands = ulFrameCommands;
+        ulCommandCount = length + 1u;
+    } else {
+        if (length != ulReadCommandBytes) {
+            prvBuildReadCommands(length);
+        }
+        pulCommands = ulReadCommands;
+        ulCommandCount = length;
+    }
+
+    /* The target can only change while the controller is disabled; it is
+     * idle after the previous stop */
+    pxHw->enable = 0;
+    pxHw->tar = address;
+    pxHw->enable = I2C_IC_ENABLE_ENABLE_BITS;
+
+    xAborted = false;
+    xActive = true;
+    dma_channel_configure((uint)lRxChannel, &xRxConfig, frame, &pxHw->data_cmd, length, true);
+    dma_channel_configure((uint)lTxChannel, &xTxConfig, &pxHw->data_cmd, pulCommands,
+                          ulCommandCount, true);
+}
+
+void card_poller_hw_abort(void)
+{
+    i2c_hw_t *pxHw = i2c_get_hw(CARD_POLLER_I2C);
+    uint32_t ulSpins = CARD_POLLER_SPIN_LIMIT;
+
+    xActive = false;
+    dma_channel_abort((uint)lTxChannel);
+    dma_channel_abort((uint)lRxChannel);
+
+    /* Stop the transfer on the bus, then forget its interrupts so they
+     * cannot end the next transaction */
+    hw_set_bits(&pxHw->enable, I2C_IC_ENABLE_ABORT_BITS);
+    while ((pxHw->enable & I2C_IC_ENABLE_ABORT_BITS) && (--ulSpins > 0u)) {
+    }
+    while (pxHw->rxflr != 0u) {
+        (void)pxHw->data_cmd;
+    }
+    (void)pxHw->clr_intr;
+    irq_clear(CARD_POLLER_I2C_IRQ);
+}
+
+bool card_poller_hw_init(uint32_t baudrate)
+{
+    i2c_hw_t *pxHw = i2c_get_hw(CARD_POLLER_I2C);
+
+    if (lTxChannel < 0) {
+        lTxChannel = dma_claim_unused_channel(false);
+        lRxChannel = dma_claim_unused_channel(false);
+        if ((lTxChannel < 0) || (lRxChannel < 0)) {
+            if (lTxChannel >= 0) {
+                dma_channel_unclaim((uint)lTxChannel);
+            }
+            if (lRxChannel >= 0) {
+                dma_channel_unclaim((uint)lRxChannel);
+            }
+            lTxChannel = -1;
+            lRxChannel = -1;
+            return false;
+        }
+    }
+
+    /* Whole DATA_CMD words: the command bits are above the data byte */
+    xTxConfig = dma_channel_get_default_config((uint)lTxChannel);
+    channel_config_set_transfer_data_size(&xTxConfig, DMA_SIZE_32);
+    channel_config_set_read_increment(&xTxConfig, true);
+    channel_config_set_write_increment(&xTxConfig, false);
+    channel_config_set_dreq(&xTxConfig, i2c_get_dreq(CARD_POLLER_I2C, true));
+
+    xRxConfig = dma_channel_get_default_config((uint)lRxChannel);
+    channel_config_set_transfer_data_size(&xRxConfig, DMA_SIZE_8);
+    channel_config_set_read_increment(&xRxConfig, false);
+    channel_config_set_write_increment(&xRxConfig, true);
+    channel_config_set_dreq(&xRxConfig, i2c_get_dreq(CARD_POLLER_I2C, false));
+
+    prvBuildFrameCommands(STATUS_LINK_FRAME_BYTES);
+    prvBuildReadCommands(1u);
+    xActive = false;
+
+    /* i2c_init() leaves master mode with both DMA requests enabled */
+    i2c_init(CARD_POLLER_I2C, baudrate);
+    gpio_set_function(BOARD_PIN_I2C1_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(BOARD_PIN_I2C1_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(BOARD_PIN_I2C1_SDA);
+    gpio_pull_up(BOARD_PIN_I2C1_SCL);
+
+    pxHw->intr_mask = I2C_IC_INTR_MASK_M_TX_ABRT_BITS | I2C_IC_INTR_MASK_M_STOP_DET_BITS;
+    if (irq_get_exclusive_handler(CARD_POLLER_I2C_IRQ) != prvCardPollerIrqHandler) {
+        irq_set_exclusive_handler(CARD_POLLER_I2C_IRQ, prvCardPollerIrqHandler);
+    }
+    irq_set_enabled(CARD_POLLER_I2C_IRQ, true);
+
+    /* Wired-OR attention line: cards pull it low */
+    gpio_init(BOARD_PIN_EXPANSION_IN);
+    gpio_set_dir(BOARD_PIN_EXPANSION_IN, GPIO_IN);
+    gpio_pull_up(BOARD_PIN_EXPANSION_IN);
+    if (!xAttentionHooked) {
+        gpio_add_raw_irq_handler(BOARD_PIN_EXPANSION_IN, prvAttentionIrqHandler);
+        xAttentionHooked = true;
+    }
+    gpio_set_irq_enabled(BOARD_PIN_EXPANSION_IN, GPIO_IRQ_EDGE_FALL, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+    return true;
+}
+
+bool card_poller_hw_attention(void)
+{
+    return !gpio_get(BOARD_PIN_EXPANSION_IN);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file core_channel.c
+ * @brief Single-producer single-consumer channel between the cores
+ *
+ * Lost wake-ups are ruled out by ordering: the consumer publishes
+ * "sleeping" before it re-checks the ring, the producer publishes the
+ * new head before it reads "sleeping", and a full barrier separates
+ * each store from the following load. Either the consumer sees the
+ * message or the producer sees the sleeper and rings.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "core_channel.h"
+
+#define CORE_CHANNEL_MASK   (CORE_CHANNEL_SLOTS - 1u)
+
+#if (CORE_CHANNEL_SLOTS & CORE_CHANNEL_MASK) != 0
+#error "CORE_CHANNEL_SLOTS must be a power of two"
+#endif
+
+_Static_assert(CORE_CHANNEL_NOTIFY_INDEX < configTASK_NOTIFICATION_ARRAY_ENTRIES,
+               "core channel notification index out of range");
+
+/**
+ * @brief Doorbell interrupt on the consumer's core: wake the consumer
+ */
+static void prvDoorbellHandler(void *pvContext)
+{
+    core_channel_t *pxChannel = (core_channel_t *)pvContext;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    vTaskNotifyGiveIndexedFromISR(pxChannel->consumer, CORE_CHANNEL_NOTIFY_INDEX,
+                                  &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+bool core_channel_open(core_channel_t *channel)
+{
+    memset(channel, 0, sizeof(*channel));
+    channel->consumer = xTaskGetCurrentTaskHandle();
+    return core_doorbell_init(&channel->doorbell, prvDoorbellHandler, channel);
+}
+
+bool core_channel_send(core_channel_t *channel, void *message)
+{
+    uint32_t ulHead = channel->head;
+
+    if ((ulHead - channel->tail) >= CORE_CHANNEL_SLOTS) {
+        channel->stats.full++;
+        return false;
+    }
+
+    channel->slots[ulHead & CORE_CHANNEL_MASK] = message;
+    __dmb();
+    channel->head = ulHead + 1u;
+    channel->stats.sent++;
+
+    /* The head store must be visible before "sleeping" is read */
+    __dmb();
+    if (channel->sleeping) {
+        channel->stats.doorbells++;
+        core_doorbell_ring(&channel->doorbell);
+    }
+    return true;
+}
+
+void *core_channel_receive(core_channel_t *channel, TickType_t timeout)
+{
+    uint32_t ulTail = channel->tail;
+    void *pvMessage;
+
+    while (channel->head == ulTail) {
+        /* Announce the sleep, then look again before blocking */
+        channel->sleeping = 1u;
+        __dmb();
+        if (channel->head != ulTail) {
+            channel->sleeping = 0u;
+            break;
+        }
+
+        if (ulTaskNotifyTakeIndexed(CORE_CHANNEL_NOTIFY_INDEX, pdTRUE, timeout) == 0u) {
+            channel->sleeping = 0u;
+            if (channel->head == ulTail) {
+                return NULL;
+            }
+            break;
+        }
+        channel->sleeping = 0u;
+    }
+
+    __dmb();
+    pvMessage = channel->slots[ulTail & CORE_CHANNEL_MASK];
+    __dmb();
+    channel->tail = ulTail + 1u;
+    return pvMessage;
+}
+
+void core_channel_get_stats(const core_channel_t *channel, core_channel_stats_t *stats)
+{
+    stats->sent = channel->stats.sent;
+    stats->full = channel->stats.full;
+    stats->doorbells = channel->stats.doorbells;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file core_doorbell.c
+ * @brief Cross-core doorbell on a forced timer alarm interrupt
+ *
+ * The alarm is claimed and enabled in the timer's INTE but never armed,
+ * so its raw interrupt never fires; INTF forces it. The handler clears
+ * the force bit before calling the owner, so a ring during the handler
+ * raises the interrupt again.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/timer.h"
+#include "hardware/irq.h"
+#include "hardware/structs/timer.h"
+#include "core_doorbell.h"
+
+static core_doorbell_t *pxBells[NUM_TIMERS];
+
+static void prvDoorbellIrqHandler(void)
+{
+    uint32_t ulForced = timer_hw->ints & timer_hw->intf;
+
+    for (uint32_t alarm = 0; alarm < NUM_TIMERS; alarm++) {
+        if ((ulForced & (1u << alarm)) && (pxBells[alarm] != NULL)) {
+            hw_clear_bits(&timer_hw->intf, 1u << alarm);
+            pxBells[alarm]->handler(pxBells[alarm]->context);
+        }
+    }
+}
+
+bool core_doorbell_init(core_doorbell_t *bell, core_doorbell_handler_t handler, void *context)
+{
+    int lAlarm = hardware_alarm_claim_unused(false);
+
+    if (lAlarm < 0) {
+        bell->alarm = -1;
+        return false;
+    }
+
+    bell->alarm = lAlarm;
+    bell->handler = handler;
+    bell->context = context;
+    pxBells[lAlarm] = bell;
+
+    hw_clear_bits(&timer_hw->intf, 1u << lAlarm);
+    hw_set_bits(&timer_hw->inte, 1u << lAlarm);
+    irq_set_exclusive_handler(TIMER_IRQ_0 + (uint)lAlarm, prvDoorbellIrqHandler);
+    irq_set_enabled(TIMER_IRQ_0 + (uint)lAlarm, true);
+    return true;
+}
+
+void core_doorbell_ring(core_doorbell_t *bell)
+{
+    hw_set_bits(&timer_hw->intf, 1u << bell->alarm);
+}
@@ -0,0 +1,293 @@
+/**
+ * @file cpu_load.c
+ * @brief Per-core and per-task CPU load accounting
+ *
+ * The switch hook runs on the core that switches, with interrupts
+ * masked, and only touches that core's idle state. Readers on the other
+ * core use the state's sequence counter to get a consistent copy.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cpu_load.h"
+
+#define CPU_LOAD_CORES          configNUMBER_OF_CORES
+
+/* Idle state of one core, written only by that core's switch hook */
+typedef struct {
+    volatile uint32_t sequence;         /* Odd while an update is in progress */
+    volatile uint64_t idle_us;          /* Completed idle spans */
+    volatile uint64_t idle_since_us;    /* Start of the current idle span */
+    volatile bool in_idle;
+} cpu_idle_state_t;
+
+/* Run-time history of one task, matched across updates by task number */
+typedef struct {
+    UBaseType_t task_number;
+    uint64_t run_time_us;
+    uint16_t window_peak;
+    uint16_t previous_peak;
+} cpu_task_track_t;
+
+static cpu_idle_state_t xIdleState[CPU_LOAD_CORES];
+
+/* Updater state, owned by the task calling cpu_load_update() */
+static uint64_t ullLastUpdateUs;
+static uint64_t ullLastIdleUs[CPU_LOAD_CORES];
+static uint16_t usCoreWindowPeak[CPU_LOAD_CORES];
+static uint16_t usCorePreviousPeak[CPU_LOAD_CORES];
+static uint32_t ulUpdateCount;
+static TaskStatus_t xTaskStatus[CPU_LOAD_MAX_TASKS];
+static cpu_task_track_t xTaskTrack[2][CPU_LOAD_MAX_TASKS];
+static uint32_t ulTrackCount;
+static uint32_t ulTrackIndex;
+static cpu_load_core_t xCoreStaging[CPU_LOAD_CORES];
+static cpu_load_task_t xTaskStaging[CPU_LOAD_MAX_TASKS];
+
+/* Published report, copied in and out under a critical section */
+static cpu_load_core_t xCoreReport[CPU_LOAD_CORES];
+static cpu_load_task_t xTaskReport[CPU_LOAD_MAX_TASKS];
+static uint32_t ulTaskReportCount;
+
+static bool prvIsIdleTask(TaskHandle_t xTask)
+{
+    for (BaseType_t core = 0; core < CPU_LOAD_CORES; core++) {
+        if (xTask == xTaskGetIdleTaskHandleForCore(core)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void cpu_load_task_switched_in(void)
+{
+    cpu_idle_state_t *pxState = &xIdleState[get_core_num()];
+    bool xIdle = prvIsIdleTask(xTaskGetCurrentTaskHandle());
+    uint64_t ullNow;
+
+    /* Only idle/busy transitions change the accounting */
+    if (xIdle == pxState->in_idle) {
+        return;
+    }
+
+    ullNow = time_us_64();
+    pxState->sequence++;
+    __dmb();
+    if (pxState->in_idle) {
+        pxState->idle_us += ullNow - pxState->idle_since_us;
+    } else {
+        pxState->idle_since_us = ullNow;
+    }
+    pxState->in_idle = xIdle;
+    __dmb();
+    pxState->sequence++;
+}
+
+uint64_t cpu_load_get_idle_us(uint32_t core)
+{
+    cpu_idle_state_t *pxState;
+    uint32_t ulSequence;
+    uint64_t ullIdle;
+    uint64_t ullSince;
+    bool xInIdle;
+
+    if (core >= CPU_LOAD_CORES) {
+        return 0;
+    }
+
+    pxState = &xIdleState[core];
+    do {
+        ulSequence = pxState->sequence;
+        __dmb();
+        ullIdle = pxState->idle_us;
+        ullSince = pxState->idle_since_us;
+        xInIdle = pxState->in_idle;
+        __dmb();
+    } while ((ulSequence & 1u) || (ulSequence != pxState->sequence));
+
+    /* Include the idle span still in progress */
+    if (xInIdle) {
+        ullIdle += time_us_64() - ullSince;
+    }
+    return ullIdle;
+}
+
+static uint16_t prvPermille(uint64_t ullPart, uint64_t ullWhole)
+{
+    uint64_t ullPermille = (ullPart * 1000u) / ullWhole;
+
+    return (uint16_t)((ullPermille > 1000u) ? 1000u : ullPermille);
+}
+
+static uint16_t prvMax16(uint16_t a, uint16_t b)
+{
+    return (a > b) ? a : b;
+}
+
+/**
+ * @brief Compute per-task loads from the kernel run-time counters
+ * @return Number of entries in xTaskStaging
+ */
+static uint32_t prvUpdateTasks(uint64_t ullElapsedUs, bool xNewWindow)
+{
+    cpu_task_track_t *pxPrevious = xTaskTrack[ulTrackIndex];
+    cpu_task_track_t *pxCurrent = xTaskTrack[ulTrackIndex ^ 1u];
+    UBaseType_t uxCount;
+
+    /* Returns 0 if there are more tasks than CPU_LOAD_MAX_TASKS */
+    uxCount = uxTaskGetSystemState(xTaskStatus, CPU_LOAD_MAX_TASKS, NULL);
+
+    for (UBaseType_t i = 0; i < uxCount; i++) {
+        const TaskStatus_t *pxStatus = &xTaskStatus[i];
+        cpu_task_track_t *pxTrack = &pxCurrent[i];
+        uint16_t usLoad = 0;
+
+        pxTrack->task_number = pxStatus->xTaskNumber;
+        pxTrack->run_time_us = pxStatus->ulRunTimeCounter;
+        pxTrack->window_peak = 0;
+        pxTrack->previous_peak = 0;
+
+        /* Tasks new since the last update report no load yet */
+        for (uint32_t j = 0; j < ulTrackCount; j++) {
+            if (pxPrevious[j].task_number == pxStatus->xTaskNumber) {
+                usLoad = prvPermille(pxStatus->ulRunTimeCounter - pxPrevious[j].run_time_us,
+                                     ullElapsedUs);
+                pxTrack->window_peak = pxPrevious[j].window_peak;
+                pxTrack->previous_peak = pxPrevious[j].previous_peak;
+                break;
+            }
+        }
+
+        if (xNewWindow) {
+            pxTrack->previous_peak = pxTrack->window_peak;
+            pxTrack->window_peak = 0;
+        }
+        pxTrack->window_peak = prvMax16(pxTrack->window_peak, usLoad);
+
+        strncpy(xTaskStaging[i].name, pxStatus->pcTaskName, sizeof(xTaskStaging[i].name) - 1u);
+        xTaskStaging[i].name[sizeof(xTaskStaging[i].name) - 1u] = '\0';
+        xTaskStaging[i].priority = pxStatus->uxCurrentPriority;
+        xTaskStaging[i].load_permille = usLoad;
+        xTaskStaging[i].peak_permille = prvMax16(pxTrack->window_peak, pxTrack->previous_peak);
+    }
+
+    ulTrackIndex ^= 1u;
+    ulTrackCount = uxCount;
+    return uxCount;
+}
+
+void cpu_load_update(void)
+{
+    uint64_t ullNow = time_us_64();
+    uint64_t ullElapsedUs = ullNow - ullLastUpdateUs;
+    bool xBaseline = (ulUpdateCount == 0);
+    bool xNewWindow = (ulUpdateCount % CPU_LOAD_WINDOW_UPDATES) == 0;
+    uint32_t ulTasks;
+
+    if (!xBaseline && (ullElapsedUs == 0)) {
+        return;
+    }
+
+    for (uint32_t core = 0; core < CPU_LOAD_CORES; core++) {
+        uint64_t ullIdle = cpu_load_get_idle_us(core);
+        uint16_t usLoad = 0;
+
+        if (!xBaseline) {
+            usLoad = (uint16_t)(1000u - prvPermille(ullIdle - ullLastIdleUs[core], ullElapsedUs));
+        }
+        ullLastIdleUs[core] = ullIdle;
+
+        if (xNewWindow) {
+            usCorePreviousPeak[core] = usCoreWindowPeak[core];
+            usCoreWindowPeak[core] = 0;
+        }
+        usCoreWindowPeak[core] = prvMax16(usCoreWindowPeak[core], usLoad);
+
+        xCoreStaging[core].load_permille = usLoad;
+        xCoreStaging[core].peak_permille = prvMax16(usCoreWindowPeak[core],
+                                                    usCorePreviousPeak[core]);
+        xCoreStaging[core].idle_us = ullIdle;
+    }
+
+    ulTasks = prvUpdateTasks(ullElapsedUs, xNewWindow);
+    ullLastUpdateUs = ullNow;
+    ulUpdateCount++;
+
+    taskENTER_CRITICAL();
+    memcpy(xCoreReport, xCoreStaging, sizeof(xCoreReport));
+    memcpy(xTaskReport, xTaskStaging, ulTasks * sizeof(xTaskReport[0]));
+    ulTaskReportCount = ulTasks;
+    taskEXIT_CRITICAL();
+}
+
+bool cpu_load_get_core(uint32_t core, cpu_load_core_t *load)
+{
+    if (core >= CPU_LOAD_CORES) {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    *load = xCoreReport[core];
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+uint32_t cpu_load_get_tasks(cpu_load_task_t *tasks, uint32_t max_tasks)
+{
+    uint32_t ulCount;
+
+    taskENTER_CRITICAL();
+    ulCount = (ulTaskReportCount < max_tasks) ? ulTaskReportCount : max_tasks;
+    memcpy(tasks, xTaskReport, ulCount * sizeof(tasks[0]));
+    taskEXIT_CRITICAL();
+    return ulCount;
+}
+
+int cpu_load_format(char *buffer, size_t buffer_size)
+{
+    static cpu_load_task_t xTasks[CPU_LOAD_MAX_TASKS];
+    uint32_t ulTasks = cpu_load_get_tasks(xTasks, CPU_LOAD_MAX_TASKS);
+    size_t xPos = 0;
+    int lWritten;
+
+    if (buffer_size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+
+    for (uint32_t core = 0; core < CPU_LOAD_CORES; core++) {
+        cpu_load_core_t xCore;
+
+        cpu_load_get_core(core, &xCore);
+        lWritten = snprintf(&buffer[xPos], buffer_size - xPos,
+                            "core%lu %3u.%u%% peak %3u.%u%%\n", (unsigned long)core,
+                            xCore.load_permille / 10u, xCore.load_permille % 10u,
+                            xCore.peak_permille / 10u, xCore.peak_permille % 10u);
+        if ((lWritten < 0) || ((size_t)lWritten >= buffer_size - xPos)) {
+            return (int)strlen(buffer);
+        }
+        xPos += (size_t)lWritten;
+    }
+
+    for (uint32_t i = 0; i < ulTasks; i++) {
+        lWritten = snprintf(&buffer[xPos], buffer_size - xPos,
+                            "%-*s p%-2lu %3u.%u%% peak %3u.%u%%\n",
+                            (int)(configMAX_TASK_NAME_LEN - 1), xTasks[i].name,
+                            (unsigned long)xTasks[i].priority,
+                            xTasks[i].load_permille / 10u, xTasks[i].load_permille % 10u,
+                            xTasks[i].peak_permille / 10u, xTasks[i].peak_permille % 10u);
+        if ((lWritten < 0) || ((size_t)lWritten >= buffer_size - xPos)) {
+            break;
+        }
+        xPos += (size_t)lWritten;
+    }
+
+    return (int)xPos;
+}
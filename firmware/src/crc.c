@@ -0,0 +1,191 @@
+/**
+ * @file crc.c
+ * @brief CRC-16 and CRC-32, slicing-by-4 on the CPU
+ *
+ * Table k of each CRC holds the CRC of a byte followed by k zero bytes,
+ * so the four bytes of a word are folded with four independent lookups
+ * and one XOR tree. Leading bytes up to a word boundary and the tail are
+ * done a byte at a time: the Cortex-M0+ has no unaligned loads. Words
+ * are read little endian, as both the RP2040 and the host are.
+ *
+ * The tables are built on first use. Two cores racing to build them
+ * write identical values, and the ready flag is only set after a full
+ * build, so no lock is needed.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "crc.h"
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "crc.c folds little-endian words"
+#endif
+
+#define CRC16_CCITT_POLY        0x1021u
+#define CRC32_IEEE_POLY_REV     0xEDB88320u     /* 0x04C11DB7 bit-reversed */
+#define CRC_SLICES              4u
+
+const crc_sniff_config_t crc_sniff_config[CRC_KIND_COUNT] = {
+    /* MSB-first CCITT on the low half of the sniffer, taken as is */
+    [CRC_KIND_16_CCITT] = { .calc = 0x2u, .out_rev = false, .out_inv = false,
+                            .seed = CRC16_CCITT_INIT, .mask = 0xFFFFu },
+    /* Bit-reversed input (CRC32R); reversing and inverting the result
+     * gives the LSB-first CRC with its final XOR */
+    [CRC_KIND_32_IEEE] = { .calc = 0x1u, .out_rev = true, .out_inv = true,
+                           .seed = 0xFFFFFFFFu, .mask = 0xFFFFFFFFu },
+};
+
+static uint16_t usCrc16Table[CRC_SLICES][256];
+static uint32_t ulCrc32Table[CRC_SLICES][256];
+static volatile bool xCrc16Ready;
+static volatile bool xCrc32Ready;
+
+static void prvBuildCrc16Table(void)
+{
+    for (uint32_t b = 0; b < 256u; b++) {
+        uint16_t usCrc = (uint16_t)(b << 8);
+
+        for (uint32_t i = 0; i < 8u; i++) {
+            usCrc = (usCrc & 0x8000u) ? (uint16_t)((usCrc << 1) ^ CRC16_CCITT_POLY) :
+                                        (uint16_t)(usCrc << 1);
+        }
+        usCrc16Table[0][b] = usCrc;
+    }
+    for (uint32_t k = 1; k < CRC_SLICES; k++) {
+        for (uint32_t b = 0; b < 256u; b++) {
+            uint16_t usPrev = usCrc16Table[k - 1u][b];
+
+            usCrc16Table[k][b] = (uint16_t)((usPrev << 8) ^ usCrc16Table[0][usPrev >> 8]);
+        }
+    }
+    __mem_fence_release();
+    xCrc16Ready = true;
+}
+
+static void prvBuildCrc32Table(void)
+{
+    for (uint32_t b = 0; b < 256u; b++) {
+        uint32_t ulCrc = b;
+
+        for (uint32_t i = 0; i < 8u; i++) {
+            ulCrc = (ulCrc & 1u) ? ((ulCrc >> 1) ^ CRC32_IEEE_POLY_REV) : (ulCrc >> 1);
+        }
+        ulCrc32Table[0][b] = ulCrc;
+    }
+    for (uint32_t k = 1; k < CRC_SLICES; k++) {
+        for (uint32_t b = 0; b < 256u; b++) {
+            uint32_t ulPrev = ulCrc32Table[k - 1u][b];
+
+            ulCrc32Table[k][b] = (ulPrev >> 8) ^ ulCrc32Table[0][ulPrev & 0xFFu];
+        }
+    }
+    __mem_fence_release();
+    xCrc32Ready = true;
+}
+
+/**
+ * @brief Load an aligned little-endian word
+ */
+static inline uint32_t prvLoadWord(const uint8_t *pucData)
+{
+    uint32_t ulWord;
+
+    memcpy(&ulWord, __builtin_assume_aligned(pucData, 4), sizeof(ulWord));
+    return ulWord;
+}
+
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, size_t length)
+{
+    const uint8_t *pucData = (const uint8_t *)data;
+    uint32_t ulCrc = crc;
+
+    if (!xCrc16Ready) {
+        prvBuildCrc16Table();
+    }
+
+    while ((length > 0u) && (((uintptr_t)pucData & 3u) != 0u)) {
+        ulCrc = ((ulCrc << 8) & 0xFFFFu) ^ usCrc16Table[0][(ulCrc >> 8) ^ *pucData++];
+        length--;
+    }
+
+    /* The CRC lines up with the first two bytes of the word */
+    while (length >= 4u) {
+        uint32_t ulWord = prvLoadWord(pucData);
+
+        ulCrc = (uint32_t)usCrc16Table[3][(ulWord ^ (ulCrc >> 8)) & 0xFFu] ^
+                usCrc16Table[2][((ulWord >> 8) ^ ulCrc) & 0xFFu] ^
+                usCrc16Table[1][(ulWord >> 16) & 0xFFu] ^
+                usCrc16Table[0][ulWord >> 24];
+        pucData += 4;
+        length -= 4u;
+    }
+
+    while (length > 0u) {
+        ulCrc = ((ulCrc << 8) & 0xFFFFu) ^ usCrc16Table[0][(ulCrc >> 8) ^ *pucData++];
+        length--;
+    }
+    return (uint16_t)ulCrc;
+}
+
+uint32_t crc32_ieee_update(uint32_t crc, const void *data, size_t length)
+{
+    const uint8_t *pucData = (const uint8_t *)data;
+    uint32_t ulCrc = ~crc;
+
+    if (!xCrc32Ready) {
+        prvBuildCrc32Table();
+    }
+
+    while ((length > 0u) && (((uintptr_t)pucData & 3u) != 0u)) {
+        ulCrc = (ulCrc >> 8) ^ ulCrc32Table[0][(ulCrc ^ *pucData++) & 0xFFu];
+        length--;
+    }
+
+    while (length >= 4u) {
+        ulCrc ^= prvLoadWord(pucData);
+        ulCrc = ulCrc32Table[3][ulCrc & 0xFFu] ^
+                ulCrc32Table[2][(ulCrc >> 8) & 0xFFu] ^
+                ulCrc32Table[1][(ulCrc >> 16) & 0xFFu] ^
+                ulCrc32Table[0][ulCrc >> 24];
+        pucData += 4;
+        length -= 4u;
+    }
+
+    while (length > 0u) {
+        ulCrc = (ulCrc >> 8) ^ ulCrc32Table[0][(ulCrc ^ *pucData++) & 0xFFu];
+        length--;
+    }
+    return ~ulCrc;
+}
+
+uint32_t crc_bitwise(crc_kind_t kind, const void *data, size_t length)
+{
+    const uint8_t *pucData = (const uint8_t *)data;
+
+    if (kind == CRC_KIND_16_CCITT) {
+        uint16_t usCrc = CRC16_CCITT_INIT;
+
+        for (size_t i = 0; i < length; i++) {
+            usCrc ^= (uint16_t)((uint16_t)pucData[i] << 8);
+            for (uint32_t b = 0; b < 8u; b++) {
+                usCrc = (usCrc & 0x8000u) ? (uint16_t)((usCrc << 1) ^ CRC16_CCITT_POLY) :
+                                            (uint16_t)(usCrc << 1);
+            }
+        }
+        return usCrc;
+    }
+
+    uint32_t ulCrc = 0xFFFFFFFFu;
+
+    for (size_t i = 0; i < length; i++) {
+        ulCrc ^= pucData[i];
+        for (uint32_t b = 0; b < 8u; b++) {
+            ulCrc = (ulCrc & 1u) ? ((ulCrc >> 1) ^ CRC32_IEEE_POLY_REV) : (ulCrc >> 1);
+        }
+    }
+    return ~ulCrc;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file crc_dma.c
+ * @brief CRC back end on the RP2040 DMA sniffer
+ *
+ * One claimed channel moves bytes from the source to the destination, or
+ * to a byte it overwrites when only the CRC is wanted, unpaced, with the
+ * sniffer watching it. The sniffer folds each byte into SNIFF_DATA as the
+ * channel reads it and applies the output reversal and inversion on the
+ * read, so crc_dma_finish() only waits and masks. Byte transfers keep the
+ * CRC independent of the buffer alignment.
+ *
+ * The channel and the sniffer are not locked: callers take turns (the
+ * start-up check in the system monitor, which releases the channel
+ * again, and the benchmark). crc_dma_finish() waits by polling, which
+ * costs no more than the rest of the transfer: the channel moves up to a
+ * byte per system clock.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <assert.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "crc.h"
+
+static_assert(DMA_SNIFF_CTRL_CALC_VALUE_CRC16 == 0x2u, "CRC-16 sniffer mode");
+static_assert(DMA_SNIFF_CTRL_CALC_VALUE_CRC32R == 0x1u, "CRC-32 sniffer mode");
+
+static int lCrcChannel = -1;
+static uint32_t ulCrcMask;
+static uint32_t ulEmptyCrc;
+static bool xCrcEmpty;
+static uint8_t ucCrcSink;
+
+bool crc_dma_init(void)
+{
+    if (lCrcChannel < 0) {
+        lCrcChannel = dma_claim_unused_channel(false);
+    }
+    return lCrcChannel >= 0;
+}
+
+void crc_dma_deinit(void)
+{
+    if (lCrcChannel >= 0) {
+        dma_channel_unclaim((uint)lCrcChannel);
+        lCrcChannel = -1;
+    }
+}
+
+void crc_dma_start(crc_kind_t kind, void *dst, const void *src, size_t length)
+{
+    const crc_sniff_config_t *pxSniff = &crc_sniff_config[kind];
+    dma_channel_config xConfig;
+    uint32_t ulOutput = 0;
+
+    ulCrcMask = pxSniff->mask;
+
+    /* A zero-length transfer would never start */
+    xCrcEmpty = (length == 0u);
+    if (xCrcEmpty) {
+        ulEmptyCrc = crc_bitwise(kind, src, 0);
+        return;
+    }
+
+    xConfig = dma_channel_get_default_config((uint)lCrcChannel);
+    channel_config_set_transfer_data_size(&xConfig, DMA_SIZE_8);
+    channel_config_set_read_increment(&xConfig, true);
+    channel_config_set_write_increment(&xConfig, dst != NULL);
+    channel_config_set_sniff_enable(&xConfig, true);
+
+    /* dma_sniffer_enable() rewrites the whole control register */
+    dma_sniffer_enable((uint)lCrcChannel, pxSniff->calc, true);
+    if (pxSniff->out_rev) {
+        ulOutput |= DMA_SNIFF_CTRL_OUT_REV_BITS;
+    }
+    if (pxSniff->out_inv) {
+        ulOutput |= DMA_SNIFF_CTRL_OUT_INV_BITS;
+    }
+    hw_write_masked(&dma_hw->sniff_ctrl, ulOutput,
+                    DMA_SNIFF_CTRL_OUT_REV_BITS | DMA_SNIFF_CTRL_OUT_INV_BITS);
+    dma_hw->sniff_data = pxSniff->seed;
+
+    dma_channel_configure((uint)lCrcChannel, &xConfig,
+                          (dst != NULL) ? dst : &ucCrcSink, src, length, true);
+}
+
+bool crc_dma_busy(void)
+{
+    return !xCrcEmpty && dma_channel_is_busy((uint)lCrcChannel);
+}
+
+uint32_t crc_dma_finish(void)
+{
+    uint32_t ulCrc;
+
+    if (xCrcEmpty) {
+        return ulEmptyCrc & ulCrcMask;
+    }
+    dma_channel_wait_for_finish_blocking((uint)lCrcChannel);
+    ulCrc = dma_hw->sniff_data;
+    dma_sniffer_disable();
+    return ulCrc & ulCrcMask;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file detect_kernels.c
+ * @brief Fixed-point detection kernels over arrays of zones
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "detect_kernels.h"
+
+void detect_lowpass(q16_t *state, const uint16_t *samples, uint32_t count,
+                    q15_t alpha)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        state[i] += q16_mul_q15(q16_from_raw(samples[i]) - state[i], alpha);
+    }
+}
+
+void detect_ewma(q16_t *baseline, const q16_t *input, uint32_t count,
+                 uint32_t shift, uint32_t freeze_mask)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        if ((freeze_mask & (1u << i)) == 0) {
+            baseline[i] += (input[i] - baseline[i]) >> shift;
+        }
+    }
+}
+
+uint32_t detect_rate_of_rise(q16_t *slope, q16_t *previous, const q16_t *input,
+                             uint32_t count, uint32_t shift, q16_t threshold)
+{
+    uint32_t ulMask = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        q16_t xDelta = input[i] - previous[i];
+
+        previous[i] = input[i];
+        slope[i] += (xDelta - slope[i]) >> shift;
+        ulMask |= (uint32_t)(slope[i] >= threshold) << i;
+    }
+
+    return ulMask;
+}
+
+uint32_t detect_hysteresis(const q16_t *input, const q16_t *reference,
+                           const q16_t *on, const q16_t *off, uint32_t count,
+                           uint32_t active_mask)
+{
+    uint32_t ulMask = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        q16_t xDeviation = input[i] - reference[i];
+        uint32_t ulActive = (active_mask >> i) & 1u;
+
+        /* Active zones compare against the release level, others against activation */
+        ulActive = ulActive ? (uint32_t)(xDeviation > off[i]) :
+                              (uint32_t)(xDeviation >= on[i]);
+        ulMask |= ulActive << i;
+    }
+
+    return ulMask;
+}
+
+void detect_bank_init(detect_bank_t *bank, const uint16_t *samples)
+{
+    for (uint32_t i = 0; i < bank->count; i++) {
+        bank->filtered[i] = q16_from_raw(samples[i]);
+        bank->baseline[i] = bank->filtered[i];
+        bank->previous[i] = bank->filtered[i];
+        bank->slope[i] = 0;
+    }
+    bank->level_mask = 0;
+    bank->ror_mask = 0;
+}
+
+uint32_t detect_bank_step(detect_bank_t *bank, const uint16_t *samples)
+{
+    uint32_t ulLevel = 0;
+    uint32_t ulRor = 0;
+    uint32_t ulChanged;
+    uint32_t ulFreeze = bank->level_mask | bank->ror_mask;
+
+    for (uint32_t i = 0; i < bank->count; i++) {
+        uint32_t ulBit = 1u << i;
+        q16_t xFiltered;
+        q16_t xDeviation;
+
+        /* Low-pass */
+        xFiltered = bank->filtered[i] +
+                    q16_mul_q15(q16_from_raw(samples[i]) - bank->filtered[i],
+                                bank->lowpass_alpha);
+        bank->filtered[i] = xFiltered;
+
+        /* Rate of rise */
+        bank->slope[i] += ((xFiltered - bank->previous[i]) - bank->slope[i]) >>
+                          bank->slope_shift;
+        bank->previous[i] = xFiltered;
+        if (bank->slope[i] >= bank->ror_threshold) {
+            ulRor |= ulBit;
+        }
+
+        /* Level with hysteresis against the baseline */
+        xDeviation = xFiltered - bank->baseline[i];
+        if ((ulFreeze & ulBit) == 0) {
+            bank->baseline[i] += xDeviation >> bank->baseline_shift;
+        }
+        if ((bank->level_mask & ulBit) ? (xDeviation > bank->off[i]) :
+                                         (xDeviation >= bank->on[i])) {
+            ulLevel |= ulBit;
+        }
+    }
+
+    ulChanged = (ulLevel ^ bank->level_mask) | (ulRor ^ bank->ror_mask);
+
+    bank->level_mask = ulLevel;
+    bank->ror_mask = ulRor;
+    return ulChanged;
+}
@@ -15,31 +15,31 @@
 #include "pico/stdlib.h"
 #include "hardware/clocks.h"
 #include "freertos_prototypes.h"
+#include "log.h"
+#include "trace.h"
 
 /**
- * @brief FreeRTOS port-specific configuration
+ * @brief Configure the time base for run-time statistics
  * 
- * This function can be used to perform any additional port-specific
- * configuration that cannot be done through FreeRTOSConfig.h
+ * The run-time counter is the SDK's 1 MHz timer, which is started by
+ * the runtime before main() and shared by both cores, so there is
+ * nothing to set up here.
  */
 void vPortConfigureTimerForRunTimeStats(void)
 {
-    /* This function is called if configGENERATE_RUN_TIME_STATS is set to 1 */
-    /* Configure a timer for run time stats generation if needed */
-    /* For now, we don't need run time stats, so this is empty */
 }
 
 /**
  * @brief Get the current timer value for run time stats
  * 
- * @return Current timer value in ticks
+ * The full 64-bit timer is used so task counters never wrap; the
+ * 32-bit microsecond count would wrap after 71 minutes.
+ * 
+ * @return Microseconds since boot
  */
-uint32_t ulGetRunTimeCounterValue(void)
+configRUN_TIME_COUNTER_TYPE ulGetRunTimeCounterValue(void)
 {
-    /* This function is called if configGENERATE_RUN_TIME_STATS is set to 1 */
-    /* Return the current timer value for run time stats */
-    /* For now, we use the system clock */
-    return (uint32_t)time_us_32();
+    return time_us_64();
 }
 
 /**
@@ -53,7 +53,9 @@ uint32_t ulGetRunTimeCounterValue(void)
  */
 void vAssertCalled(const char *file, int line)
 {
-    printf("ASSERTION FAILED: %s:%d\n", file, line);
+    LOG_FATAL("Assertion failed: %s:%d", file, line);
+    log_panic_flush();
+    trace_panic_dump();
     
     /* Disable interrupts */
     portDISABLE_INTERRUPTS();
@@ -0,0 +1,364 @@
+/**
+ * @file heap_profile.c
+ * @brief Per-call-site profile of the kernel heap
+ *
+ * The wrappers record under a hardware spinlock after heap_4 has done its
+ * work, so the profiler never holds the heap lock and the heap never
+ * waits for the profiler. A dump copies the tables under the lock and
+ * prints the copy with interrupts enabled.
+ *
+ * Call sites are stored as offsets from the address of
+ * heap_profile_dump(), so the host tool can place them in the ELF
+ * whatever the load address.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_profile.h"
+
+#if FACP_HEAP_PROFILE
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+#error "FACP_HEAP_PROFILE needs the kernel heap (FACP_STATIC_ALLOCATION is on)"
+#endif
+
+#define HEAP_PROFILE_MAGIC          0x46525048u     /* "HPRF" */
+#define HEAP_PROFILE_VERSION        1u
+#define HEAP_PROFILE_HEADER_WORDS   11u
+#define HEAP_PROFILE_SITE_WORDS     (7u + HEAP_PROFILE_LIFE_BUCKETS)
+
+_Static_assert(HEAP_PROFILE_HEADER_WORDS <= HEAP_PROFILE_SITE_WORDS, "header line too long");
+_Static_assert(HEAP_PROFILE_MAX_SITES <= 256, "site index must fit the live table");
+
+typedef struct {
+    uintptr_t caller;
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failures;
+    uint32_t live_bytes;
+    uint32_t peak_bytes;
+    uint32_t total_bytes;
+    uint32_t life_hist[HEAP_PROFILE_LIFE_BUCKETS];
+} heap_site_t;
+
+typedef struct {
+    void *block;
+    uint32_t size;
+    uint32_t start_ms;
+    uint8_t site;
+} heap_live_t;
+
+typedef struct {
+    uintptr_t caller;
+    uint32_t size;
+} heap_request_t;
+
+static const uint32_t ulLifeLimitsMs[HEAP_PROFILE_LIFE_BUCKETS] = {
+    10, 100, 1000, 10000, 60000, UINT32_MAX
+};
+
+static heap_site_t xSites[HEAP_PROFILE_MAX_SITES];
+static uint32_t ulSiteCount;
+static heap_live_t xLive[HEAP_PROFILE_MAX_LIVE];
+static uint32_t ulUntracked;
+static heap_request_t xPending[configNUMBER_OF_CORES];
+static heap_request_t xLastFailure;
+static spin_lock_t *pxProfileLock = NULL;
+
+/* Copy printed by the dump */
+static heap_site_t xDumpSites[HEAP_PROFILE_MAX_SITES];
+static volatile bool xDumpRequested;            /* Set by heap_profile_request_dump() */
+
+void *__real_pvPortMalloc(size_t xWantedSize);
+void __real_vPortFree(void *pv);
+
+static uint32_t prvNowMs(void)
+{
+    return to_ms_since_boot(get_absolute_time());
+}
+
+/**
+ * @brief Find or add the site of a caller (lock held)
+ * @return Site index, or HEAP_PROFILE_MAX_SITES when the table is full
+ */
+static uint32_t prvFindSite(uintptr_t xCaller)
+{
+    uint32_t i;
+
+    for (i = 0; i < ulSiteCount; i++) {
+        if (xSites[i].caller == xCaller) {
+            return i;
+        }
+    }
+    if (ulSiteCount < HEAP_PROFILE_MAX_SITES) {
+        xSites[ulSiteCount].caller = xCaller;
+        return ulSiteCount++;
+    }
+    return HEAP_PROFILE_MAX_SITES;
+}
+
+static void prvRecordAlloc(uintptr_t xCaller, void *pvBlock, size_t xSize)
+{
+    uint32_t ulSave;
+    uint32_t ulSite;
+    heap_site_t *pxSite;
+    heap_live_t *pxSlot = NULL;
+
+    if (pxProfileLock == NULL) {
+        ulUntracked++;
+        return;
+    }
+
+    ulSave = spin_lock_blocking(pxProfileLock);
+    ulSite = prvFindSite(xCaller);
+
+    if (ulSite == HEAP_PROFILE_MAX_SITES) {
+        ulUntracked++;
+    } else if (pvBlock == NULL) {
+        xSites[ulSite].failures++;
+        xLastFailure.caller = xCaller;
+        xLastFailure.size = (uint32_t)xSize;
+    } else {
+        for (uint32_t i = 0; i < HEAP_PROFILE_MAX_LIVE; i++) {
+            if (xLive[i].block == NULL) {
+                pxSlot = &xLive[i];
+                break;
+            }
+        }
+
+        /* A block that cannot be matched to its free is not charged */
+        if (pxSlot == NULL) {
+            ulUntracked++;
+        } else {
+            pxSlot->block = pvBlock;
+            pxSlot->size = (uint32_t)xSize;
+            pxSlot->start_ms = prvNowMs();
+            pxSlot->site = (uint8_t)ulSite;
+
+            pxSite = &xSites[ulSite];
+            pxSite->allocs++;
+            pxSite->total_bytes += (uint32_t)xSize;
+            pxSite->live_bytes += (uint32_t)xSize;
+            if (pxSite->live_bytes > pxSite->peak_bytes) {
+                pxSite->peak_bytes = pxSite->live_bytes;
+            }
+        }
+    }
+
+    spin_unlock(pxProfileLock, ulSave);
+}
+
+static void prvRecordFree(void *pv)
+{
+    uint32_t ulSave;
+
+    if (pxProfileLock == NULL) {
+        return;
+    }
+
+    ulSave = spin_lock_blocking(pxProfileLock);
+
+    for (uint32_t i = 0; i < HEAP_PROFILE_MAX_LIVE; i++) {
+        if (xLive[i].block == pv) {
+            heap_site_t *pxSite = &xSites[xLive[i].site];
+            uint32_t ulLifeMs = prvNowMs() - xLive[i].start_ms;
+            uint32_t ulBucket = 0;
+
+            while (ulLifeMs >= ulLifeLimitsMs[ulBucket]) {
+                ulBucket++;
+            }
+            pxSite->life_hist[ulBucket]++;
+            pxSite->frees++;
+            pxSite->live_bytes -= xLive[i].size;
+            xLive[i].block = NULL;
+            break;
+        }
+    }
+
+    spin_unlock(pxProfileLock, ulSave);
+}
+
+void *__wrap_pvPortMalloc(size_t xWantedSize)
+{
+    uintptr_t xCaller = (uintptr_t)__builtin_return_address(0);
+    void *pvBlock;
+
+    /* Kept for the malloc failed hook, which runs inside the real call */
+    if (pxProfileLock != NULL) {
+        uint32_t ulSave = spin_lock_blocking(pxProfileLock);
+        heap_request_t *pxPending = &xPending[get_core_num()];
+
+        pxPending->caller = xCaller;
+        pxPending->size = (uint32_t)xWantedSize;
+        spin_unlock(pxProfileLock, ulSave);
+    }
+
+    pvBlock = __real_pvPortMalloc(xWantedSize);
+    prvRecordAlloc(xCaller, pvBlock, xWantedSize);
+    return pvBlock;
+}
+
+void __wrap_vPortFree(void *pv)
+{
+    /* Forget the block before heap_4 can hand it out again */
+    if (pv != NULL) {
+        prvRecordFree(pv);
+    }
+    __real_vPortFree(pv);
+}
+
+void heap_profile_init(void)
+{
+    if (pxProfileLock == NULL) {
+        pxProfileLock = spin_lock_init((uint)spin_lock_claim_unused(true));
+    }
+}
+
+static uintptr_t prvAnchor(void)
+{
+    /* Clear the Thumb bit so the anchor matches the symbol in the ELF */
+    return (uintptr_t)&heap_profile_dump & ~(uintptr_t)1u;
+}
+
+static void prvPrintWords(const char *pcTag, const uint32_t *pulWords, uint32_t ulCount)
+{
+    static const char cHex[] = "0123456789abcdef";
+    char cLine[(HEAP_PROFILE_SITE_WORDS * 8u) + 1u];
+    uint32_t ulPos = 0;
+
+    for (uint32_t i = 0; i < ulCount; i++) {
+        for (uint32_t b = 0; b < 4u; b++) {
+            uint8_t ucByte = (uint8_t)(pulWords[i] >> (8u * b));
+
+            cLine[ulPos++] = cHex[ucByte >> 4];
+            cLine[ulPos++] = cHex[ucByte & 0x0Fu];
+        }
+    }
+    cLine[ulPos] = '\0';
+    printf("HEAPPROF %s %s\n", pcTag, cLine);
+}
+
+static void prvDump(const heap_request_t *pxFailure)
+{
+    uint32_t ulWords[HEAP_PROFILE_SITE_WORDS];
+    uintptr_t xAnchor = prvAnchor();
+    HeapStats_t xHeap;
+    uint32_t ulCount;
+    uint32_t ulUntrackedCopy;
+    uint32_t ulSave;
+
+    vPortGetHeapStats(&xHeap);
+
+    ulSave = spin_lock_blocking(pxProfileLock);
+    ulCount = ulSiteCount;
+    memcpy(xDumpSites, xSites, ulCount * sizeof(heap_site_t));
+    ulUntrackedCopy = ulUntracked;
+    spin_unlock(pxProfileLock, ulSave);
+
+    ulWords[0] = HEAP_PROFILE_MAGIC;
+    ulWords[1] = HEAP_PROFILE_VERSION | (ulCount << 16);
+    ulWords[2] = (uint32_t)xAnchor;
+    ulWords[3] = (uint32_t)configTOTAL_HEAP_SIZE;
+    ulWords[4] = (uint32_t)xHeap.xAvailableHeapSpaceInBytes;
+    ulWords[5] = (uint32_t)xHeap.xMinimumEverFreeBytesRemaining;
+    ulWords[6] = (uint32_t)xHeap.xSizeOfLargestFreeBlockInBytes;
+    ulWords[7] = (uint32_t)xHeap.xNumberOfFreeBlocks;
+    ulWords[8] = ulUntrackedCopy;
+    ulWords[9] = (pxFailure->caller != 0) ? (uint32_t)(pxFailure->caller - xAnchor) : 0;
+    ulWords[10] = pxFailure->size;
+    prvPrintWords("H", ulWords, HEAP_PROFILE_HEADER_WORDS);
+
+    for (uint32_t s = 0; s < ulCount; s++) {
+        const heap_site_t *pxSite = &xDumpSites[s];
+
+        ulWords[0] = (uint32_t)(pxSite->caller - xAnchor);
+        ulWords[1] = pxSite->allocs;
+        ulWords[2] = pxSite->frees;
+        ulWords[3] = pxSite->failures;
+        ulWords[4] = pxSite->live_bytes;
+        ulWords[5] = pxSite->peak_bytes;
+        ulWords[6] = pxSite->total_bytes;
+        memcpy(&ulWords[7], pxSite->life_hist, sizeof(pxSite->life_hist));
+        prvPrintWords("S", ulWords, HEAP_PROFILE_SITE_WORDS);
+    }
+
+    printf("HEAPPROF END\n");
+    fflush(stdout);
+}
+
+void heap_profile_dump(void)
+{
+    heap_request_t xFailure;
+    uint32_t ulSave;
+
+    if (pxProfileLock == NULL) {
+        return;
+    }
+
+    ulSave = spin_lock_blocking(pxProfileLock);
+    xFailure = xLastFailure;
+    spin_unlock(pxProfileLock, ulSave);
+
+    prvDump(&xFailure);
+}
+
+void heap_profile_request_dump(void)
+{
+    xDumpRequested = true;
+}
+
+void heap_profile_service(void)
+{
+    if (xDumpRequested) {
+        xDumpRequested = false;
+        heap_profile_dump();
+    }
+}
+
+void heap_profile_panic_dump(void)
+{
+    heap_request_t xFailure;
+    uint32_t ulSave;
+
+    if (pxProfileLock == NULL) {
+        return;
+    }
+
+    /* The failing request is the one in flight on this core */
+    ulSave = spin_lock_blocking(pxProfileLock);
+    xFailure = xPending[get_core_num()];
+    spin_unlock(pxProfileLock, ulSave);
+
+    prvDump(&xFailure);
+}
+
+#else /* FACP_HEAP_PROFILE */
+
+void heap_profile_init(void)
+{
+}
+
+void heap_profile_dump(void)
+{
+}
+
+void heap_profile_request_dump(void)
+{
+}
+
+void heap_profile_service(void)
+{
+}
+
+void heap_profile_panic_dump(void)
+{
+}
+
+#endif /* FACP_HEAP_PROFILE */
@@ -0,0 +1,407 @@
+/**
+ * @file log.c
+ * @brief Non-blocking logging: per-core record rings and drain task
+ * 
+ * Each core owns one ring. Writers on a core serialise by masking
+ * interrupts for the record copy, so the ring has a single producer per
+ * core; the drain task is the only consumer. Records are formatted only
+ * in the drain task, merged across cores in timestamp order, or sent as
+ * binary frames for tools/log_decode.py in tokenized builds.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "log.h"
+#include "heap_profile.h"
+#include "crc.h"
+
+#define LOG_CORES               configNUMBER_OF_CORES
+#define LOG_RING_MASK           (LOG_RING_RECORDS - 1u)
+#define LOG_LINE_LENGTH         160
+
+#if (LOG_RING_RECORDS & LOG_RING_MASK) != 0
+#error "LOG_RING_RECORDS must be a power of two"
+#endif
+
+#if LOG_TOKENIZED && defined(FACP_HOST_BUILD)
+#error "Tokenized logging needs the RP2040 linker script (config/log_tokens.ld)"
+#endif
+
+typedef struct {
+    uint64_t timestamp_us;
+    const char *fmt;
+    uint8_t level;
+    uint8_t core;
+    uint8_t nargs;
+    log_arg_t args[LOG_MAX_ARGS];
+} log_record_t;
+
+typedef struct {
+    log_record_t records[LOG_RING_RECORDS];
+    volatile uint32_t head;             /* Advanced by this core's writers */
+    volatile uint32_t tail;             /* Advanced by the drain only */
+    volatile log_core_stats_t stats;
+    uint32_t reported_drops;            /* Drain-side */
+} log_ring_t;
+
+static log_ring_t xLogRings[LOG_CORES];
+static volatile log_level_t xLogLevel = LOG_LEVEL_INFO;
+
+#if !LOG_TOKENIZED
+static const char cLevelTag[] = { 'D', 'I', 'W', 'E', 'F' };
+#endif
+
+void log_init(void)
+{
+    memset(xLogRings, 0, sizeof(xLogRings));
+}
+
+void log_set_level(log_level_t level)
+{
+    xLogLevel = level;
+}
+
+log_level_t log_get_level(void)
+{
+    return xLogLevel;
+}
+
+void log_write(log_level_t level, const char *fmt, uint32_t nargs, ...)
+{
+    va_list ap;
+    UBaseType_t uxSaved;
+    log_ring_t *pxRing;
+    uint32_t ulHead;
+
+    if (nargs > LOG_MAX_ARGS) {
+        nargs = LOG_MAX_ARGS;
+    }
+
+    /* The core cannot change while interrupts are masked */
+    uxSaved = portSET_INTERRUPT_MASK_FROM_ISR();
+    pxRing = &xLogRings[get_core_num()];
+
+    if (level < xLogLevel) {
+        pxRing->stats.filtered++;
+    } else if (((ulHead = pxRing->head) - pxRing->tail) >= LOG_RING_RECORDS) {
+        pxRing->stats.dropped++;
+    } else {
+        log_record_t *pxRecord = &pxRing->records[ulHead & LOG_RING_MASK];
+
+        pxRecord->timestamp_us = time_us_64();
+        pxRecord->fmt = fmt;
+        pxRecord->level = (uint8_t)level;
+        pxRecord->core = (uint8_t)get_core_num();
+        pxRecord->nargs = (uint8_t)nargs;
+
+        va_start(ap, nargs);
+        for (uint32_t i = 0; i < nargs; i++) {
+            pxRecord->args[i] = va_arg(ap, log_arg_t);
+        }
+        va_end(ap);
+
+        /* Publish the record before the new head */
+        __dmb();
+        pxRing->head = ulHead + 1u;
+        pxRing->stats.written++;
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSaved);
+}
+
+void log_get_stats(uint32_t core, log_core_stats_t *stats)
+{
+    if (core >= LOG_CORES) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    stats->written = xLogRings[core].stats.written;
+    stats->dropped = xLogRings[core].stats.dropped;
+    stats->filtered = xLogRings[core].stats.filtered;
+}
+
+#if LOG_TOKENIZED
+
+/**
+ * @brief Append a little-endian word to a frame
+ */
+static uint32_t prvPutWord(uint8_t *pucFrame, uint32_t ulPos, uint32_t ulWord)
+{
+    pucFrame[ulPos++] = (uint8_t)ulWord;
+    pucFrame[ulPos++] = (uint8_t)(ulWord >> 8);
+    pucFrame[ulPos++] = (uint8_t)(ulWord >> 16);
+    pucFrame[ulPos++] = (uint8_t)(ulWord >> 24);
+    return ulPos;
+}
+
+/**
+ * @brief Send one binary frame, bypassing stdio newline translation
+ */
+static void prvEmitFrame(uint32_t ulToken, uint64_t ullTimestampUs, uint8_t ucLevel,
+                         uint8_t ucCore, uint32_t ulArgs, const log_arg_t *pxArgs)
+{
+    uint8_t ucFrame[2 + 10 + (4 * LOG_MAX_ARGS) + 2];
+    uint32_t ulPos = 2;
+    uint16_t usCrc;
+
+    ulPos = prvPutWord(ucFrame, ulPos, ulToken);
+    ulPos = prvPutWord(ucFrame, ulPos, (uint32_t)ullTimestampUs);
+    ucFrame[ulPos++] = (uint8_t)((ucLevel << 4) | (ucCore & 0x0Fu));
+    ucFrame[ulPos++] = (uint8_t)ulArgs;
+    for (uint32_t i = 0; i < ulArgs; i++) {
+        ulPos = prvPutWord(ucFrame, ulPos, (uint32_t)pxArgs[i]);
+    }
+
+    ucFrame[0] = LOG_FRAME_SYNC;
+    ucFrame[1] = (uint8_t)(ulPos - 2u);
+    usCrc = crc16_ccitt(&ucFrame[1], ulPos - 1u);
+    ucFrame[ulPos++] = (uint8_t)usCrc;
+    ucFrame[ulPos++] = (uint8_t)(usCrc >> 8);
+
+    for (uint32_t i = 0; i < ulPos; i++) {
+        putchar_raw(ucFrame[i]);
+    }
+}
+
+/**
+ * @brief Send one record as a frame carrying its format token
+ */
+static void prvEmitRecord(const log_record_t *pxRecord)
+{
+    prvEmitFrame((uint32_t)(uintptr_t)pxRecord->fmt, pxRecord->timestamp_us,
+                 pxRecord->level, pxRecord->core, pxRecord->nargs, pxRecord->args);
+}
+
+/**
+ * @brief Report records lost to a full ring
+ */
+static void prvEmitDrops(uint32_t core, uint32_t ulDropped)
+{
+    const log_arg_t xArgs[2] = { core, ulDropped };
+
+    prvEmitFrame(LOG_TOKEN_DROPPED, time_us_64(), LOG_LEVEL_WARN, (uint8_t)core, 2, xArgs);
+}
+
+#else
+
+/**
+ * @brief Format one conversion with the C library
+ * 
+ * The specification is rebuilt so the argument word is passed with the
+ * type the conversion expects; length modifiers select int or long.
+ */
+static int prvFormatConversion(char *pcOut, size_t xSize, const char *pcSpec,
+                               size_t xSpecLen, bool xLong, char cConv,
+                               log_arg_t xArg)
+{
+    char cSpec[16];
+    size_t xLen = 0;
+
+    if (xSpecLen > sizeof(cSpec) - 4u) {
+        xSpecLen = sizeof(cSpec) - 4u;
+    }
+    memcpy(cSpec, pcSpec, xSpecLen);
+    xLen = xSpecLen;
+    if (xLong) {
+        cSpec[xLen++] = 'l';
+    }
+    cSpec[xLen++] = cConv;
+    cSpec[xLen] = '\0';
+
+    switch (cConv) {
+        case 'd':
+        case 'i':
+            return xLong ? snprintf(pcOut, xSize, cSpec, (long)(intptr_t)xArg) :
+                           snprintf(pcOut, xSize, cSpec, (int)(intptr_t)xArg);
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            return xLong ? snprintf(pcOut, xSize, cSpec, (unsigned long)xArg) :
+                           snprintf(pcOut, xSize, cSpec, (unsigned)xArg);
+        case 'c':
+            return snprintf(pcOut, xSize, cSpec, (int)xArg);
+        case 's':
+            return snprintf(pcOut, xSize, cSpec,
+                            (xArg != 0) ? (const char *)xArg : "(null)");
+        case 'p':
+            return snprintf(pcOut, xSize, cSpec, (void *)xArg);
+        default:
+            return snprintf(pcOut, xSize, "%%%c", cConv);
+    }
+}
+
+/**
+ * @brief Expand a record's format string with its argument words
+ */
+static size_t prvFormatBody(char *pcOut, size_t xSize, const log_record_t *pxRecord)
+{
+    const char *p = pxRecord->fmt;
+    size_t xPos = 0;
+    uint32_t ulArg = 0;
+
+    while ((*p != '\0') && (xPos + 1u < xSize)) {
+        const char *pcSpec;
+        bool xLong = false;
+        int lWritten;
+
+        if (*p != '%') {
+            pcOut[xPos++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            pcOut[xPos++] = '%';
+            p += 2;
+            continue;
+        }
+
+        /* Flags, width and precision are passed through unchanged */
+        pcSpec = p++;
+        while ((*p != '\0') && (strchr("-+ #0123456789.", *p) != NULL)) {
+            p++;
+        }
+        size_t xSpecLen = (size_t)(p - pcSpec);
+        while ((*p != '\0') && (strchr("hlzjt", *p) != NULL)) {
+            xLong |= (*p != 'h');
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+
+        if (ulArg < pxRecord->nargs) {
+            lWritten = prvFormatConversion(&pcOut[xPos], xSize - xPos, pcSpec, xSpecLen,
+                                           xLong, *p, pxRecord->args[ulArg++]);
+        } else {
+            lWritten = snprintf(&pcOut[xPos], xSize - xPos, "?");
+        }
+        p++;
+
+        if (lWritten > 0) {
+            xPos += (size_t)lWritten;
+            if (xPos >= xSize) {
+                xPos = xSize - 1u;
+            }
+        }
+    }
+
+    pcOut[xPos] = '\0';
+    return xPos;
+}
+
+/**
+ * @brief Format and write one record
+ */
+static void prvEmitRecord(const log_record_t *pxRecord)
+{
+    char cLine[LOG_LINE_LENGTH];
+    uint32_t ulSeconds = (uint32_t)(pxRecord->timestamp_us / 1000000u);
+    uint32_t ulMicros = (uint32_t)(pxRecord->timestamp_us % 1000000u);
+    int lPrefix;
+    size_t xLen;
+
+    lPrefix = snprintf(cLine, sizeof(cLine), "[%5lu.%06lu] %c%u ",
+                       (unsigned long)ulSeconds, (unsigned long)ulMicros,
+                       cLevelTag[pxRecord->level], (unsigned)pxRecord->core);
+    xLen = (size_t)lPrefix + prvFormatBody(&cLine[lPrefix], sizeof(cLine) - (size_t)lPrefix,
+                                           pxRecord);
+
+    /* Format strings may or may not end in a newline */
+    if ((xLen > 0) && (cLine[xLen - 1u] != '\n') && (xLen + 1u < sizeof(cLine))) {
+        cLine[xLen++] = '\n';
+        cLine[xLen] = '\0';
+    }
+    fputs(cLine, stdout);
+}
+
+/**
+ * @brief Report records lost to a full ring
+ */
+static void prvEmitDrops(uint32_t core, uint32_t ulDropped)
+{
+    printf("[log] core %u: %lu records dropped\n", (unsigned)core, (unsigned long)ulDropped);
+}
+
+#endif /* LOG_TOKENIZED */
+
+/**
+ * @brief Write all queued records, oldest first across the cores
+ * @return Number of records written
+ */
+static uint32_t prvDrainAll(void)
+{
+    uint32_t ulCount = 0;
+
+    for (;;) {
+        log_ring_t *pxOldest = NULL;
+        log_record_t xRecord;
+
+        for (uint32_t core = 0; core < LOG_CORES; core++) {
+            log_ring_t *pxRing = &xLogRings[core];
+
+            if (pxRing->tail == pxRing->head) {
+                continue;
+            }
+            __dmb();
+            if ((pxOldest == NULL) ||
+                (pxRing->records[pxRing->tail & LOG_RING_MASK].timestamp_us <
+                 pxOldest->records[pxOldest->tail & LOG_RING_MASK].timestamp_us)) {
+                pxOldest = pxRing;
+            }
+        }
+
+        if (pxOldest == NULL) {
+            break;
+        }
+
+        xRecord = pxOldest->records[pxOldest->tail & LOG_RING_MASK];
+        __dmb();
+        pxOldest->tail++;
+
+        prvEmitRecord(&xRecord);
+        ulCount++;
+    }
+
+    /* Report new drops once per drain pass */
+    for (uint32_t core = 0; core < LOG_CORES; core++) {
+        uint32_t ulDropped = xLogRings[core].stats.dropped;
+
+        if (ulDropped != xLogRings[core].reported_drops) {
+            prvEmitDrops(core, ulDropped - xLogRings[core].reported_drops);
+            xLogRings[core].reported_drops = ulDropped;
+        }
+    }
+
+    return ulCount;
+}
+
+void vLogDrainTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;)
+    {
+        if (prvDrainAll() != 0) {
+            fflush(stdout);
+        }
+        
+        /* Dumps requested by tasks that must not block on the console */
+        heap_profile_service();
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+    }
+}
+
+void log_panic_flush(void)
+{
+    prvDrainAll();
+    fflush(stdout);
+}
@@ -25,90 +25,34 @@
 /* Project includes */
 #include "system_init.h"
 #include "smp_config.h"
-
-/* Pin definitions based on RP2040-Zero and custom hardware */
-#define LED_STATUS_PIN      25      /* Built-in LED on RP2040-Zero */
-#define LED_POWER_PIN       2       /* Power status LED */
-#define LED_NORMAL_PIN      3       /* Normal operation LED */
-#define LED_ALARM_PIN       4       /* Alarm status LED */
-#define LED_FAULT_PIN       5       /* Fault status LED */
-
-/* Task handles */
-static TaskHandle_t xLedBlinkTaskHandle = NULL;
-static TaskHandle_t xSystemMonitorTaskHandle = NULL;
+#include "system_tasks.h"
+#include "task_table.h"
+#include "zone_table.h"
+#include "status_snapshot.h"
+#include "log.h"
+#include "supervisor.h"
+#include "msg_pool.h"
+#include "heap_profile.h"
+#include "alarm_output.h"
 
 /* Function prototypes */
-static void prvLedBlinkTask(void *pvParameters);
-static void prvSystemMonitorTask(void *pvParameters);
 static void prvSetupHardware(void);
 
-/**
- * @brief LED blink task for basic functionality test
- * 
- * This task blinks the status LED to indicate the system is running.
- * It demonstrates basic FreeRTOS task functionality.
- * 
- * @param pvParameters Task parameters (unused)
- */
-static void prvLedBlinkTask(void *pvParameters)
-{
-    (void)pvParameters;  /* Suppress unused parameter warning */
-    
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    const TickType_t xFrequency = pdMS_TO_TICKS(500);  /* 500ms blink rate */
-    
-    printf("LED Blink Task started on core %d\n", get_core_num());
-    
-    for (;;)
-    {
-        /* Toggle status LED */
-        gpio_put(LED_STATUS_PIN, !gpio_get(LED_STATUS_PIN));
-        
-        /* Wait for the next cycle */
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
-    }
-}
-
-/**
- * @brief System monitor task for watchdog and health checks
- * 
- * This task performs basic system monitoring and watchdog feeding.
- * It demonstrates higher priority task operation.
- * 
- * @param pvParameters Task parameters (unused)
- */
-static void prvSystemMonitorTask(void *pvParameters)
-{
-    (void)pvParameters;  /* Suppress unused parameter warning */
-    
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    const TickType_t xFrequency = pdMS_TO_TICKS(1000);  /* 1 second monitoring */
-    
-    printf("System Monitor Task started on core %d\n", get_core_num());
-    
-    for (;;)
-    {
-        /* Feed the watchdog */
-        watchdog_update();
-        
-        /* Perform basic health checks */
-        printf("System OK - Free heap: %d bytes\n", xPortGetFreeHeapSize());
-        
-        /* Update power LED to show system is alive */
-        gpio_put(LED_POWER_PIN, 1);
-        
-        /* Wait for the next cycle */
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
-    }
-}
-
 /**
  * @brief Setup hardware peripherals
  */
 static void prvSetupHardware(void)
 {
-    /* Initialize stdio */
+    /* Initialize stdio and the log rings */
     stdio_init_all();
+    log_init();
+    heap_profile_init();
+    
+    /* Load default configuration before any module reads it */
+    system_config_init();
+    zone_table_init(g_system_config.zone_count);
+    status_snapshot_init();
+    msg_pool_init();
     
     /* Initialize GPIO pins for LEDs */
     gpio_init(LED_STATUS_PIN);
@@ -123,23 +67,20 @@ static void prvSetupHardware(void)
     gpio_set_dir(LED_NORMAL_PIN, GPIO_OUT);
     gpio_put(LED_NORMAL_PIN, 0);
     
-    gpio_init(LED_ALARM_PIN);
-    gpio_set_dir(LED_ALARM_PIN, GPIO_OUT);
-    gpio_put(LED_ALARM_PIN, 0);
-    
     gpio_init(LED_FAULT_PIN);
     gpio_set_dir(LED_FAULT_PIN, GPIO_OUT);
     gpio_put(LED_FAULT_PIN, 0);
     
-    /* Initialize watchdog */
+    /* Zone alarm outputs and fire LEDs, off until a zone is in alarm */
+    alarm_output_init(g_system_config.alarm_fast_path_enabled);
+    
+    /* Report a watchdog reboot; the system monitor enables the watchdog */
     if (watchdog_caused_reboot()) {
-        printf("System rebooted by watchdog!\n");
+        LOG_WARN("System rebooted by watchdog!");
     }
+    supervisor_init();
     
-    /* Enable watchdog with 30 second timeout */
-    watchdog_enable(TIMEOUT_WATCHDOG_RESET_MS, 1);
-    
-    printf("Hardware initialization complete\n");
+    LOG_INFO("Hardware initialization complete");
 }
 
 /**
@@ -152,71 +93,39 @@ static void prvSetupHardware(void)
  */
 int main(void)
 {
-    BaseType_t xReturned;
-    
     /* Setup hardware peripherals */
     prvSetupHardware();
     
-    printf("\n=== FACP iZone Fire Alarm Control Panel ===\n");
-    printf("Firmware Version: 1.0.0-dev\n");
-    printf("Build Date: %s %s\n", __DATE__, __TIME__);
-    printf("Hardware: RP2040-Zero with FreeRTOS SMP\n");
-    printf("===========================================\n\n");
-    
-    /* Create the LED blink task with core affinity (Communication core) */
-    xReturned = xTaskCreateWithAffinity(
-        prvLedBlinkTask,                    /* Task function */
-        "LED_Blink",                        /* Task name */
-        TASK_STACK_SIZE_STATUS_LED,         /* Stack size */
-        NULL,                               /* Parameters */
-        TASK_PRIORITY_STATUS_LED,           /* Priority */
-        &xLedBlinkTaskHandle,               /* Task handle */
-        TASK_CORE_AFFINITY_STATUS_LED       /* Core affinity */
-    );
-    
-    if (xReturned != pdPASS) {
-        printf("Failed to create LED Blink task\n");
-        return -1;
-    }
+    LOG_INFO("=== FACP iZone Fire Alarm Control Panel ===");
+    LOG_INFO("Firmware Version: 1.0.0-dev");
+    LOG_INFO("Build Date: %s %s", __DATE__, __TIME__);
+    LOG_INFO("Hardware: RP2040-Zero with FreeRTOS SMP");
     
-    /* Create the system monitor task with core affinity (Sensor core) */
-    xReturned = xTaskCreateWithAffinity(
-        prvSystemMonitorTask,               /* Task function */
-        "SysMonitor",                       /* Task name */
-        TASK_STACK_SIZE_WATCHDOG,           /* Stack size */
-        NULL,                               /* Parameters */
-        TASK_PRIORITY_WATCHDOG,             /* Priority */
-        &xSystemMonitorTaskHandle,          /* Task handle */
-        TASK_CORE_AFFINITY_WATCHDOG         /* Core affinity */
-    );
-    
-    if (xReturned != pdPASS) {
-        printf("Failed to create System Monitor task\n");
+    /* Create every task in the task table; log output is written by the
+     * drain task from the scheduler start on */
+    if (!task_table_start()) {
+        LOG_FATAL("Task creation failed");
+        log_panic_flush();
         return -1;
     }
     
     /* Initialize and validate SMP configuration */
-    printf("Initializing SMP configuration...\n");
+    LOG_INFO("Initializing SMP configuration...");
     vPrintSMPStatus();
     
     if (xValidateSMPConfiguration() != pdTRUE)
     {
-        printf("WARNING: SMP configuration validation failed\n");
-    }
-    
-    /* Create SMP test tasks for demonstration */
-    if (xCreateSMPTestTasks() != pdTRUE)
-    {
-        printf("WARNING: Failed to create SMP test tasks\n");
+        LOG_WARN("SMP configuration validation failed");
     }
     
-    printf("Starting FreeRTOS scheduler...\n");
+    LOG_INFO("Starting FreeRTOS scheduler...");
     
     /* Start the FreeRTOS scheduler */
     vTaskStartScheduler();
     
     /* Should never reach here if scheduler starts successfully */
-    printf("ERROR: FreeRTOS scheduler failed to start!\n");
+    LOG_FATAL("FreeRTOS scheduler failed to start!");
+    log_panic_flush();
     
     /* Infinite loop in case of scheduler failure */
     for (;;) {
@@ -0,0 +1,261 @@
+/**
+ * @file msg_pool.c
+ * @brief Fixed-block message pools with per-core caches
+ *
+ * The Cortex-M0+ has no exclusive load/store, so the fast path relies on
+ * each core owning its cache: with the core's interrupts masked nothing
+ * else can touch it. Only a refill or flush of MSG_POOL_CACHE_BATCH
+ * blocks takes the hardware spinlock of the global freelist.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "msg_pool.h"
+
+#define MSG_POOL_CORES      configNUMBER_OF_CORES
+
+_Static_assert((MSG_POOL_SMALL_SIZE % 8u) == 0 && (MSG_POOL_MEDIUM_SIZE % 8u) == 0 &&
+               (MSG_POOL_LARGE_SIZE % 8u) == 0, "block sizes must keep 8-byte alignment");
+_Static_assert(MSG_POOL_SMALL_SIZE < MSG_POOL_MEDIUM_SIZE &&
+               MSG_POOL_MEDIUM_SIZE < MSG_POOL_LARGE_SIZE, "classes must grow in size");
+_Static_assert(MSG_POOL_CACHE_BATCH <= MSG_POOL_CACHE_BLOCKS, "batch larger than the cache");
+
+typedef struct msg_block {
+    struct msg_block *next;
+} msg_block_t;
+
+/* Free blocks held by one core; touched by that core only */
+typedef struct {
+    msg_block_t *blocks[MSG_POOL_CACHE_BLOCKS];
+    uint32_t count;
+    uint32_t allocs;
+    uint32_t frees;
+} msg_cache_t;
+
+typedef struct {
+    uint8_t *base;
+    uint8_t *limit;
+    uint32_t block_size;
+    uint32_t blocks;
+    msg_block_t *free_list;     /* Under pxPoolLock */
+    uint32_t free_count;
+    uint32_t high_water;
+    uint32_t exhausted;
+    msg_cache_t caches[MSG_POOL_CORES];
+} msg_class_t;
+
+static uint64_t ullSmallStorage[(MSG_POOL_SMALL_SIZE * MSG_POOL_SMALL_BLOCKS) / 8u];
+static uint64_t ullMediumStorage[(MSG_POOL_MEDIUM_SIZE * MSG_POOL_MEDIUM_BLOCKS) / 8u];
+static uint64_t ullLargeStorage[(MSG_POOL_LARGE_SIZE * MSG_POOL_LARGE_BLOCKS) / 8u];
+
+static msg_class_t xClasses[MSG_POOL_CLASS_COUNT];
+static spin_lock_t *pxPoolLock = NULL;
+
+static void prvInitClass(msg_class_t *pxClass, uint64_t *pullStorage,
+                         uint32_t ulBlockSize, uint32_t ulBlocks)
+{
+    memset(pxClass, 0, sizeof(*pxClass));
+    pxClass->base = (uint8_t *)pullStorage;
+    pxClass->limit = pxClass->base + ((size_t)ulBlockSize * ulBlocks);
+    pxClass->block_size = ulBlockSize;
+    pxClass->blocks = ulBlocks;
+
+    /* Chain from the top so the first allocations come from the base */
+    for (uint32_t i = ulBlocks; i > 0; i--) {
+        msg_block_t *pxBlock = (msg_block_t *)(pxClass->base + ((size_t)(i - 1u) * ulBlockSize));
+
+        pxBlock->next = pxClass->free_list;
+        pxClass->free_list = pxBlock;
+    }
+    pxClass->free_count = ulBlocks;
+}
+
+/**
+ * @brief Move up to one batch from the global list into a core cache
+ * @return Blocks moved
+ */
+static uint32_t prvRefill(msg_class_t *pxClass, msg_cache_t *pxCache)
+{
+    uint32_t ulSave = spin_lock_blocking(pxPoolLock);
+    uint32_t ulMoved = 0;
+    uint32_t ulOut;
+
+    while ((ulMoved < MSG_POOL_CACHE_BATCH) && (pxClass->free_list != NULL)) {
+        pxCache->blocks[pxCache->count++] = pxClass->free_list;
+        pxClass->free_list = pxClass->free_list->next;
+        ulMoved++;
+    }
+    pxClass->free_count -= ulMoved;
+
+    ulOut = pxClass->blocks - pxClass->free_count;
+    if (ulOut > pxClass->high_water) {
+        pxClass->high_water = ulOut;
+    }
+    if (ulMoved == 0) {
+        pxClass->exhausted++;
+    }
+
+    spin_unlock(pxPoolLock, ulSave);
+    return ulMoved;
+}
+
+/**
+ * @brief Return one batch from a full core cache to the global list
+ */
+static void prvFlush(msg_class_t *pxClass, msg_cache_t *pxCache)
+{
+    uint32_t ulSave = spin_lock_blocking(pxPoolLock);
+
+    for (uint32_t i = 0; i < MSG_POOL_CACHE_BATCH; i++) {
+        msg_block_t *pxBlock = pxCache->blocks[--pxCache->count];
+
+        pxBlock->next = pxClass->free_list;
+        pxClass->free_list = pxBlock;
+    }
+    pxClass->free_count += MSG_POOL_CACHE_BATCH;
+
+    spin_unlock(pxPoolLock, ulSave);
+}
+
+void msg_pool_init(void)
+{
+    if (pxPoolLock == NULL) {
+        pxPoolLock = spin_lock_init((uint)spin_lock_claim_unused(true));
+    }
+
+    prvInitClass(&xClasses[MSG_POOL_SMALL], ullSmallStorage,
+                 MSG_POOL_SMALL_SIZE, MSG_POOL_SMALL_BLOCKS);
+    prvInitClass(&xClasses[MSG_POOL_MEDIUM], ullMediumStorage,
+                 MSG_POOL_MEDIUM_SIZE, MSG_POOL_MEDIUM_BLOCKS);
+    prvInitClass(&xClasses[MSG_POOL_LARGE], ullLargeStorage,
+                 MSG_POOL_LARGE_SIZE, MSG_POOL_LARGE_BLOCKS);
+}
+
+void *msg_pool_alloc(size_t size)
+{
+    msg_class_t *pxClass = NULL;
+    msg_cache_t *pxCache;
+    msg_block_t *pxBlock = NULL;
+    UBaseType_t uxSaved;
+
+    for (uint32_t i = 0; i < MSG_POOL_CLASS_COUNT; i++) {
+        if (size <= xClasses[i].block_size) {
+            pxClass = &xClasses[i];
+            break;
+        }
+    }
+    if (pxClass == NULL) {
+        return NULL;
+    }
+
+    /* The core cannot change while interrupts are masked */
+    uxSaved = portSET_INTERRUPT_MASK_FROM_ISR();
+    pxCache = &pxClass->caches[get_core_num()];
+
+    if ((pxCache->count > 0) || (prvRefill(pxClass, pxCache) > 0)) {
+        pxBlock = pxCache->blocks[--pxCache->count];
+        pxCache->allocs++;
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSaved);
+    return pxBlock;
+}
+
+void msg_pool_free(void *block)
+{
+    uint8_t *pucBlock = (uint8_t *)block;
+    msg_class_t *pxClass = NULL;
+    msg_cache_t *pxCache;
+    UBaseType_t uxSaved;
+
+    if (block == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < MSG_POOL_CLASS_COUNT; i++) {
+        if ((pucBlock >= xClasses[i].base) && (pucBlock < xClasses[i].limit)) {
+            pxClass = &xClasses[i];
+            break;
+        }
+    }
+    configASSERT(pxClass != NULL);
+    configASSERT(((size_t)(pucBlock - pxClass->base) % pxClass->block_size) == 0);
+
+    uxSaved = portSET_INTERRUPT_MASK_FROM_ISR();
+    pxCache = &pxClass->caches[get_core_num()];
+
+    if (pxCache->count == MSG_POOL_CACHE_BLOCKS) {
+        prvFlush(pxClass, pxCache);
+    }
+    pxCache->blocks[pxCache->count++] = (msg_block_t *)block;
+    pxCache->frees++;
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSaved);
+}
+
+bool msg_pool_get_stats(msg_pool_class_t cls, msg_pool_stats_t *stats)
+{
+    const msg_class_t *pxClass;
+    uint32_t ulAllocs = 0;
+    uint32_t ulFrees = 0;
+    uint32_t ulSave;
+
+    if ((uint32_t)cls >= MSG_POOL_CLASS_COUNT) {
+        return false;
+    }
+    pxClass = &xClasses[cls];
+
+    /* Frees are summed first so a block freed on the other core while
+     * reading is never counted without its allocation */
+    for (uint32_t c = 0; c < MSG_POOL_CORES; c++) {
+        ulFrees += pxClass->caches[c].frees;
+    }
+    __dmb();
+    for (uint32_t c = 0; c < MSG_POOL_CORES; c++) {
+        ulAllocs += pxClass->caches[c].allocs;
+    }
+
+    ulSave = spin_lock_blocking(pxPoolLock);
+    stats->block_size = pxClass->block_size;
+    stats->blocks = pxClass->blocks;
+    stats->high_water = pxClass->high_water;
+    stats->exhausted = pxClass->exhausted;
+    spin_unlock(pxPoolLock, ulSave);
+
+    stats->in_use = ulAllocs - ulFrees;
+    return true;
+}
+
+bool msg_queue_init(msg_queue_t *queue, void **storage, UBaseType_t length)
+{
+    queue->handle = xQueueCreateStatic(length, sizeof(void *), (uint8_t *)storage,
+                                       &queue->control);
+    return queue->handle != NULL;
+}
+
+bool msg_queue_send(msg_queue_t *queue, void *block, TickType_t timeout)
+{
+    return xQueueSend(queue->handle, &block, timeout) == pdTRUE;
+}
+
+bool msg_queue_send_from_isr(msg_queue_t *queue, void *block,
+                             BaseType_t *higher_priority_woken)
+{
+    return xQueueSendFromISR(queue->handle, &block, higher_priority_woken) == pdTRUE;
+}
+
+void *msg_queue_receive(msg_queue_t *queue, TickType_t timeout)
+{
+    void *pvBlock = NULL;
+
+    if (xQueueReceive(queue->handle, &pvBlock, timeout) != pdTRUE) {
+        return NULL;
+    }
+    return pvBlock;
+}
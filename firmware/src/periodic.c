@@ -0,0 +1,215 @@
+/**
+ * @file periodic.c
+ * @brief Periodic task timing monitor
+ *
+ * Times come from the 1 MHz timer, which runs off the same reference as
+ * the tick, so ideal releases can be kept in microseconds without
+ * drifting from the tick-based vTaskDelayUntil() schedule.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "periodic.h"
+
+static const uint32_t ulBucketLimitsUs[PERIODIC_HIST_BUCKETS] = {
+    50, 100, 250, 500, 1000, 2500, 10000, UINT32_MAX
+};
+
+static periodic_task_t *pxTasks[PERIODIC_MAX_TASKS];
+static volatile uint32_t ulTaskCount;
+
+static void prvHistogramAdd(uint32_t *pulHist, uint32_t *pulMax, uint32_t ulValueUs)
+{
+    uint32_t ulBucket = 0;
+
+    while (ulValueUs >= ulBucketLimitsUs[ulBucket]) {
+        ulBucket++;
+    }
+    pulHist[ulBucket]++;
+
+    if (ulValueUs > *pulMax) {
+        *pulMax = ulValueUs;
+    }
+}
+
+static uint32_t prvClampUs(uint64_t ullUs)
+{
+    return (ullUs > UINT32_MAX) ? UINT32_MAX : (uint32_t)ullUs;
+}
+
+/**
+ * @brief Close the running cycle: execution time and deadline check
+ */
+static void prvEndCycle(periodic_task_t *pxTask)
+{
+    uint64_t ullNow;
+
+    if (!pxTask->in_cycle) {
+        return;
+    }
+
+    ullNow = time_us_64();
+    prvHistogramAdd(pxTask->stats.exec_hist, &pxTask->stats.exec_max_us,
+                    prvClampUs(ullNow - pxTask->release_us));
+    if (ullNow > pxTask->next_release_us) {
+        pxTask->stats.misses++;
+    }
+    pxTask->in_cycle = false;
+}
+
+/**
+ * @brief Start a cycle at the current time: lateness against the ideal release
+ */
+static void prvStartCycle(periodic_task_t *pxTask)
+{
+    uint64_t ullNow = time_us_64();
+    uint64_t ullPeriodUs = (uint64_t)pxTask->stats.period_ms * 1000u;
+
+    /* Anchor the ideal schedule to the first wake-up, which follows a tick */
+    if (pxTask->stats.cycles == 0) {
+        pxTask->next_release_us = ullNow;
+    }
+
+    prvHistogramAdd(pxTask->stats.late_hist, &pxTask->stats.late_max_us,
+                    (ullNow > pxTask->next_release_us) ?
+                        prvClampUs(ullNow - pxTask->next_release_us) : 0);
+
+    pxTask->release_us = ullNow;
+    pxTask->next_release_us += ullPeriodUs;
+    pxTask->in_cycle = true;
+    pxTask->stats.cycles++;
+}
+
+void periodic_init(periodic_task_t *task, const char *name, uint32_t period_ms)
+{
+    /* The work before the first wait is not a timed cycle */
+    memset(task, 0, sizeof(*task));
+    task->stats.name = name;
+    task->stats.period_ms = period_ms;
+    task->period_ticks = pdMS_TO_TICKS(period_ms);
+    task->last_wake = xTaskGetTickCount();
+
+    taskENTER_CRITICAL();
+    if (ulTaskCount < PERIODIC_MAX_TASKS) {
+        pxTasks[ulTaskCount] = task;
+        __dmb();
+        ulTaskCount++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void periodic_wait(periodic_task_t *task)
+{
+    prvEndCycle(task);
+    xTaskDelayUntil(&task->last_wake, task->period_ticks);
+    prvStartCycle(task);
+}
+
+bool periodic_wait_notify(periodic_task_t *task, uint32_t clear_bits, uint32_t *notified)
+{
+    TickType_t xRemaining;
+
+    prvEndCycle(task);
+
+    /* Overdue when the remaining time wraps past half the tick range;
+     * the release then comes before any pending notification */
+    xRemaining = (task->last_wake + task->period_ticks) - xTaskGetTickCount();
+    if ((xRemaining != 0) && (xRemaining <= (portMAX_DELAY / 2u)) &&
+        (xTaskNotifyWait(0, clear_bits, notified, xRemaining) == pdTRUE)) {
+        return true;
+    }
+
+    task->last_wake += task->period_ticks;
+    prvStartCycle(task);
+    return false;
+}
+
+uint32_t periodic_get_task_count(void)
+{
+    return ulTaskCount;
+}
+
+bool periodic_get_stats(uint32_t index, periodic_stats_t *stats)
+{
+    if (index >= ulTaskCount) {
+        return false;
+    }
+
+    __dmb();
+    memcpy(stats, (const void *)&pxTasks[index]->stats, sizeof(*stats));
+    return true;
+}
+
+uint32_t periodic_get_bucket_limit_us(uint32_t bucket)
+{
+    return (bucket < PERIODIC_HIST_BUCKETS) ? ulBucketLimitsUs[bucket] : UINT32_MAX;
+}
+
+static size_t prvFormatHistogram(char *pcBuffer, size_t xSize, const char *pcLabel,
+                                 const uint32_t *pulHist)
+{
+    size_t xPos = 0;
+    int lWritten;
+
+    for (uint32_t b = 0; b <= PERIODIC_HIST_BUCKETS + 1u; b++) {
+        if (b == 0) {
+            lWritten = snprintf(pcBuffer, xSize, "  %s", pcLabel);
+        } else if (b <= PERIODIC_HIST_BUCKETS) {
+            lWritten = snprintf(&pcBuffer[xPos], xSize - xPos, " %lu", (unsigned long)pulHist[b - 1u]);
+        } else {
+            lWritten = snprintf(&pcBuffer[xPos], xSize - xPos, "\n");
+        }
+
+        /* Drop a field that does not fit */
+        if ((lWritten < 0) || ((size_t)lWritten >= xSize - xPos)) {
+            pcBuffer[xPos] = '\0';
+            break;
+        }
+        xPos += (size_t)lWritten;
+    }
+    return xPos;
+}
+
+int periodic_format(char *buffer, size_t buffer_size)
+{
+    static periodic_stats_t xStats;
+    uint32_t ulCount = periodic_get_task_count();
+    size_t xPos = 0;
+    int lWritten;
+
+    if (buffer_size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+
+    lWritten = snprintf(buffer, buffer_size,
+                        "buckets(us) <50 <100 <250 <500 <1000 <2500 <10000 more\n");
+    if ((lWritten < 0) || ((size_t)lWritten >= buffer_size)) {
+        return (int)strlen(buffer);
+    }
+    xPos = (size_t)lWritten;
+
+    for (uint32_t i = 0; i < ulCount; i++) {
+        periodic_get_stats(i, &xStats);
+        lWritten = snprintf(&buffer[xPos], buffer_size - xPos,
+                            "%-*s %5lums cycles %lu miss %lu late max %luus exec max %luus\n",
+                            (int)(configMAX_TASK_NAME_LEN - 1), xStats.name,
+                            (unsigned long)xStats.period_ms, (unsigned long)xStats.cycles,
+                            (unsigned long)xStats.misses, (unsigned long)xStats.late_max_us,
+                            (unsigned long)xStats.exec_max_us);
+        if ((lWritten < 0) || ((size_t)lWritten >= buffer_size - xPos)) {
+            buffer[xPos] = '\0';
+            break;
+        }
+        xPos += (size_t)lWritten;
+        xPos += prvFormatHistogram(&buffer[xPos], buffer_size - xPos, "late", xStats.late_hist);
+        xPos += prvFormatHistogram(&buffer[xPos], buffer_size - xPos, "exec", xStats.exec_hist);
+    }
+
+    return (int)xPos;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file sensor_monitor.c
+ * @brief Sensor monitoring task implementation
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "task_table.h"
+#include "zone_input.h"
+#include "adc_stream.h"
+#include "zone_table.h"
+#include "status_snapshot.h"
+#include "sensor_monitor.h"
+#include "supervisor.h"
+#include "alarm_output.h"
+#include "status_link.h"
+#include "log.h"
+
+_Static_assert(ALARM_OUTPUT_ZONES == SENSOR_MONITOR_INPUT_ZONES,
+               "one alarm output per input zone");
+
+/* Time of the last rising edge of each fire input, for output latency */
+static uint64_t ullFireEdgeUs[SENSOR_MONITOR_INPUT_ZONES];
+
+/* Zones to reset at the next wake-up */
+static volatile uint32_t ulResetPending;
+
+/**
+ * @brief Drain all queued edges of the zone inputs
+ */
+static void prvDrainZoneInputs(void)
+{
+    zone_edge_t xEdge;
+
+    for (uint32_t ch = 0; ch < ZONE_INPUT_CHANNEL_COUNT; ch++) {
+        while (zone_input_pop((zone_input_channel_t)ch, &xEdge)) {
+            /* Levels are tracked by zone_input; only the latest one matters */
+            if (xEdge.level && (ch < (ZONE_INPUT_FIRE_1 + SENSOR_MONITOR_INPUT_ZONES))) {
+                ullFireEdgeUs[ch - ZONE_INPUT_FIRE_1] = xEdge.timestamp_us;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Recompute zone and system status from the input levels
+ * @param ulFastSeen Fast path outputs asserted before the edges were drained
+ */
+static void prvUpdateStatus(uint32_t ulFastSeen)
+{
+    uint32_t ulAlarm = 0;
+    uint32_t ulFault = 0;
+    uint32_t ulVerified = 0;
+
+    /* Both bits may be set; the table gives fire precedence over fault */
+    for (uint32_t zone = 0; zone < SENSOR_MONITOR_INPUT_ZONES; zone++) {
+        if (zone_input_get_level((zone_input_channel_t)(ZONE_INPUT_FIRE_1 + zone))) {
+            ulAlarm |= ZONE_MASK_BIT(zone);
+        }
+        if (zone_input_get_level((zone_input_channel_t)(ZONE_INPUT_FAULT_1 + zone))) {
+            ulFault |= ZONE_MASK_BIT(zone);
+        }
+    }
+
+    zone_table_update(0, SENSOR_MONITOR_ZONE_MASK, ulAlarm, ulFault,
+                      to_ms_since_boot(get_absolute_time()));
+
+    /* Outputs follow the table, which leaves out disabled zones */
+    for (uint32_t zone = 0; zone < SENSOR_MONITOR_INPUT_ZONES; zone++) {
+        if (zone_table_get_status(zone) == ZONE_STATUS_ALARM) {
+            ulVerified |= ZONE_MASK_BIT(zone);
+        }
+    }
+    alarm_output_update(ulVerified, ulFastSeen, ullFireEdgeUs);
+
+    /* Zones and derived status in one publish; test mode is left alone */
+    status_snapshot_publish_zones(zone_table_system_status());
+}
+
+/**
+ * @brief Clear the latched alarms of the zones waiting for a reset
+ * @return true if a zone left alarm
+ */
+static bool prvResetAlarms(void)
+{
+    uint32_t ulZones = __atomic_exchange_n(&ulResetPending, 0u, __ATOMIC_ACQ_REL);
+    uint32_t ulCleared;
+
+    ulCleared = zone_table_reset_alarm(0, ulZones & SENSOR_MONITOR_ZONE_MASK,
+                                       to_ms_since_boot(get_absolute_time()));
+    if (ulCleared != 0) {
+        LOG_INFO("Alarm reset: zones 0x%02x", (unsigned)ulCleared);
+    }
+    return ulCleared != 0;
+}
+
+void sensor_monitor_reset_alarms(uint32_t zones)
+{
+    TaskHandle_t xTask = sensor_monitor_get_task();
+
+    __atomic_fetch_or(&ulResetPending, zones, __ATOMIC_ACQ_REL);
+    if (xTask != NULL) {
+        xTaskNotify(xTask, SENSOR_MONITOR_RESET_NOTIFY_BIT, eSetBits);
+    }
+}
+
+void vSensorMonitorTask(void *pvParameters)
+{
+    (void)pvParameters;  /* Suppress unused parameter warning */
+    
+    uint32_t ulNotifiedValue;
+    supervisor_id_t xHeartbeat;
+    TickType_t xLastPublish = xTaskGetTickCount();
+    bool xPublishPending = false;
+
+    LOG_INFO("Sensor Monitor Task started on core %d", get_core_num());
+
+    /* Edge and DMA interrupts are serviced on this task's core */
+    zone_input_init(xTaskGetCurrentTaskHandle());
+    prvUpdateStatus(alarm_output_get_fast_pending());
+
+    if (!adc_stream_start(xTaskGetCurrentTaskHandle(), g_system_config.adc_sample_hz,
+                          g_system_config.adc_oversample,
+                          g_system_config.adc_temp_sensor_enabled)) {
+        LOG_WARN("Sensor Monitor: analog sampling unavailable");
+    }
+
+    xHeartbeat = supervisor_register(task_table_self()->name, TIMEOUT_HEARTBEAT_SENSOR_MS);
+
+    for (;;)
+    {
+        supervisor_heartbeat(xHeartbeat);
+
+        /* Sleep until an input source signals new data; retry a
+         * deferred status frame on the next tick */
+        ulNotifiedValue = 0;
+        xTaskNotifyWait(0, ZONE_INPUT_NOTIFY_MASK | ADC_STREAM_NOTIFY_BIT |
+                           SENSOR_MONITOR_RESET_NOTIFY_BIT, &ulNotifiedValue,
+                        xPublishPending ? 1 : pdMS_TO_TICKS(SENSOR_MONITOR_IDLE_WAKE_MS));
+
+        if ((ulNotifiedValue & ZONE_INPUT_NOTIFY_MASK) != 0) {
+            uint32_t ulFastSeen = alarm_output_get_fast_pending();
+
+            prvDrainZoneInputs();
+            prvUpdateStatus(ulFastSeen);
+            xPublishPending = true;
+        }
+
+        /* Zones still in alarm latch again in the update; fast
+         * assertions with undrained edges are left alone */
+        if (((ulNotifiedValue & SENSOR_MONITOR_RESET_NOTIFY_BIT) != 0) && prvResetAlarms()) {
+            prvUpdateStatus(0);
+            xPublishPending = true;
+        }
+
+        if ((ulNotifiedValue & ADC_STREAM_NOTIFY_BIT) != 0) {
+            adc_stream_process();
+        }
+
+        /* Zone changes go to the status link at once, health at least
+         * every STATUS_LINK_REFRESH_MS */
+        if ((xTaskGetTickCount() - xLastPublish) >= pdMS_TO_TICKS(STATUS_LINK_REFRESH_MS)) {
+            xPublishPending = true;
+        }
+        if (xPublishPending && status_link_publish()) {
+            xPublishPending = false;
+            xLastPublish = xTaskGetTickCount();
+        }
+    }
+}
+
+TaskHandle_t sensor_monitor_get_task(void)
+{
+    return task_table_get_handle(TASK_ID_SENSOR_MONITOR);
+}
+
+zone_status_t sensor_monitor_get_zone_status(uint32_t zone)
+{
+    return (zone < SENSOR_MONITOR_INPUT_ZONES) ? zone_table_get_status(zone) :
+                                                 ZONE_STATUS_DISABLED;
+}
@@ -9,13 +9,17 @@
  * @date 2024
  */
 
-#include <stdio.h>
 #include "smp_config.h"
 #include "pico/multicore.h"
 #include "hardware/sync.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include "log.h"
+#include "periodic.h"
+#include "task_table.h"
+#include "system_init.h"
 
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
 /**
  * @brief Create a task with specified core affinity
  */
@@ -44,77 +48,17 @@ BaseType_t xTaskCreateWithAffinity(
     /* Set core affinity if task creation was successful */
     if ((xResult == pdPASS) && (pxCreatedTask != NULL) && (*pxCreatedTask != NULL))
     {
+#if (configUSE_CORE_AFFINITY == 1) && (configNUMBER_OF_CORES > 1)
         vTaskCoreAffinitySet(*pxCreatedTask, uxCoreAffinityMask);
+#endif
         
-        printf("Task '%s' created with core affinity: 0x%02X\n", 
-               pcName, (unsigned int)uxCoreAffinityMask);
+        LOG_DEBUG("Task '%s' created with core affinity: 0x%02X",
+                  pcName, (unsigned int)uxCoreAffinityMask);
     }
     
     return xResult;
 }
-
-/**
- * @brief Create a fire safety sensor monitoring task
- */
-BaseType_t xCreateSensorTask(
-    TaskFunction_t pxTaskCode,
-    const char * const pcName,
-    void * const pvParameters,
-    TaskHandle_t * const pxCreatedTask
-)
-{
-    return xTaskCreateWithAffinity(
-        pxTaskCode,
-        pcName,
-        TASK_STACK_SIZE_SENSOR_MONITOR,
-        pvParameters,
-        TASK_PRIORITY_SENSOR_MONITOR,
-        pxCreatedTask,
-        TASK_CORE_AFFINITY_SENSOR_MONITOR
-    );
-}
-
-/**
- * @brief Create a communication task
- */
-BaseType_t xCreateCommunicationTask(
-    TaskFunction_t pxTaskCode,
-    const char * const pcName,
-    void * const pvParameters,
-    TaskHandle_t * const pxCreatedTask
-)
-{
-    return xTaskCreateWithAffinity(
-        pxTaskCode,
-        pcName,
-        TASK_STACK_SIZE_COMMUNICATION,
-        pvParameters,
-        TASK_PRIORITY_COMMUNICATION,
-        pxCreatedTask,
-        TASK_CORE_AFFINITY_COMMUNICATION
-    );
-}
-
-/**
- * @brief Create an alarm control task
- */
-BaseType_t xCreateAlarmTask(
-    TaskFunction_t pxTaskCode,
-    const char * const pcName,
-    void * const pvParameters,
-    TaskHandle_t * const pxCreatedTask
-)
-{
-    return xTaskCreateWithAffinity(
-        pxTaskCode,
-        pcName,
-        TASK_STACK_SIZE_ALARM_CONTROL,
-        pvParameters,
-        TASK_PRIORITY_ALARM_CONTROL,
-        pxCreatedTask,
-        TASK_CORE_AFFINITY_ALARM_CONTROL
-    );
-}
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 
 /**
  * @brief Get the current core number for the calling task
@@ -125,26 +69,17 @@ uint32_t ulGetCurrentCore(void)
 }
 
 /**
- * @brief Print SMP status and task distribution
+ * @brief Log SMP status and task distribution
  */
 void vPrintSMPStatus(void)
 {
-    printf("\n=== SMP Configuration Status ===\n");
-    printf("Number of cores: %d\n", configNUMBER_OF_CORES);
-    printf("Core affinity enabled: %s\n", 
-           configUSE_CORE_AFFINITY ? "YES" : "NO");
-    printf("Time slicing enabled: %s\n",
-           configUSE_TIME_SLICING ? "YES" : "NO");
-    printf("Current core: %lu\n", ulGetCurrentCore());
-    printf("Free heap size: %d bytes\n", xPortGetFreeHeapSize());
-    
-    /* Print task distribution */
-    printf("\nTask Core Affinity Strategy:\n");
-    printf("Core 0 (Sensors): 0x%02X\n", CORE_AFFINITY_SENSORS);
-    printf("Core 1 (Communication): 0x%02X\n", CORE_AFFINITY_COMMUNICATION);
-    printf("Any Core: 0x%02X\n", CORE_AFFINITY_ANY);
-    
-    printf("==============================\n\n");
+    LOG_INFO("SMP: %d cores, core affinity %s, time slicing %s",
+             configNUMBER_OF_CORES, configUSE_CORE_AFFINITY ? "on" : "off",
+             configUSE_TIME_SLICING ? "on" : "off");
+    LOG_INFO("SMP: current core %lu, free heap %d bytes",
+             (unsigned long)ulGetCurrentCore(), (int)system_get_free_heap());
+    LOG_INFO("SMP: affinity sensors 0x%02X, communication 0x%02X, any 0x%02X",
+             CORE_AFFINITY_SENSORS, CORE_AFFINITY_COMMUNICATION, CORE_AFFINITY_ANY);
 }
 
 /**
@@ -154,48 +89,50 @@ BaseType_t xValidateSMPConfiguration(void)
 {
     BaseType_t xResult = pdTRUE;
     
-    printf("Validating SMP configuration...\n");
+    LOG_INFO("Validating SMP configuration...");
     
     /* Check if we have the expected number of cores */
     if (configNUMBER_OF_CORES != 2)
     {
-        printf("ERROR: Expected 2 cores, configured for %d\n", configNUMBER_OF_CORES);
+        LOG_ERROR("Expected 2 cores, configured for %d", configNUMBER_OF_CORES);
         xResult = pdFALSE;
     }
     
     /* Check if core affinity is enabled */
     if (!configUSE_CORE_AFFINITY)
     {
-        printf("WARNING: Core affinity is disabled\n");
+        LOG_WARN("Core affinity is disabled");
         xResult = pdFALSE;
     }
     
     /* Verify both cores are accessible */
     uint32_t ulCurrentCore = ulGetCurrentCore();
-    printf("Current core: %lu\n", ulCurrentCore);
+    LOG_INFO("Current core: %lu", (unsigned long)ulCurrentCore);
     
     if (ulCurrentCore >= configNUMBER_OF_CORES)
     {
-        printf("ERROR: Invalid core number: %lu\n", ulCurrentCore);
+        LOG_ERROR("Invalid core number: %lu", (unsigned long)ulCurrentCore);
         xResult = pdFALSE;
     }
     
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
     /* Check memory availability */
-    size_t xFreeHeap = xPortGetFreeHeapSize();
-    printf("Free heap: %d bytes\n", (int)xFreeHeap);
+    size_t xFreeHeap = system_get_free_heap();
+    LOG_INFO("Free heap: %d bytes", (int)xFreeHeap);
     
     if (xFreeHeap < 8192)  /* Minimum 8KB free heap */
     {
-        printf("WARNING: Low memory - %d bytes free\n", (int)xFreeHeap);
+        LOG_WARN("Low memory - %d bytes free", (int)xFreeHeap);
     }
+#endif
     
     if (xResult == pdTRUE)
     {
-        printf("SMP configuration validation: PASSED\n");
+        LOG_INFO("SMP configuration validation: PASSED");
     }
     else
     {
-        printf("SMP configuration validation: FAILED\n");
+        LOG_ERROR("SMP configuration validation: FAILED");
     }
     
     return xResult;
@@ -210,69 +147,21 @@ BaseType_t xValidateSMPConfiguration(void)
 void vSMPTestTask(void *pvParameters)
 {
     const char *pcTaskName = (const char *)pvParameters;
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    const TickType_t xFrequency = pdMS_TO_TICKS(5000);  /* 5 second interval */
+    const task_descriptor_t *pxSelf = task_table_self();
+    periodic_task_t xPeriodic;
     
-    printf("SMP Test Task '%s' started on core %lu\n", 
-           pcTaskName ? pcTaskName : "Unknown", ulGetCurrentCore());
+    LOG_INFO("SMP Test Task '%s' started on core %lu",
+             pcTaskName ? pcTaskName : "Unknown", (unsigned long)ulGetCurrentCore());
+    
+    periodic_init(&xPeriodic, pxSelf->name, pxSelf->period_ms);
     
     for (;;)
     {
-        printf("Task '%s' running on core %lu, free heap: %d\n",
-               pcTaskName ? pcTaskName : "Unknown",
-               ulGetCurrentCore(),
-               xPortGetFreeHeapSize());
+        LOG_INFO("Task '%s' running on core %lu, free heap: %d",
+                 pcTaskName ? pcTaskName : "Unknown",
+                 (unsigned long)ulGetCurrentCore(),
+                 (int)system_get_free_heap());
         
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
+        periodic_wait(&xPeriodic);
     }
 }
-
-/**
- * @brief Create SMP test tasks for validation
- * 
- * Creates test tasks on both cores to validate SMP operation.
- * Should be called during system initialization for testing.
- */
-BaseType_t xCreateSMPTestTasks(void)
-{
-    TaskHandle_t xTestTask0 = NULL;
-    TaskHandle_t xTestTask1 = NULL;
-    BaseType_t xResult = pdTRUE;
-    
-    /* Create test task for Core 0 */
-    if (xTaskCreateWithAffinity(
-            vSMPTestTask,
-            "SMPTest_Core0",
-            256,
-            (void *)"Core0_Test",
-            tskIDLE_PRIORITY + 1,
-            &xTestTask0,
-            CORE_AFFINITY_SENSORS
-        ) != pdPASS)
-    {
-        printf("Failed to create SMP test task for Core 0\n");
-        xResult = pdFALSE;
-    }
-    
-    /* Create test task for Core 1 */
-    if (xTaskCreateWithAffinity(
-            vSMPTestTask,
-            "SMPTest_Core1", 
-            256,
-            (void *)"Core1_Test",
-            tskIDLE_PRIORITY + 1,
-            &xTestTask1,
-            CORE_AFFINITY_COMMUNICATION
-        ) != pdPASS)
-    {
-        printf("Failed to create SMP test task for Core 1\n");
-        xResult = pdFALSE;
-    }
-    
-    if (xResult == pdTRUE)
-    {
-        printf("SMP test tasks created successfully\n");
-    }
-    
-    return xResult;
-} 
\ No newline at end of file
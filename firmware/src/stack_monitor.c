@@ -0,0 +1,151 @@
+/**
+ * @file stack_monitor.c
+ * @brief Task stack high-water monitoring
+ *
+ * Configured sizes come from the task table, and for the kernel's idle
+ * and timer tasks from FreeRTOSConfig.h, as given to the kernel in
+ * system_init.c.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "stack_monitor.h"
+#include "task_table.h"
+#include "log.h"
+
+/* Updater state, owned by the task calling stack_monitor_update() */
+static TaskStatus_t xTaskStatus[STACK_MONITOR_MAX_TASKS];
+static stack_monitor_task_t xStaging[STACK_MONITOR_MAX_TASKS];
+static UBaseType_t uxWarned[STACK_MONITOR_MAX_TASKS];
+static uint32_t ulWarnedCount;
+
+/* Published sample, copied in and out under a critical section */
+static stack_monitor_task_t xReport[STACK_MONITOR_MAX_TASKS];
+static uint32_t ulReportCount;
+static uint32_t ulReportMinUnused = UINT32_MAX;
+
+static uint32_t prvStackWords(TaskHandle_t xTask)
+{
+    for (uint32_t id = 0; id < TASK_ID_COUNT; id++) {
+        if (task_table_get_handle((task_id_t)id) == xTask) {
+            return task_table_get((task_id_t)id)->stack_words;
+        }
+    }
+    for (BaseType_t core = 0; core < configNUMBER_OF_CORES; core++) {
+        if (xTask == xTaskGetIdleTaskHandleForCore(core)) {
+            return configMINIMAL_STACK_SIZE;
+        }
+    }
+#if (configUSE_TIMERS == 1)
+    if (xTask == xTimerGetTimerDaemonTaskHandle()) {
+        return configTIMER_TASK_STACK_DEPTH;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Warn once per task when its unused stack gets low
+ */
+static void prvCheckLow(const TaskStatus_t *pxStatus)
+{
+    if (pxStatus->usStackHighWaterMark >= STACK_MONITOR_WARN_WORDS) {
+        return;
+    }
+    for (uint32_t i = 0; i < ulWarnedCount; i++) {
+        if (uxWarned[i] == pxStatus->xTaskNumber) {
+            return;
+        }
+    }
+    if (ulWarnedCount < STACK_MONITOR_MAX_TASKS) {
+        uxWarned[ulWarnedCount++] = pxStatus->xTaskNumber;
+    }
+    LOG_WARN("Task '%s' stack low: %lu words unused", pxStatus->pcTaskName,
+             (unsigned long)pxStatus->usStackHighWaterMark);
+}
+
+void stack_monitor_update(void)
+{
+    /* Returns 0 if there are more tasks than STACK_MONITOR_MAX_TASKS */
+    UBaseType_t uxCount = uxTaskGetSystemState(xTaskStatus, STACK_MONITOR_MAX_TASKS, NULL);
+    uint32_t ulMinUnused = UINT32_MAX;
+
+    for (UBaseType_t i = 0; i < uxCount; i++) {
+        const TaskStatus_t *pxStatus = &xTaskStatus[i];
+
+        strncpy(xStaging[i].name, pxStatus->pcTaskName, sizeof(xStaging[i].name) - 1u);
+        xStaging[i].name[sizeof(xStaging[i].name) - 1u] = '\0';
+        xStaging[i].stack_words = prvStackWords(pxStatus->xHandle);
+        xStaging[i].unused_min_words = pxStatus->usStackHighWaterMark;
+        if (xStaging[i].unused_min_words < ulMinUnused) {
+            ulMinUnused = xStaging[i].unused_min_words;
+        }
+        prvCheckLow(pxStatus);
+    }
+
+    taskENTER_CRITICAL();
+    memcpy(xReport, xStaging, uxCount * sizeof(xReport[0]));
+    ulReportCount = uxCount;
+    ulReportMinUnused = ulMinUnused;
+    taskEXIT_CRITICAL();
+}
+
+uint32_t stack_monitor_get_tasks(stack_monitor_task_t *tasks, uint32_t max_tasks)
+{
+    uint32_t ulCount;
+
+    taskENTER_CRITICAL();
+    ulCount = (ulReportCount < max_tasks) ? ulReportCount : max_tasks;
+    memcpy(tasks, xReport, ulCount * sizeof(tasks[0]));
+    taskEXIT_CRITICAL();
+    return ulCount;
+}
+
+uint32_t stack_monitor_get_min_unused(void)
+{
+    return ulReportMinUnused;
+}
+
+int stack_monitor_format(char *buffer, size_t buffer_size)
+{
+    static stack_monitor_task_t xTasks[STACK_MONITOR_MAX_TASKS];
+    uint32_t ulTasks = stack_monitor_get_tasks(xTasks, STACK_MONITOR_MAX_TASKS);
+    size_t xPos = 0;
+    int lWritten;
+
+    if (buffer_size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+
+    for (uint32_t i = 0; i < ulTasks; i++) {
+        const stack_monitor_task_t *pxTask = &xTasks[i];
+
+        if (pxTask->stack_words != 0) {
+            lWritten = snprintf(&buffer[xPos], buffer_size - xPos,
+                                "%-*s used %5lu of %5lu words, %5lu unused\n",
+                                (int)(configMAX_TASK_NAME_LEN - 1), pxTask->name,
+                                (unsigned long)(pxTask->stack_words - pxTask->unused_min_words),
+                                (unsigned long)pxTask->stack_words,
+                                (unsigned long)pxTask->unused_min_words);
+        } else {
+            lWritten = snprintf(&buffer[xPos], buffer_size - xPos,
+                                "%-*s %5lu words unused\n",
+                                (int)(configMAX_TASK_NAME_LEN - 1), pxTask->name,
+                                (unsigned long)pxTask->unused_min_words);
+        }
+        if ((lWritten < 0) || ((size_t)lWritten >= buffer_size - xPos)) {
+            buffer[xPos] = '\0';
+            break;
+        }
+        xPos += (size_t)lWritten;
+    }
+
+    return (int)xPos;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file status_link.c
+ * @brief Double-buffered status frames for the I2C1 slave
+ *
+ * The publisher and the slave interrupt may run on different cores.
+ * The interrupt latches a buffer by storing its index in ulServing and
+ * then checking that it is still the published one; the publisher makes
+ * its flip visible before it looks at ulServing. With a barrier between
+ * each store and the following load, one of the two always sees the
+ * other, so the publisher never rebuilds a buffer being served.
+ *
+ * The change counter covers the frame from system_status through
+ * overdue_tasks; uptime, sequence and the health counters move on every
+ * publish and only reach a change-polling master with the next change
+ * or forced refresh.
+ *
+ * The attention line is asserted before the frame carrying its change
+ * is published, so the read that releases it cannot come first. A read
+ * racing with the next change can still release the line for it; the
+ * master's regular poll picks that change up.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "status_link.h"
+#include "crc.h"
+#include "status_snapshot.h"
+#include "alarm_output.h"
+#include "sensor_monitor.h"
+#include "log.h"
+
+#define STATUS_LINK_IDLE    2u      /* ulServing outside a transaction */
+
+/* Frame bytes whose change steps the change counter */
+#define STATUS_LINK_CHANGE_FIRST    offsetof(status_link_frame_t, system_status)
+#define STATUS_LINK_CHANGE_BYTES    (offsetof(status_link_frame_t, overdue_tasks) + 1u - \
+                                     STATUS_LINK_CHANGE_FIRST)
+
+_Static_assert(STATUS_LINK_FRAME_BYTES == 30u, "status frame layout changed");
+_Static_assert(STATUS_LINK_FRAME_BYTES <= UINT8_MAX, "offsets are one byte");
+_Static_assert(offsetof(status_link_frame_t, change) == 0u, "a quick read is register 0");
+
+/* One DATA_CMD word per frame byte */
+static uint16_t usFrames[2][STATUS_LINK_FRAME_BYTES];
+static volatile uint32_t ulPublished;
+static volatile uint32_t ulServing = STATUS_LINK_IDLE;
+static volatile uint32_t ulOffset;
+static volatile bool xAttention;
+static volatile uint32_t ulAttentionChange;
+
+/* Publisher state */
+static uint16_t usSequence;
+static uint8_t ucChange;
+static uint8_t ucChangeState[STATUS_LINK_CHANGE_BYTES];
+static uint32_t ulChangeMs;
+static status_link_health_t xHealth;
+static status_link_stats_t xStats;
+
+/* Interrupt counters */
+static volatile uint32_t ulReads;
+static volatile uint32_t ulOffsetWrites;
+
+/**
+ * @brief Step the change counter if the state changed or a refresh is due
+ * @return true if the state changed
+ */
+static bool prvUpdateChange(status_link_frame_t *pxFrame)
+{
+    const uint8_t *pucState = (const uint8_t *)pxFrame + STATUS_LINK_CHANGE_FIRST;
+    bool xChanged = (memcmp(ucChangeState, pucState, STATUS_LINK_CHANGE_BYTES) != 0);
+
+    if (xChanged || ((pxFrame->uptime_ms - ulChangeMs) >= STATUS_LINK_FORCED_REFRESH_MS)) {
+        memcpy(ucChangeState, pucState, STATUS_LINK_CHANGE_BYTES);
+        ulChangeMs = pxFrame->uptime_ms;
+        ucChange++;
+    }
+    pxFrame->change = ucChange;
+    return xChanged;
+}
+
+/**
+ * @brief Fill a frame from the status snapshot, outputs and health
+ * @return true if the system, zone or output state changed
+ */
+static bool prvBuildFrame(status_link_frame_t *pxFrame)
+{
+    bool xChanged;
+
+    status_snapshot_t xSnapshot;
+
+    status_snapshot_read(&xSnapshot);
+
+    memset(pxFrame, 0, sizeof(*pxFrame));
+    pxFrame->version = STATUS_LINK_FRAME_VERSION;
+    pxFrame->length = (uint8_t)STATUS_LINK_FRAME_BYTES;
+    pxFrame->sequence = usSequence;
+    pxFrame->uptime_ms = to_ms_since_boot(get_absolute_time());
+    pxFrame->system_status = (uint8_t)xSnapshot.system;
+    pxFrame->zone_count = (uint8_t)g_zone_table.zone_count;
+    pxFrame->alarm = (uint8_t)(xSnapshot.alarm[0] & SENSOR_MONITOR_ZONE_MASK);
+    pxFrame->fault = (uint8_t)(xSnapshot.fault[0] & SENSOR_MONITOR_ZONE_MASK);
+    pxFrame->disabled = (uint8_t)(xSnapshot.disabled[0] & SENSOR_MONITOR_ZONE_MASK);
+    pxFrame->outputs = (uint8_t)alarm_output_get_active();
+
+    taskENTER_CRITICAL();
+    pxFrame->overdue_tasks = xHealth.overdue_tasks;
+    pxFrame->cpu_load_permille[0] = xHealth.cpu_load_permille[0];
+    pxFrame->cpu_load_permille[1] = xHealth.cpu_load_permille[1];
+    pxFrame->heap_free_bytes = xHealth.heap_free_bytes;
+    pxFrame->stack_min_unused_words = xHealth.stack_min_unused_words;
+    pxFrame->pool_exhausted = xHealth.pool_exhausted;
+    pxFrame->deadline_misses = xHealth.deadline_misses;
+    taskEXIT_CRITICAL();
+
+    xChanged = prvUpdateChange(pxFrame);
+    pxFrame->crc = crc16_ccitt(pxFrame, STATUS_LINK_FRAME_BYTES - sizeof(pxFrame->crc));
+    return xChanged;
+}
+
+bool status_link_publish(void)
+{
+    uint32_t ulTarget = ulPublished ^ 1u;
+    status_link_frame_t xFrame;
+    const uint8_t *pucFrame = (const uint8_t *)&xFrame;
+    bool xChanged;
+
+    /* Pairs with the barrier in status_link_begin_read_from_isr() */
+    __dmb();
+    if (ulServing == ulTarget) {
+        xStats.deferred++;
+        return false;
+    }
+
+    xChanged = prvBuildFrame(&xFrame);
+    for (uint32_t i = 0; i < STATUS_LINK_FRAME_BYTES; i++) {
+        usFrames[ulTarget][i] = pucFrame[i];
+    }
+
+    if (xChanged) {
+        ulAttentionChange = xFrame.change;
+        xAttention = true;
+        status_link_hw_set_attention(true);
+        xStats.attentions++;
+    }
+
+    /* The frame must be complete before it is published */
+    __dmb();
+    ulPublished = ulTarget;
+    usSequence++;
+    xStats.publishes++;
+    return true;
+}
+
+bool status_link_start(uint8_t address)
+{
+    ulServing = STATUS_LINK_IDLE;
+    ulOffset = 0;
+    (void)status_link_publish();
+
+    if (!status_link_hw_start(address)) {
+        LOG_WARN("Status link: I2C1 slave unavailable");
+        return false;
+    }
+    status_link_hw_set_attention(xAttention);
+    LOG_INFO("Status link: I2C1 slave 0x%02x, %u byte frame",
+             (unsigned)address, (unsigned)STATUS_LINK_FRAME_BYTES);
+    return true;
+}
+
+void status_link_set_health(const status_link_health_t *health)
+{
+    taskENTER_CRITICAL();
+    xHealth = *health;
+    taskEXIT_CRITICAL();
+}
+
+void status_link_get_stats(status_link_stats_t *stats)
+{
+    *stats = xStats;
+    stats->reads = ulReads;
+    stats->offset_writes = ulOffsetWrites;
+}
+
+void status_link_set_offset_from_isr(uint8_t offset)
+{
+    ulOffset = offset;
+    ulOffsetWrites++;
+}
+
+const uint16_t *status_link_begin_read_from_isr(uint32_t *words)
+{
+    uint32_t ulIndex = ulServing;
+
+    if (ulIndex == STATUS_LINK_IDLE) {
+        /* Claim the published buffer, then make sure it still is */
+        do {
+            ulIndex = ulPublished;
+            ulServing = ulIndex;
+            __dmb();
+        } while (ulIndex != ulPublished);
+        ulReads++;
+
+        /* The master has seen the change it was called for */
+        if (xAttention && (ulOffset == 0u) && (usFrames[ulIndex][0] == ulAttentionChange)) {
+            xAttention = false;
+            status_link_hw_set_attention(false);
+        }
+    }
+
+    if (ulOffset >= STATUS_LINK_FRAME_BYTES) {
+        *words = 0;
+        return NULL;
+    }
+    *words = STATUS_LINK_FRAME_BYTES - ulOffset;
+    return &usFrames[ulIndex][ulOffset];
+}
+
+void status_link_end_from_isr(void)
+{
+    ulServing = STATUS_LINK_IDLE;
+}
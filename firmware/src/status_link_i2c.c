@@ -0,0 +1,146 @@
+/**
+ * @file status_link_i2c.c
+ * @brief I2C1 slave engine for the status link
+ *
+ * A read transaction costs three interrupts whatever its length: the
+ * offset byte (if written), the first read request, which latches the
+ * frame and starts a DMA channel feeding the TX FIFO from it, and the
+ * stop, which stops the channel and releases the frame. TX FIFO bytes
+ * left over when the master stops early are flushed by the controller
+ * at the next read (a TX abort, which is only acknowledged here).
+ *
+ * The attention line is driven open drain: the pad output stays low and
+ * asserting it enables the driver, so cards can share the line.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "status_link.h"
+#include "trace.h"
+
+#define STATUS_LINK_I2C         i2c1
+#define STATUS_LINK_I2C_IRQ     I2C1_IRQ
+#define STATUS_LINK_TX_LEVEL    4u      /* DMA tops the TX FIFO up below this */
+
+static int lLinkDmaChannel = -1;
+static dma_channel_config xLinkDmaConfig;
+static bool xLinkDmaStarted;
+
+/**
+ * @brief Answer a read request: start the frame DMA, or send filler
+ */
+static void prvServeRead(i2c_hw_t *pxHw)
+{
+    const uint16_t *pusWords;
+    uint32_t ulWords;
+
+    if (!xLinkDmaStarted) {
+        xLinkDmaStarted = true;
+        pusWords = status_link_begin_read_from_isr(&ulWords);
+        if (pusWords != NULL) {
+            dma_channel_configure((uint)lLinkDmaChannel, &xLinkDmaConfig, &pxHw->data_cmd,
+                                  pusWords, ulWords, true);
+            return;
+        }
+    } else if (dma_channel_is_busy((uint)lLinkDmaChannel)) {
+        /* The FIFO ran dry between two DMA writes */
+        return;
+    }
+
+    pxHw->data_cmd = STATUS_LINK_FILL_BYTE;
+}
+
+/**
+ * @brief I2C1 interrupt: offset writes, read requests and stops
+ */
+static void prvStatusLinkIrqHandler(void)
+{
+    i2c_hw_t *pxHw = i2c_get_hw(STATUS_LINK_I2C);
+    uint32_t ulStatus = pxHw->intr_stat;
+
+    TRACE_ISR_ENTER(TRACE_ISR_STATUS_LINK);
+
+    if (ulStatus & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        (void)pxHw->clr_tx_abrt;
+    }
+
+    if (ulStatus & I2C_IC_INTR_STAT_R_RX_FULL_BITS) {
+        while (pxHw->rxflr != 0u) {
+            uint32_t ulData = pxHw->data_cmd;
+
+            /* Only the first byte of a write is the offset */
+            if (ulData & I2C_IC_DATA_CMD_FIRST_DATA_BYTE_BITS) {
+                status_link_set_offset_from_isr((uint8_t)ulData);
+            }
+        }
+    }
+
+    if (ulStatus & I2C_IC_INTR_STAT_R_RD_REQ_BITS) {
+        prvServeRead(pxHw);
+        (void)pxHw->clr_rd_req;
+    }
+
+    if (ulStatus & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)pxHw->clr_stop_det;
+        if (xLinkDmaStarted) {
+            dma_channel_abort((uint)lLinkDmaChannel);
+            xLinkDmaStarted = false;
+        }
+        status_link_end_from_isr();
+    }
+
+    TRACE_ISR_EXIT(TRACE_ISR_STATUS_LINK);
+}
+
+bool status_link_hw_start(uint8_t address)
+{
+    i2c_hw_t *pxHw = i2c_get_hw(STATUS_LINK_I2C);
+
+    lLinkDmaChannel = dma_claim_unused_channel(false);
+    if (lLinkDmaChannel < 0) {
+        return false;
+    }
+
+    /* One 16-bit DATA_CMD write per byte, paced by the TX FIFO */
+    xLinkDmaConfig = dma_channel_get_default_config((uint)lLinkDmaChannel);
+    channel_config_set_transfer_data_size(&xLinkDmaConfig, DMA_SIZE_16);
+    channel_config_set_read_increment(&xLinkDmaConfig, true);
+    channel_config_set_write_increment(&xLinkDmaConfig, false);
+    channel_config_set_dreq(&xLinkDmaConfig, i2c_get_dreq(STATUS_LINK_I2C, true));
+    xLinkDmaStarted = false;
+
+    i2c_init(STATUS_LINK_I2C, STATUS_LINK_BAUDRATE);
+    i2c_set_slave_mode(STATUS_LINK_I2C, true, address);
+    gpio_set_function(BOARD_PIN_I2C1_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(BOARD_PIN_I2C1_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(BOARD_PIN_I2C1_SDA);
+    gpio_pull_up(BOARD_PIN_I2C1_SCL);
+
+    /* Stops of other cards' transactions are not ours to handle */
+    hw_set_bits(&pxHw->con, I2C_IC_CON_STOP_DET_IFADDRESSED_BITS);
+    pxHw->dma_tdlr = STATUS_LINK_TX_LEVEL;
+    pxHw->intr_mask = I2C_IC_INTR_MASK_M_RX_FULL_BITS | I2C_IC_INTR_MASK_M_RD_REQ_BITS |
+                      I2C_IC_INTR_MASK_M_TX_ABRT_BITS | I2C_IC_INTR_MASK_M_STOP_DET_BITS;
+
+    /* Released until a state change; the controller pulls the line up */
+    gpio_init(BOARD_PIN_EXPANSION_OUT);
+    gpio_put(BOARD_PIN_EXPANSION_OUT, false);
+    gpio_set_dir(BOARD_PIN_EXPANSION_OUT, GPIO_IN);
+
+    irq_set_exclusive_handler(STATUS_LINK_I2C_IRQ, prvStatusLinkIrqHandler);
+    irq_set_enabled(STATUS_LINK_I2C_IRQ, true);
+    return true;
+}
+
+void status_link_hw_set_attention(bool asserted)
+{
+    gpio_set_dir(BOARD_PIN_EXPANSION_OUT, asserted ? GPIO_OUT : GPIO_IN);
+}
@@ -0,0 +1,225 @@
+/**
+ * @file status_snapshot.c
+ * @brief Seqlock-protected system and zone status snapshot
+ * 
+ * Publish: take the writer spinlock (interrupts off on this core), make
+ * the sequence odd, update the fields, make it even again. Read: copy the
+ * fields between two reads of an even, unchanged sequence.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "status_snapshot.h"
+
+typedef struct {
+    TaskHandle_t task;
+    uint32_t bits;
+} status_subscriber_t;
+
+static status_snapshot_t xSnapshot;
+static spin_lock_t *pxSnapshotLock = NULL;
+static status_subscriber_t xSubscribers[STATUS_SNAPSHOT_MAX_SUBSCRIBERS];
+static volatile uint32_t ulSubscriberCount;
+static volatile bool xFaultLatched;     /* Set under the writer lock */
+
+/**
+ * @brief Apply the latched fault to a status about to be published
+ */
+static inline system_status_t prvWithLatchedFault(system_status_t status)
+{
+    return (xFaultLatched && (status == SYSTEM_STATUS_NORMAL)) ? SYSTEM_STATUS_FAULT : status;
+}
+
+/**
+ * @brief Open a publish: serialise writers and make the sequence odd
+ */
+static uint32_t prvWriteBegin(void)
+{
+    uint32_t ulSave = spin_lock_blocking(pxSnapshotLock);
+
+    xSnapshot.sequence++;
+    __dmb();
+    return ulSave;
+}
+
+/**
+ * @brief Close a publish: make the sequence even and release writers
+ */
+static void prvWriteEnd(uint32_t ulSave)
+{
+    xSnapshot.timestamp_ms = to_ms_since_boot(get_absolute_time());
+    __dmb();
+    xSnapshot.sequence++;
+    spin_unlock(pxSnapshotLock, ulSave);
+}
+
+/**
+ * @brief Notify all subscribers of a change
+ */
+static void prvNotifySubscribers(void)
+{
+    uint32_t ulCount = ulSubscriberCount;
+
+    for (uint32_t i = 0; i < ulCount; i++) {
+        xTaskNotify(xSubscribers[i].task, xSubscribers[i].bits, eSetBits);
+    }
+}
+
+void status_snapshot_init(void)
+{
+    if (pxSnapshotLock == NULL) {
+        pxSnapshotLock = spin_lock_init((uint)spin_lock_claim_unused(true));
+    }
+
+    memset(&xSnapshot, 0, sizeof(xSnapshot));
+    xSnapshot.system = SYSTEM_STATUS_INIT;
+    ulSubscriberCount = 0;
+    xFaultLatched = false;
+}
+
+bool status_snapshot_subscribe(TaskHandle_t xTask, uint32_t notify_bits)
+{
+    uint32_t ulSave = spin_lock_blocking(pxSnapshotLock);
+    uint32_t ulIndex = ulSubscriberCount;
+
+    if (ulIndex >= STATUS_SNAPSHOT_MAX_SUBSCRIBERS) {
+        spin_unlock(pxSnapshotLock, ulSave);
+        return false;
+    }
+
+    xSubscribers[ulIndex].task = xTask;
+    xSubscribers[ulIndex].bits = notify_bits;
+    __dmb();
+    ulSubscriberCount = ulIndex + 1u;
+    spin_unlock(pxSnapshotLock, ulSave);
+    return true;
+}
+
+uint32_t status_snapshot_read(status_snapshot_t *snapshot)
+{
+    uint32_t ulSeq;
+
+    for (;;) {
+        ulSeq = *(volatile uint32_t *)&xSnapshot.sequence;
+        if (ulSeq & 1u) {
+            tight_loop_contents();
+            continue;
+        }
+
+        __dmb();
+        memcpy(snapshot, &xSnapshot, sizeof(*snapshot));
+        __dmb();
+
+        if (*(volatile uint32_t *)&xSnapshot.sequence == ulSeq) {
+            snapshot->sequence = ulSeq;
+            return ulSeq;
+        }
+    }
+}
+
+system_status_t status_snapshot_get_system(void)
+{
+    return *(volatile system_status_t *)&xSnapshot.system;
+}
+
+uint32_t status_snapshot_get_sequence(void)
+{
+    return *(volatile uint32_t *)&xSnapshot.sequence;
+}
+
+bool status_snapshot_set_system(system_status_t status)
+{
+    uint32_t ulSave;
+
+    status = prvWithLatchedFault(status);
+
+    /* Nothing to publish; also keeps the common case lock-free */
+    if (status_snapshot_get_system() == status) {
+        return false;
+    }
+
+    ulSave = prvWriteBegin();
+    xSnapshot.system = status;
+    prvWriteEnd(ulSave);
+
+    prvNotifySubscribers();
+    return true;
+}
+
+bool status_snapshot_latch_fault(void)
+{
+    uint32_t ulSave;
+    bool xChanged;
+
+    ulSave = prvWriteBegin();
+    xFaultLatched = true;
+    xChanged = (xSnapshot.system == SYSTEM_STATUS_NORMAL);
+    if (xChanged) {
+        xSnapshot.system = SYSTEM_STATUS_FAULT;
+    }
+    prvWriteEnd(ulSave);
+
+    if (xChanged) {
+        prvNotifySubscribers();
+    }
+    return xChanged;
+}
+
+bool status_snapshot_publish_masks(const uint32_t *alarm, const uint32_t *fault,
+                                   const uint32_t *disabled, system_status_t derived)
+{
+    uint32_t ulSave;
+    bool xChanged = false;
+
+    ulSave = prvWriteBegin();
+    derived = prvWithLatchedFault(derived);
+
+    for (uint32_t w = 0; w < ZONE_MASK_WORDS; w++) {
+        xChanged |= (xSnapshot.alarm[w] != alarm[w]) ||
+                    (xSnapshot.fault[w] != fault[w]) ||
+                    (xSnapshot.disabled[w] != disabled[w]);
+        xSnapshot.alarm[w] = alarm[w];
+        xSnapshot.fault[w] = fault[w];
+        xSnapshot.disabled[w] = disabled[w];
+    }
+
+    if ((xSnapshot.system != SYSTEM_STATUS_TEST) && (xSnapshot.system != derived)) {
+        xSnapshot.system = derived;
+        xChanged = true;
+    }
+
+    prvWriteEnd(ulSave);
+
+    if (xChanged) {
+        prvNotifySubscribers();
+    }
+    return xChanged;
+}
+
+bool status_snapshot_publish_zones(system_status_t derived)
+{
+    return status_snapshot_publish_masks(g_zone_table.alarm, g_zone_table.fault,
+                                         g_zone_table.disabled, derived);
+}
+
+void status_snapshot_set_system_from_fatal(system_status_t status)
+{
+    /* Another writer may have died holding the lock; do not wait for it.
+     * If one is mid-publish, the single-word status write is still atomic. */
+    if ((xSnapshot.sequence & 1u) != 0) {
+        xSnapshot.system = status;
+        return;
+    }
+
+    xSnapshot.sequence++;
+    __dmb();
+    xSnapshot.system = status;
+    __dmb();
+    xSnapshot.sequence++;
+}
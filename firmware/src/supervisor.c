@@ -0,0 +1,208 @@
+/**
+ * @file supervisor.c
+ * @brief Task liveness supervisor
+ *
+ * Each slot's heartbeat counter has one writer, the supervised task;
+ * everything else in a slot is owned by the supervisor, which only
+ * compares the counter with the value it saw last.
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/watchdog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "supervisor.h"
+#include "log.h"
+
+/* Watchdog scratch registers 0-3 are free for the application (4-7 are the SDK's) */
+#define SUPERVISOR_SCRATCH_TAG      0
+#define SUPERVISOR_SCRATCH_GAP      1
+#define SUPERVISOR_SCRATCH_NAME     2       /* 2 and 3: first 8 name characters */
+#define SUPERVISOR_STALL_MAGIC      0x53544C4Cu     /* "STLL" */
+
+typedef struct {
+    /* Set at registration */
+    const char *name;
+    uint32_t deadline_ms;
+
+    /* Written by the supervised task only */
+    volatile uint32_t beats;
+
+    /* Supervisor state */
+    uint32_t seen_beats;
+    uint32_t last_beat_ms;
+    uint32_t overruns;
+    uint32_t worst_gap_ms;
+    bool overdue;
+} supervisor_slot_t;
+
+static supervisor_slot_t xSlots[SUPERVISOR_MAX_TASKS];
+static volatile uint32_t ulSlotCount;
+static uint32_t ulCheckedCount;
+static bool xStallRecorded;
+
+static uint32_t prvNowMs(void)
+{
+    return to_ms_since_boot(get_absolute_time());
+}
+
+/**
+ * @brief Keep the stalled task in registers that survive the watchdog reset
+ */
+static void prvRecordStall(const supervisor_slot_t *pxSlot, uint32_t ulGapMs)
+{
+    char cName[8] = { 0 };
+
+    strncpy(cName, pxSlot->name, sizeof(cName));
+    watchdog_hw->scratch[SUPERVISOR_SCRATCH_NAME] =
+        (uint32_t)cName[0] | ((uint32_t)cName[1] << 8) |
+        ((uint32_t)cName[2] << 16) | ((uint32_t)cName[3] << 24);
+    watchdog_hw->scratch[SUPERVISOR_SCRATCH_NAME + 1] =
+        (uint32_t)cName[4] | ((uint32_t)cName[5] << 8) |
+        ((uint32_t)cName[6] << 16) | ((uint32_t)cName[7] << 24);
+    watchdog_hw->scratch[SUPERVISOR_SCRATCH_GAP] = ulGapMs;
+    watchdog_hw->scratch[SUPERVISOR_SCRATCH_TAG] = SUPERVISOR_STALL_MAGIC;
+}
+
+void supervisor_init(void)
+{
+    memset(xSlots, 0, sizeof(xSlots));
+    ulSlotCount = 0;
+    ulCheckedCount = 0;
+    xStallRecorded = false;
+
+    if (watchdog_hw->scratch[SUPERVISOR_SCRATCH_TAG] == SUPERVISOR_STALL_MAGIC) {
+        static char cStalled[9];
+        uint32_t ulLow = watchdog_hw->scratch[SUPERVISOR_SCRATCH_NAME];
+        uint32_t ulHigh = watchdog_hw->scratch[SUPERVISOR_SCRATCH_NAME + 1];
+
+        for (uint32_t i = 0; i < 4u; i++) {
+            cStalled[i] = (char)(ulLow >> (8u * i));
+            cStalled[4u + i] = (char)(ulHigh >> (8u * i));
+        }
+        cStalled[8] = '\0';
+
+        if (watchdog_caused_reboot()) {
+            LOG_ERROR("Supervisor: watchdog reset after '%s' stalled for %lu ms",
+                      cStalled, (unsigned long)watchdog_hw->scratch[SUPERVISOR_SCRATCH_GAP]);
+        }
+    }
+    watchdog_hw->scratch[SUPERVISOR_SCRATCH_TAG] = 0;
+}
+
+supervisor_id_t supervisor_register(const char *name, uint32_t deadline_ms)
+{
+    supervisor_id_t xId = SUPERVISOR_INVALID_ID;
+
+    taskENTER_CRITICAL();
+    if (ulSlotCount < SUPERVISOR_MAX_TASKS) {
+        xId = (supervisor_id_t)ulSlotCount;
+        xSlots[xId].name = name;
+        xSlots[xId].deadline_ms = deadline_ms;
+        xSlots[xId].beats = 0;
+
+        /* The supervisor picks up the slot once the count covers it */
+        __dmb();
+        ulSlotCount = (uint32_t)xId + 1u;
+    }
+    taskEXIT_CRITICAL();
+
+    if (xId == SUPERVISOR_INVALID_ID) {
+        LOG_ERROR("Supervisor: no slot for '%s'", name);
+    }
+    return xId;
+}
+
+void supervisor_heartbeat(supervisor_id_t id)
+{
+    if ((id >= 0) && ((uint32_t)id < SUPERVISOR_MAX_TASKS)) {
+        xSlots[id].beats++;
+    }
+}
+
+bool supervisor_check(void)
+{
+    uint32_t ulNow = prvNowMs();
+    uint32_t ulCount = ulSlotCount;
+    bool xHealthy = true;
+
+    __dmb();
+
+    /* Deadlines of new registrations start now */
+    for (; ulCheckedCount < ulCount; ulCheckedCount++) {
+        xSlots[ulCheckedCount].seen_beats = xSlots[ulCheckedCount].beats;
+        xSlots[ulCheckedCount].last_beat_ms = ulNow;
+    }
+
+    for (uint32_t i = 0; i < ulCount; i++) {
+        supervisor_slot_t *pxSlot = &xSlots[i];
+        uint32_t ulBeats = pxSlot->beats;
+        uint32_t ulGap;
+
+        if (ulBeats != pxSlot->seen_beats) {
+            pxSlot->seen_beats = ulBeats;
+            pxSlot->last_beat_ms = ulNow;
+            if (pxSlot->overdue) {
+                pxSlot->overdue = false;
+                LOG_WARN("Supervisor: '%s' recovered", pxSlot->name);
+            }
+            continue;
+        }
+
+        ulGap = ulNow - pxSlot->last_beat_ms;
+        if (ulGap <= pxSlot->deadline_ms) {
+            continue;
+        }
+
+        xHealthy = false;
+        if (ulGap > pxSlot->worst_gap_ms) {
+            pxSlot->worst_gap_ms = ulGap;
+        }
+        if (!pxSlot->overdue) {
+            pxSlot->overdue = true;
+            pxSlot->overruns++;
+            LOG_ERROR("Supervisor: '%s' missed its %lu ms deadline, watchdog not fed",
+                      pxSlot->name, (unsigned long)pxSlot->deadline_ms);
+        }
+        if (!xStallRecorded) {
+            prvRecordStall(pxSlot, ulGap);
+            xStallRecorded = true;
+        }
+    }
+
+    if (xHealthy) {
+        xStallRecorded = false;
+        watchdog_hw->scratch[SUPERVISOR_SCRATCH_TAG] = 0;
+        watchdog_update();
+    }
+    return xHealthy;
+}
+
+bool supervisor_get_status(supervisor_id_t id, supervisor_task_status_t *status)
+{
+    const supervisor_slot_t *pxSlot;
+
+    if ((id < 0) || ((uint32_t)id >= ulSlotCount)) {
+        return false;
+    }
+
+    pxSlot = &xSlots[id];
+    status->name = pxSlot->name;
+    status->deadline_ms = pxSlot->deadline_ms;
+    status->beats = pxSlot->beats;
+    status->last_beat_ms = pxSlot->last_beat_ms;
+    status->overruns = pxSlot->overruns;
+    status->worst_gap_ms = pxSlot->worst_gap_ms;
+    status->overdue = pxSlot->overdue;
+    return true;
+}
+
+uint32_t supervisor_get_task_count(void)
+{
+    return ulSlotCount;
+}
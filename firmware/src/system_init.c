@@ -17,11 +17,24 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "system_init.h"
+#include "zone_filter.h"
+#include "adc_stream.h"
+#include "status_snapshot.h"
+#include "log.h"
+#include "trace.h"
+#include "heap_profile.h"
+#include "stack_monitor.h"
+#include "crc.h"
 
 /* Global system variables */
-system_status_t g_system_status = SYSTEM_STATUS_INIT;
 system_config_t g_system_config;
 
+/* CRC-32 of g_system_config as last sealed */
+static uint32_t ulConfigCrc;
+
+/* RAM pattern test area for the self-test */
+#define SELF_TEST_RAM_WORDS     256
+
 /* Static memory allocation for FreeRTOS tasks */
 static StaticTask_t xIdleTaskTCBBuffer;
 static StackType_t xIdleStack[configMINIMAL_STACK_SIZE];
@@ -29,6 +42,13 @@ static StackType_t xIdleStack[configMINIMAL_STACK_SIZE];
 static StaticTask_t xTimerTaskTCBBuffer;
 static StackType_t xTimerStack[configTIMER_TASK_STACK_DEPTH];
 
+/* Kernel task entry points for the post-build stack check */
+STACK_INFO_RECORD(IDLE, prvIdleTask, configMINIMAL_STACK_SIZE);
+STACK_INFO_RECORD(TIMER, prvTimerTask, configTIMER_TASK_STACK_DEPTH);
+#if (configNUMBER_OF_CORES > 1)
+STACK_INFO_RECORD(PASSIVE_IDLE, prvPassiveIdleTask, configMINIMAL_STACK_SIZE);
+#endif
+
 /**
  * @brief Initialize system configuration to default values
  */
@@ -41,12 +61,57 @@ void system_config_init(void)
     g_system_config.device_address = 0x20;  /* Default I2C address */
     g_system_config.watchdog_enabled = true;
     
-    /* Set default sensor thresholds */
-    for (int i = 0; i < MAX_ZONES; i++) {
-        g_system_config.sensor_threshold[i] = 512;  /* Mid-range for 10-bit ADC */
-    }
+    /* Zone input glitch filter: 8 samples at 10 kHz rejects bursts under 0.8 ms */
+    g_system_config.input_filter_enabled = true;
+    g_system_config.input_filter_sample_hz = ZONE_FILTER_DEFAULT_SAMPLE_HZ;
+    g_system_config.input_filter_confirm_samples = ZONE_FILTER_DEFAULT_CONFIRM_SAMPLES;
     
-    printf("System configuration initialized to defaults\n");
+    /* Confirmed fire inputs drive their alarm outputs from the filter interrupt */
+    g_system_config.alarm_fast_path_enabled = true;
+    
+    /* Analog inputs: 1 kHz per channel, 4x oversampled */
+    g_system_config.adc_sample_hz = ADC_STREAM_DEFAULT_RATE_HZ;
+    g_system_config.adc_oversample = ADC_STREAM_DEFAULT_OVERSAMPLE;
+    g_system_config.adc_temp_sensor_enabled = false;
+    
+    system_config_seal();
+    LOG_INFO("System configuration initialized to defaults");
+}
+
+/**
+ * @brief Seal the configuration after changing it
+ * 
+ * Padding is covered too; system_config_init() clears it first.
+ */
+void system_config_seal(void)
+{
+    ulConfigCrc = crc32_ieee(&g_system_config, sizeof(g_system_config));
+}
+
+/**
+ * @brief Check the configuration against its seal
+ * @return true if unchanged since the last system_config_seal()
+ */
+bool system_config_check(void)
+{
+    return crc32_ieee(&g_system_config, sizeof(g_system_config)) == ulConfigCrc;
+}
+
+/**
+ * @brief Check the DMA sniffer CRC against the CPU on the configuration
+ * @return true if the sniffer agrees with the seal, or no channel was free
+ */
+bool system_config_check_dma(void)
+{
+    uint32_t ulCrc;
+
+    if (!crc_dma_init()) {
+        LOG_WARN("DMA sniffer check skipped: no free DMA channel");
+        return true;
+    }
+    ulCrc = crc_dma_compute(CRC_KIND_32_IEEE, &g_system_config, sizeof(g_system_config));
+    crc_dma_deinit();
+    return ulCrc == ulConfigCrc;
 }
 
 /**
@@ -55,17 +120,20 @@ void system_config_init(void)
  */
 system_status_t system_get_status(void)
 {
-    return g_system_status;
+    return status_snapshot_get_system();
 }
 
 /**
  * @brief Set system status
+ * 
+ * Publishes through the status snapshot; subscribers are notified of the
+ * change instead of it being printed here.
+ * 
  * @param status New system status
  */
 void system_set_status(system_status_t status)
 {
-    g_system_status = status;
-    printf("System status changed to: %d\n", status);
+    status_snapshot_set_system(status);
 }
 
 /**
@@ -84,22 +152,64 @@ int system_get_version_string(char *buffer, size_t buffer_size)
                    FIRMWARE_VERSION_BUILD);
 }
 
+/**
+ * @brief Get the free kernel heap
+ * @return Free heap in bytes
+ */
+size_t system_get_free_heap(void)
+{
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+    return xPortGetFreeHeapSize();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Walking-ones and address-in-address test of a static RAM area
+ * @return true if every word read back as written
+ */
+static bool prvRamPatternTest(void)
+{
+    static volatile uint32_t ulTestRam[SELF_TEST_RAM_WORDS];
+    
+    for (uint32_t bit = 0; bit < 32u; bit++) {
+        for (uint32_t i = 0; i < SELF_TEST_RAM_WORDS; i++) {
+            ulTestRam[i] = 1UL << ((bit + i) & 31u);
+        }
+        for (uint32_t i = 0; i < SELF_TEST_RAM_WORDS; i++) {
+            if (ulTestRam[i] != (1UL << ((bit + i) & 31u))) {
+                return false;
+            }
+        }
+    }
+    
+    for (uint32_t i = 0; i < SELF_TEST_RAM_WORDS; i++) {
+        ulTestRam[i] = (uint32_t)(uintptr_t)&ulTestRam[i];
+    }
+    for (uint32_t i = 0; i < SELF_TEST_RAM_WORDS; i++) {
+        if (ulTestRam[i] != (uint32_t)(uintptr_t)&ulTestRam[i]) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
 /**
  * @brief Perform system self-test
  * @return true if all tests passed, false otherwise
  */
 bool system_self_test(void)
 {
-    printf("Starting system self-test...\n");
+    LOG_INFO("Starting system self-test...");
     
-    /* Test 1: Memory test */
-    void *test_ptr = pvPortMalloc(1024);
-    if (test_ptr == NULL) {
-        printf("FAIL: Memory allocation test\n");
+    /* Test 1: Memory test (no heap use, so it also runs in the static build) */
+    if (!prvRamPatternTest()) {
+        LOG_ERROR("FAIL: RAM pattern test");
         return false;
     }
-    vPortFree(test_ptr);
-    printf("PASS: Memory allocation test\n");
+    LOG_INFO("PASS: RAM pattern test");
     
     /* Test 2: GPIO test */
     gpio_init(PICO_DEFAULT_LED_PIN);
@@ -107,15 +217,26 @@ bool system_self_test(void)
     gpio_put(PICO_DEFAULT_LED_PIN, 1);
     sleep_ms(50);
     gpio_put(PICO_DEFAULT_LED_PIN, 0);
-    printf("PASS: GPIO test\n");
+    LOG_INFO("PASS: GPIO test");
     
     /* Test 3: Watchdog test */
     if (g_system_config.watchdog_enabled) {
         watchdog_update();
-        printf("PASS: Watchdog test\n");
+        LOG_INFO("PASS: Watchdog test");
+    }
+    
+    /* Test 4: Configuration seal, and the DMA sniffer agrees with the CPU */
+    if (!system_config_check()) {
+        LOG_ERROR("FAIL: Configuration CRC");
+        return false;
+    }
+    if (!system_config_check_dma()) {
+        LOG_ERROR("FAIL: DMA sniffer CRC");
+        return false;
     }
+    LOG_INFO("PASS: Configuration CRC");
     
-    printf("System self-test completed successfully\n");
+    LOG_INFO("System self-test completed successfully");
     return true;
 }
 
@@ -125,21 +246,21 @@ bool system_self_test(void)
  */
 bool hal_init(void)
 {
-    printf("Initializing Hardware Abstraction Layer...\n");
+    LOG_INFO("Initializing Hardware Abstraction Layer...");
     
     /* Initialize system configuration */
     system_config_init();
     
     /* Perform self-test */
     if (!system_self_test()) {
-        printf("HAL initialization failed: self-test failed\n");
+        LOG_ERROR("HAL initialization failed: self-test failed");
         return false;
     }
     
     /* Set system status to normal operation */
     system_set_status(SYSTEM_STATUS_NORMAL);
     
-    printf("HAL initialization completed successfully\n");
+    LOG_INFO("HAL initialization completed successfully");
     return true;
 }
 
@@ -148,7 +269,7 @@ bool hal_init(void)
  */
 void system_shutdown(void)
 {
-    printf("System shutdown initiated...\n");
+    LOG_INFO("System shutdown initiated...");
     
     /* Set system status to fault */
     system_set_status(SYSTEM_STATUS_FAULT);
@@ -159,7 +280,7 @@ void system_shutdown(void)
     /* Turn off all LEDs except fault LED */
     gpio_put(25, 0);  /* Status LED off */
     
-    printf("System shutdown complete\n");
+    LOG_INFO("System shutdown complete");
 }
 
 /* FreeRTOS Hook Functions */
@@ -169,10 +290,13 @@ void system_shutdown(void)
  */
 void vApplicationMallocFailedHook(void)
 {
-    printf("FATAL: Memory allocation failed!\n");
+    LOG_FATAL("Memory allocation failed!");
     
     /* Set fault status */
-    system_set_status(SYSTEM_STATUS_FAULT);
+    status_snapshot_set_system_from_fatal(SYSTEM_STATUS_FAULT);
+    log_panic_flush();
+    trace_panic_dump();
+    heap_profile_panic_dump();
     
     /* Disable interrupts and halt */
     portDISABLE_INTERRUPTS();
@@ -190,10 +314,12 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
 {
     (void)xTask;  /* Suppress unused parameter warning */
     
-    printf("FATAL: Stack overflow in task: %s\n", pcTaskName);
+    LOG_FATAL("Stack overflow in task: %s", pcTaskName);
     
     /* Set fault status */
-    system_set_status(SYSTEM_STATUS_FAULT);
+    status_snapshot_set_system_from_fatal(SYSTEM_STATUS_FAULT);
+    log_panic_flush();
+    trace_panic_dump();
     
     /* Disable interrupts and halt */
     portDISABLE_INTERRUPTS();
@@ -210,7 +336,7 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
  */
 void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
                                    StackType_t **ppxIdleTaskStackBuffer,
-                                   uint32_t *pulIdleTaskStackSize)
+                                   configSTACK_DEPTH_TYPE *pulIdleTaskStackSize)
 {
     *ppxIdleTaskTCBBuffer = &xIdleTaskTCBBuffer;
     *ppxIdleTaskStackBuffer = &xIdleStack[0];
@@ -225,13 +351,14 @@ void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
  */
 void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
                                     StackType_t **ppxTimerTaskStackBuffer,
-                                    uint32_t *pulTimerTaskStackSize)
+                                    configSTACK_DEPTH_TYPE *pulTimerTaskStackSize)
 {
     *ppxTimerTaskTCBBuffer = &xTimerTaskTCBBuffer;
     *ppxTimerTaskStackBuffer = &xTimerStack[0];
     *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
 }
 
+#if (configNUMBER_OF_CORES > 1)
 /**
  * @brief Get passive idle task memory (static allocation for SMP)
  * @param ppxIdleTaskTCBBuffer Pointer to TCB buffer  
@@ -252,4 +379,5 @@ void vApplicationGetPassiveIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
     *ppxIdleTaskTCBBuffer = &xPassiveIdleTaskTCB[xPassiveIdleTaskIndex];
     *ppxIdleTaskStackBuffer = &xPassiveIdleStack[xPassiveIdleTaskIndex][0];
     *puxIdleTaskStackSize = configMINIMAL_STACK_SIZE;
-} 
\ No newline at end of file
+}
+#endif /* configNUMBER_OF_CORES > 1 */
@@ -0,0 +1,218 @@
+/**
+ * @file system_tasks.c
+ * @brief System monitor and status LED tasks
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/watchdog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "system_tasks.h"
+#include "system_init.h"
+#include "task_table.h"
+#include "status_snapshot.h"
+#include "log.h"
+#include "cpu_load.h"
+#include "supervisor.h"
+#include "periodic.h"
+#include "heap_profile.h"
+#include "stack_monitor.h"
+#include "msg_pool.h"
+#include "status_link.h"
+#include "card_poller.h"
+
+/* Notification bit set on the LED task by the status snapshot */
+#define LED_STATUS_NOTIFY_BIT   (1UL << 0)
+
+/**
+ * @brief Drive the fault and normal LEDs from the published status
+ *
+ * The fire LEDs belong to the zone alarm outputs (alarm_output.h).
+ */
+static void prvUpdateStatusLeds(void)
+{
+    system_status_t xStatus = status_snapshot_get_system();
+
+    gpio_put(LED_FAULT_PIN, xStatus == SYSTEM_STATUS_FAULT);
+    gpio_put(LED_NORMAL_PIN, xStatus == SYSTEM_STATUS_NORMAL);
+}
+
+static uint16_t prvSaturate16(uint32_t ulValue)
+{
+    return (ulValue > UINT16_MAX) ? UINT16_MAX : (uint16_t)ulValue;
+}
+
+/**
+ * @brief Hand the health figures of this report to the status link
+ */
+static void prvPublishHealth(void)
+{
+    status_link_health_t xHealth = { 0 };
+    supervisor_task_status_t xTask;
+    periodic_stats_t xPeriodicStats;
+    msg_pool_stats_t xPool;
+    cpu_load_core_t xLoad;
+    uint32_t ulOverdue = 0;
+    uint32_t ulExhausted = 0;
+    uint32_t ulMisses = 0;
+
+    for (uint32_t c = 0; (c < configNUMBER_OF_CORES) && (c < 2u); c++) {
+        if (cpu_load_get_core(c, &xLoad)) {
+            xHealth.cpu_load_permille[c] = xLoad.load_permille;
+        }
+    }
+    for (uint32_t i = 0; i < supervisor_get_task_count(); i++) {
+        if (supervisor_get_status((supervisor_id_t)i, &xTask) && xTask.overdue) {
+            ulOverdue++;
+        }
+    }
+    for (uint32_t i = 0; i < MSG_POOL_CLASS_COUNT; i++) {
+        if (msg_pool_get_stats((msg_pool_class_t)i, &xPool)) {
+            ulExhausted += xPool.exhausted;
+        }
+    }
+    for (uint32_t i = 0; i < periodic_get_task_count(); i++) {
+        if (periodic_get_stats(i, &xPeriodicStats)) {
+            ulMisses += xPeriodicStats.misses;
+        }
+    }
+
+    xHealth.overdue_tasks = (ulOverdue > UINT8_MAX) ? UINT8_MAX : (uint8_t)ulOverdue;
+    xHealth.heap_free_bytes = prvSaturate16((uint32_t)system_get_free_heap());
+    xHealth.stack_min_unused_words = prvSaturate16(stack_monitor_get_min_unused());
+    xHealth.pool_exhausted = prvSaturate16(ulExhausted);
+    xHealth.deadline_misses = prvSaturate16(ulMisses);
+    status_link_set_health(&xHealth);
+}
+
+/**
+ * @brief Status LED task
+ * 
+ * This task blinks the status LED to indicate the system is running and
+ * updates the status LEDs when notified of a status change.
+ * 
+ * @param pvParameters Task parameters (unused)
+ */
+void vStatusLedTask(void *pvParameters)
+{
+    (void)pvParameters;  /* Suppress unused parameter warning */
+    
+    static periodic_task_t xPeriodic;
+    const task_descriptor_t *pxSelf = task_table_self();
+    uint32_t ulNotifiedValue;
+    supervisor_id_t xHeartbeat;
+    
+    LOG_INFO("LED Blink Task started on core %d", get_core_num());
+    
+#if !FACP_BUILDING_CONTROLLER
+    /* The status link interrupt is serviced on this (communication) core */
+    status_link_start(g_system_config.device_address);
+#endif
+    
+    status_snapshot_subscribe(xTaskGetCurrentTaskHandle(), LED_STATUS_NOTIFY_BIT);
+    prvUpdateStatusLeds();
+    xHeartbeat = supervisor_register(pxSelf->name, TIMEOUT_HEARTBEAT_STATUS_LED_MS);
+    periodic_init(&xPeriodic, pxSelf->name, pxSelf->period_ms);
+    
+    for (;;)
+    {
+        supervisor_heartbeat(xHeartbeat);
+        
+        /* Sleep until the next toggle or a status change */
+        if (periodic_wait_notify(&xPeriodic, LED_STATUS_NOTIFY_BIT, &ulNotifiedValue)) {
+            prvUpdateStatusLeds();
+            continue;
+        }
+        
+        /* Toggle status LED */
+        gpio_put(LED_STATUS_PIN, !gpio_get(LED_STATUS_PIN));
+    }
+}
+
+/**
+ * @brief System monitor task for watchdog and health checks
+ * 
+ * This task runs the liveness supervisor, which feeds the watchdog only
+ * while every supervised task meets its heartbeat deadline, and does the
+ * once-a-second health report. The configuration CRC is checked on the
+ * DMA sniffer once at start-up, then on the CPU every report.
+ * 
+ * @param pvParameters Task parameters (unused)
+ */
+void vSystemMonitorTask(void *pvParameters)
+{
+    (void)pvParameters;  /* Suppress unused parameter warning */
+    
+    static periodic_task_t xPeriodic;
+    const task_descriptor_t *pxSelf = task_table_self();
+    const uint32_t ulChecksPerReport = 1000u / pxSelf->period_ms;
+    uint32_t ulChecks = 0;
+    uint32_t ulStackSamples = 0;
+    bool xConfigFault = false;
+#if FACP_HEAP_PROFILE
+    uint32_t ulReports = 0;
+#endif
+    
+    LOG_INFO("System Monitor Task started on core %d", get_core_num());
+    
+    /* Start the watchdog with the supervisor that feeds it */
+    watchdog_enable(TIMEOUT_WATCHDOG_RESET_MS, 1);
+    periodic_init(&xPeriodic, pxSelf->name, pxSelf->period_ms);
+    
+    /* One-shot: the DMA sniffer CRC back end must agree with the CPU */
+    if (!system_config_check_dma()) {
+        LOG_ERROR("DMA sniffer CRC mismatch");
+        status_snapshot_latch_fault();
+    }
+    
+    for (;;)
+    {
+        /* Feed the watchdog if every supervised task checked in */
+        supervisor_check();
+        
+        if (++ulChecks >= ulChecksPerReport) {
+            ulChecks = 0;
+            
+            /* Perform basic health checks */
+            LOG_INFO("System OK - Free heap: %d bytes", (int)system_get_free_heap());
+            
+            /* Refresh the per-core and per-task load report */
+            cpu_load_update();
+            
+            /* Sample the task stack high-water marks */
+            if (++ulStackSamples >= STACK_MONITOR_PERIOD_S) {
+                ulStackSamples = 0;
+                stack_monitor_update();
+            }
+            
+            /* Every configuration change is sealed, so a mismatch is
+             * corruption; report it once and latch the fault, which
+             * zone status publishes keep (an alarm still shows first) */
+            if (!xConfigFault && !system_config_check()) {
+                xConfigFault = true;
+                LOG_ERROR("System configuration CRC mismatch");
+                status_snapshot_latch_fault();
+            }
+            
+            /* Refresh the health fields of the status link frame */
+            prvPublishHealth();
+            
+#if FACP_HEAP_PROFILE
+            if (++ulReports >= HEAP_PROFILE_DUMP_PERIOD_S) {
+                ulReports = 0;
+                heap_profile_request_dump();
+            }
+#endif
+            
+            /* Update power LED to show system is alive */
+            gpio_put(LED_POWER_PIN, 1);
+        }
+        
+        /* Wait for the next cycle */
+        periodic_wait(&xPeriodic);
+    }
+}
@@ -0,0 +1,153 @@
+/**
+ * @file task_table.c
+ * @brief Static task table: storage, compile-time checks and startup
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "task_table.h"
+#include "system_tasks.h"
+#include "sensor_monitor.h"
+#include "card_poller.h"
+#include "smp_config.h"
+#include "supervisor.h"
+#include "log.h"
+#include "stack_monitor.h"
+
+/* Priority ladder: a more critical duty must preempt every less critical one */
+_Static_assert(TASK_PRIORITY_WATCHDOG > TASK_PRIORITY_SENSOR_MONITOR,
+               "supervisor must preempt sensor monitoring");
+_Static_assert(TASK_PRIORITY_SENSOR_MONITOR > TASK_PRIORITY_ALARM_CONTROL,
+               "sensor monitoring must preempt alarm control");
+_Static_assert(TASK_PRIORITY_ALARM_CONTROL > TASK_PRIORITY_COMMUNICATION,
+               "alarm control must preempt communication");
+_Static_assert(TASK_PRIORITY_COMMUNICATION > TASK_PRIORITY_STATUS_LED,
+               "communication must preempt the status LEDs");
+_Static_assert(TASK_PRIORITY_STATUS_LED > TASK_PRIORITY_DIAGNOSTICS,
+               "status LEDs must preempt diagnostics");
+_Static_assert(TASK_PRIORITY_DIAGNOSTICS > TASK_PRIORITY_LOG_DRAIN,
+               "diagnostics must preempt the log drain");
+_Static_assert(TASK_PRIORITY_LOG_DRAIN > tskIDLE_PRIORITY,
+               "the log drain must run above idle");
+
+/* Per-row limits */
+#define TASK_TABLE_CHECK(id, task, label, words, prio, mask, arg, period)               \
+    _Static_assert((prio) < configMAX_PRIORITIES, #id ": priority out of range");       \
+    _Static_assert((prio) > tskIDLE_PRIORITY, #id ": priority must be above idle");     \
+    _Static_assert((words) >= configMINIMAL_STACK_SIZE, #id ": stack below minimum");   \
+    _Static_assert(((mask) != 0) &&                                                     \
+                   (((mask) & ~(CORE_AFFINITY_SENSORS | CORE_AFFINITY_COMMUNICATION)) == 0), \
+                   #id ": affinity names no RP2040 core");
+FACP_TASK_TABLE(TASK_TABLE_CHECK)
+#undef TASK_TABLE_CHECK
+
+/* Stack and TCB bytes of the tasks that may run on a core (core mask bit) */
+#define TASK_TABLE_CORE_RAM(id, task, label, words, prio, mask, arg, period)            \
+    + ((((mask) & TASK_TABLE_CORE_BIT) != 0) ?                                          \
+       (((size_t)(words) * sizeof(StackType_t)) + sizeof(StaticTask_t)) : 0u)
+
+#define TASK_TABLE_CORE_BIT     CORE_AFFINITY_SENSORS
+_Static_assert((0u FACP_TASK_TABLE(TASK_TABLE_CORE_RAM)) <= TASK_RAM_BUDGET_CORE0,
+               "core 0 task RAM exceeds TASK_RAM_BUDGET_CORE0");
+#undef TASK_TABLE_CORE_BIT
+
+#define TASK_TABLE_CORE_BIT     CORE_AFFINITY_COMMUNICATION
+_Static_assert((0u FACP_TASK_TABLE(TASK_TABLE_CORE_RAM)) <= TASK_RAM_BUDGET_CORE1,
+               "core 1 task RAM exceeds TASK_RAM_BUDGET_CORE1");
+#undef TASK_TABLE_CORE_BIT
+
+/* Stacks and TCBs */
+#define TASK_TABLE_STORAGE(id, task, label, words, prio, mask, arg, period)             \
+    static StackType_t xStack_##id[words];                                              \
+    static StaticTask_t xTCB_##id;
+FACP_TASK_TABLE(TASK_TABLE_STORAGE)
+#undef TASK_TABLE_STORAGE
+
+/* Entry points and stack sizes for the post-build stack check */
+#define TASK_TABLE_STACK_INFO(id, task, label, words, prio, mask, arg, period)          \
+    STACK_INFO_RECORD(id, task, words);
+FACP_TASK_TABLE(TASK_TABLE_STACK_INFO)
+#undef TASK_TABLE_STACK_INFO
+
+static const task_descriptor_t xTaskTable[TASK_ID_COUNT] = {
+#define TASK_TABLE_ROW(id, task, label, words, prio, mask, arg, period)                 \
+    [TASK_ID_##id] = {                                                                  \
+        .function = (task),                                                             \
+        .name = (label),                                                                \
+        .stack_words = (words),                                                         \
+        .priority = (prio),                                                             \
+        .affinity = (mask),                                                             \
+        .parameter = (void *)(arg),                                                     \
+        .period_ms = (period),                                                          \
+        .stack = xStack_##id,                                                           \
+        .tcb = &xTCB_##id,                                                              \
+    },
+    FACP_TASK_TABLE(TASK_TABLE_ROW)
+#undef TASK_TABLE_ROW
+};
+
+static TaskHandle_t xTaskHandles[TASK_ID_COUNT];
+
+bool task_table_create(task_id_t id)
+{
+    const task_descriptor_t *pxTask = task_table_get(id);
+
+    if ((pxTask == NULL) || (xTaskHandles[id] != NULL)) {
+        return false;
+    }
+
+#if (configUSE_CORE_AFFINITY == 1) && (configNUMBER_OF_CORES > 1)
+    xTaskHandles[id] = xTaskCreateStaticAffinitySet(pxTask->function, pxTask->name,
+                                                    pxTask->stack_words, pxTask->parameter,
+                                                    pxTask->priority, pxTask->stack,
+                                                    pxTask->tcb, pxTask->affinity);
+#else
+    xTaskHandles[id] = xTaskCreateStatic(pxTask->function, pxTask->name,
+                                         pxTask->stack_words, pxTask->parameter,
+                                         pxTask->priority, pxTask->stack, pxTask->tcb);
+#endif
+
+    if (xTaskHandles[id] == NULL) {
+        LOG_ERROR("Failed to create task '%s'", pxTask->name);
+        return false;
+    }
+
+    LOG_DEBUG("Task '%s' created with core affinity: 0x%02X",
+              pxTask->name, (unsigned int)pxTask->affinity);
+    return true;
+}
+
+bool task_table_start(void)
+{
+    for (uint32_t id = 0; id < TASK_ID_COUNT; id++) {
+        if (!task_table_create((task_id_t)id)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const task_descriptor_t *task_table_get(task_id_t id)
+{
+    return ((uint32_t)id < TASK_ID_COUNT) ? &xTaskTable[id] : NULL;
+}
+
+const task_descriptor_t *task_table_self(void)
+{
+    TaskHandle_t xCurrent = xTaskGetCurrentTaskHandle();
+
+    for (uint32_t id = 0; id < TASK_ID_COUNT; id++) {
+        if (xTaskHandles[id] == xCurrent) {
+            return &xTaskTable[id];
+        }
+    }
+    return NULL;
+}
+
+TaskHandle_t task_table_get_handle(task_id_t id)
+{
+    return ((uint32_t)id < TASK_ID_COUNT) ? xTaskHandles[id] : NULL;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file trace.c
+ * @brief Per-core kernel event rings and text dump
+ *
+ * Recording masks interrupts for the few stores of one event, so each
+ * ring only ever has writers from its own core and needs no lock. The
+ * rings overwrite their oldest events; the dump freezes them first.
+ *
+ * Dump format, one record per line:
+ *   TRACE BEGIN <version> <cores> <timestamp Hz>
+ *   TRACE TASK <number> <priority> <name>
+ *   TRACE ISR <id> <name>
+ *   TRACE EVENTS <core> <count>
+ *   TRACE EV <core> <hex events>      (up to 16 events, 8 bytes each, LE)
+ *   TRACE END
+ *
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace.h"
+
+#if FACP_TRACE
+
+#define TRACE_CORES             configNUMBER_OF_CORES
+#define TRACE_RING_MASK         (TRACE_RING_EVENTS - 1u)
+#define TRACE_DUMP_VERSION      1
+#define TRACE_DUMP_MAX_TASKS    24
+#define TRACE_EVENTS_PER_LINE   16
+
+#if (TRACE_RING_EVENTS & TRACE_RING_MASK) != 0
+#error "TRACE_RING_EVENTS must be a power of two"
+#endif
+
+typedef struct {
+    trace_event_t events[TRACE_RING_EVENTS];
+    volatile uint32_t head;             /* Total events recorded */
+} trace_ring_t;
+
+static trace_ring_t xTraceRings[TRACE_CORES];
+static volatile bool xTraceRunning = true;
+static volatile uint16_t usNextQueueNumber = 1;
+
+static const char *const pcIsrNames[TRACE_ISR_COUNT] = {
+    [TRACE_ISR_ZONE_GPIO] = "zone_gpio",
+    [TRACE_ISR_ZONE_PIO] = "zone_pio",
+    [TRACE_ISR_ADC_DMA] = "adc_dma",
+    [TRACE_ISR_STATUS_LINK] = "status_link",
+    [TRACE_ISR_CARD_POLLER] = "card_poller",
+    [TRACE_ISR_CARD_ATTENTION] = "card_attention",
+};
+
+void trace_record(uint8_t type, uint8_t arg, uint16_t id)
+{
+    UBaseType_t uxSaved;
+    trace_ring_t *pxRing;
+    trace_event_t *pxEvent;
+
+    if (!xTraceRunning) {
+        return;
+    }
+
+    uxSaved = portSET_INTERRUPT_MASK_FROM_ISR();
+    pxRing = &xTraceRings[get_core_num()];
+    pxEvent = &pxRing->events[pxRing->head & TRACE_RING_MASK];
+    pxEvent->timestamp_us = time_us_32();
+    pxEvent->type = type;
+    pxEvent->arg = arg;
+    pxEvent->id = id;
+    pxRing->head++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSaved);
+}
+
+void trace_record_current_task(uint8_t type, uint8_t arg)
+{
+    TaskHandle_t xTask = xTaskGetCurrentTaskHandle();
+
+    trace_record(type, arg, (xTask != NULL) ? (uint16_t)uxTaskGetTaskNumber(xTask) : 0);
+}
+
+uint16_t trace_next_queue_number(void)
+{
+    uint16_t usNumber;
+
+    /* Queues are only created from tasks */
+    taskENTER_CRITICAL();
+    usNumber = usNextQueueNumber;
+    usNextQueueNumber = usNumber + 1u;
+    taskEXIT_CRITICAL();
+    return usNumber;
+}
+
+void trace_start(void)
+{
+    xTraceRunning = true;
+}
+
+void trace_stop(void)
+{
+    xTraceRunning = false;
+}
+
+static void prvDumpTasks(void)
+{
+    static TaskStatus_t xStatus[TRACE_DUMP_MAX_TASKS];
+    UBaseType_t uxCount = uxTaskGetSystemState(xStatus, TRACE_DUMP_MAX_TASKS, NULL);
+
+    for (UBaseType_t i = 0; i < uxCount; i++) {
+        printf("TRACE TASK %lu %lu %s\n", (unsigned long)xStatus[i].xTaskNumber,
+               (unsigned long)xStatus[i].uxBasePriority, xStatus[i].pcTaskName);
+    }
+}
+
+static void prvDumpRings(void)
+{
+    static const char cHex[] = "0123456789abcdef";
+
+    for (uint32_t isr = 1; isr < TRACE_ISR_COUNT; isr++) {
+        printf("TRACE ISR %lu %s\n", (unsigned long)isr, pcIsrNames[isr]);
+    }
+
+    for (uint32_t core = 0; core < TRACE_CORES; core++) {
+        const trace_ring_t *pxRing = &xTraceRings[core];
+        uint32_t ulHead = pxRing->head;
+        uint32_t ulCount = (ulHead < TRACE_RING_EVENTS) ? ulHead : TRACE_RING_EVENTS;
+        uint32_t ulIndex = ulHead - ulCount;
+
+        printf("TRACE EVENTS %lu %lu\n", (unsigned long)core, (unsigned long)ulCount);
+
+        while (ulCount > 0) {
+            char cLine[TRACE_EVENTS_PER_LINE * 2 * sizeof(trace_event_t) + 1];
+            uint32_t ulLine = (ulCount < TRACE_EVENTS_PER_LINE) ? ulCount : TRACE_EVENTS_PER_LINE;
+            uint32_t ulPos = 0;
+
+            for (uint32_t i = 0; i < ulLine; i++, ulIndex++) {
+                const trace_event_t *pxEvent = &pxRing->events[ulIndex & TRACE_RING_MASK];
+                uint8_t ucBytes[sizeof(trace_event_t)] = {
+                    (uint8_t)pxEvent->timestamp_us, (uint8_t)(pxEvent->timestamp_us >> 8),
+                    (uint8_t)(pxEvent->timestamp_us >> 16), (uint8_t)(pxEvent->timestamp_us >> 24),
+                    pxEvent->type, pxEvent->arg,
+                    (uint8_t)pxEvent->id, (uint8_t)(pxEvent->id >> 8)
+                };
+
+                for (uint32_t b = 0; b < sizeof(ucBytes); b++) {
+                    cLine[ulPos++] = cHex[ucBytes[b] >> 4];
+                    cLine[ulPos++] = cHex[ucBytes[b] & 0x0Fu];
+                }
+            }
+            cLine[ulPos] = '\0';
+            printf("TRACE EV %lu %s\n", (unsigned long)core, cLine);
+            ulCount -= ulLine;
+        }
+    }
+
+    printf("TRACE END\n");
+    fflush(stdout);
+}
+
+void trace_dump(void)
+{
+    trace_stop();
+    printf("TRACE BEGIN %d %d 1000000\n", TRACE_DUMP_VERSION, TRACE_CORES);
+    prvDumpTasks();
+    prvDumpRings();
+    trace_start();
+}
+
+void trace_panic_dump(void)
+{
+    xTraceRunning = false;
+    printf("TRACE BEGIN %d %d 1000000\n", TRACE_DUMP_VERSION, TRACE_CORES);
+    prvDumpRings();
+}
+
+#else /* FACP_TRACE */
+
+void trace_start(void)
+{
+}
+
+void trace_stop(void)
+{
+}
+
+void trace_dump(void)
+{
+}
+
+void trace_panic_dump(void)
+{
+}
+
+#endif /* FACP_TRACE */
@@ -0,0 +1,146 @@
+/**
+ * @file zone_filter.c
+ * @brief PIO glitch filter driver for the zone inputs
+ * 
+ * Runs zone_filter.pio on a free PIO0 state machine. The RX FIFO interrupt
+ * decodes each event word into per-channel edges and queues them through
+ * zone_input_push_from_isr(), so the sensor task sees the same edge stream
+ * as with GPIO interrupts, minus the bounce. Fire inputs that turn active
+ * first go to the alarm output fast path.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "zone_filter.h"
+#include "zone_input.h"
+#include "alarm_output.h"
+#include "zone_filter.pio.h"
+#include "log.h"
+#include "trace.h"
+
+#define ZONE_FILTER_PIO         pio0
+#define ZONE_FILTER_PIO_IRQ     PIO0_IRQ_0
+
+static int lFilterSm = -1;
+static uint lFilterOffset;
+static uint32_t ulFilterState;          /* Last state forwarded to zone_input */
+static uint32_t ulFilterPeriodUs;       /* Sample period, rounded to us */
+static uint32_t ulFilterConfirmUs;      /* Confirm delay subtracted from timestamps */
+static volatile uint32_t ulFilterEvents;
+
+/**
+ * @brief PIO RX FIFO interrupt: forward filtered transitions
+ */
+static void prvZoneFilterIrqHandler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    PIO pio = ZONE_FILTER_PIO;
+    uint sm = (uint)lFilterSm;
+
+    TRACE_ISR_ENTER(TRACE_ISR_ZONE_PIO);
+
+    while (!pio_sm_is_rx_fifo_empty(pio, sm)) {
+        uint32_t ulWord = pio_sm_get(pio, sm);
+        uint32_t ulNew = ZONE_FILTER_EVENT_NEW_STATE(ulWord);
+        uint32_t ulChanged = ulNew ^ ulFilterState;
+
+        /* The input changed ulFilterConfirmUs before the event was pushed */
+        uint64_t ullEdgeTime = time_us_64() - ulFilterConfirmUs;
+
+        /* Confirmed fire inputs sound before anything is queued */
+        alarm_output_fast_from_isr((ulChanged & ulNew) >> ZONE_INPUT_FIRE_1, ullEdgeTime);
+
+        ulFilterEvents++;
+
+        for (uint32_t ch = 0; ch < ZONE_INPUT_CHANNEL_COUNT; ch++) {
+            if (ulChanged & (1u << ch)) {
+                zone_input_push_from_isr((zone_input_channel_t)ch,
+                                         (ulNew >> ch) & 1u, ullEdgeTime,
+                                         &xHigherPriorityTaskWoken);
+            }
+        }
+        ulFilterState = ulNew;
+    }
+
+    TRACE_ISR_EXIT(TRACE_ISR_ZONE_PIO);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+bool zone_filter_start(uint32_t sample_hz, uint32_t confirm_samples)
+{
+    uint32_t ulLoopHz;
+    uint32_t ulDiv;
+
+    if ((lFilterSm >= 0) || (sample_hz == 0) || (confirm_samples == 0) ||
+        (confirm_samples > ZONE_FILTER_MAX_CONFIRM_SAMPLES)) {
+        return false;
+    }
+
+    /* Clock divider in 16.8 fixed point */
+    ulLoopHz = sample_hz * ZONE_FILTER_CYCLES_PER_SAMPLE;
+    ulDiv = (uint32_t)(((uint64_t)clock_get_hz(clk_sys) << 8) / ulLoopHz);
+    if ((ulDiv < 0x100u) || (ulDiv > 0xFFFFFFu)) {
+        LOG_WARN("Zone filter: %u Hz sample rate out of range", (unsigned)sample_hz);
+        return false;
+    }
+
+    if (!pio_can_add_program(ZONE_FILTER_PIO, &zone_filter_program)) {
+        return false;
+    }
+    lFilterSm = pio_claim_unused_sm(ZONE_FILTER_PIO, false);
+    if (lFilterSm < 0) {
+        return false;
+    }
+    lFilterOffset = pio_add_program(ZONE_FILTER_PIO, &zone_filter_program);
+
+    ulFilterPeriodUs = (1000000u + (sample_hz / 2u)) / sample_hz;
+    ulFilterConfirmUs = ulFilterPeriodUs * confirm_samples;
+    ulFilterState = gpio_get_all() >> ZONE_INPUT_FIRST_GPIO;
+    ulFilterState &= ZONE_FILTER_INPUT_MASK;
+    ulFilterEvents = 0;
+
+    /* Handle events on this core, next to the consuming task */
+    irq_set_exclusive_handler(ZONE_FILTER_PIO_IRQ, prvZoneFilterIrqHandler);
+    pio_set_irq0_source_enabled(ZONE_FILTER_PIO,
+                                (enum pio_interrupt_source)(pis_sm0_rx_fifo_not_empty + lFilterSm),
+                                true);
+    irq_set_enabled(ZONE_FILTER_PIO_IRQ, true);
+
+    zone_filter_program_init(ZONE_FILTER_PIO, (uint)lFilterSm, lFilterOffset,
+                             ZONE_INPUT_FIRST_GPIO, confirm_samples,
+                             (uint16_t)(ulDiv >> 8), (uint8_t)(ulDiv & 0xFFu));
+
+    LOG_INFO("Zone filter: PIO0 SM%d, %u Hz, %u samples (%u us)",
+             lFilterSm, (unsigned)sample_hz, (unsigned)confirm_samples,
+             (unsigned)ulFilterConfirmUs);
+    return true;
+}
+
+void zone_filter_stop(void)
+{
+    if (lFilterSm < 0) {
+        return;
+    }
+
+    pio_sm_set_enabled(ZONE_FILTER_PIO, (uint)lFilterSm, false);
+    pio_set_irq0_source_enabled(ZONE_FILTER_PIO,
+                                (enum pio_interrupt_source)(pis_sm0_rx_fifo_not_empty + lFilterSm),
+                                false);
+    irq_set_enabled(ZONE_FILTER_PIO_IRQ, false);
+    irq_remove_handler(ZONE_FILTER_PIO_IRQ, prvZoneFilterIrqHandler);
+    pio_remove_program(ZONE_FILTER_PIO, &zone_filter_program, lFilterOffset);
+    pio_sm_unclaim(ZONE_FILTER_PIO, (uint)lFilterSm);
+    lFilterSm = -1;
+}
+
+uint32_t zone_filter_get_event_count(void)
+{
+    return ulFilterEvents;
+}
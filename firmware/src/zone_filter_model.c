@@ -0,0 +1,86 @@
+/**
+ * @file zone_filter_model.c
+ * @brief Bit-exact C model of the zone_filter PIO program
+ * 
+ * Each call to zone_filter_model_step() corresponds to one execution of
+ * "in pins, 4" in zone_filter.pio. Keep the two in step.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include "zone_filter.h"
+
+/**
+ * @brief Replicate a 4-bit state into all nibbles, as the rebuild loop does
+ */
+static uint32_t prvReplicate(uint32_t state)
+{
+    return (state & ZONE_FILTER_INPUT_MASK) * 0x11111111u;
+}
+
+void zone_filter_model_init(zone_filter_model_t *model, uint32_t confirm_samples)
+{
+    if (confirm_samples == 0) {
+        confirm_samples = 1;
+    } else if (confirm_samples > ZONE_FILTER_MAX_CONFIRM_SAMPLES) {
+        confirm_samples = ZONE_FILTER_MAX_CONFIRM_SAMPLES;
+    }
+
+    model->stable = 0;
+    model->candidate = 0;
+    model->count = 0;
+    model->confirm_samples = confirm_samples;
+    model->confirming = false;
+    model->started = false;
+}
+
+bool zone_filter_model_step(zone_filter_model_t *model, uint32_t sample,
+                            uint32_t *event_word)
+{
+    uint32_t ulY;
+
+    sample &= ZONE_FILTER_INPUT_MASK;
+
+    /* Program start: push the initial state and rebuild X */
+    if (!model->started) {
+        model->started = true;
+        model->stable = prvReplicate(sample);
+        *event_word = sample;
+        return true;
+    }
+
+    /* mov isr, x; in pins, 4; then mov y, isr (idle) or mov x, isr (confirm) */
+    ulY = (model->stable << 4) | sample;
+
+    if (!model->confirming) {
+        if (ulY == model->stable) {
+            return false;
+        }
+        /* Candidate: mov osr, null */
+        model->confirming = true;
+        model->candidate = ulY;
+        model->count = 0;
+    } else if (ulY != model->candidate) {
+        /* Restart: mov y, x; mov osr, null */
+        model->candidate = ulY;
+        model->count = 0;
+    }
+
+    /* out null, 1 per sample equal to the candidate */
+    model->count++;
+    if (model->count < model->confirm_samples) {
+        return false;
+    }
+    model->confirming = false;
+
+    /* A run of the stable state is no change */
+    if (model->candidate == model->stable) {
+        return false;
+    }
+
+    /* push noblock; rebuild */
+    *event_word = model->candidate;
+    model->stable = prvReplicate(sample);
+    return true;
+}
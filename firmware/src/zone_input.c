@@ -0,0 +1,181 @@
+/**
+ * @file zone_input.c
+ * @brief Interrupt-driven zone input capture implementation
+ * 
+ * Each channel has a single-producer/single-consumer ring: the GPIO
+ * interrupt only advances the head and the consumer task only advances
+ * the tail, so neither side takes a lock.
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "zone_input.h"
+#include "zone_filter.h"
+#include "system_init.h"
+#include "trace.h"
+
+#define ZONE_INPUT_RING_MASK    (ZONE_INPUT_RING_SIZE - 1u)
+
+#if (ZONE_INPUT_RING_SIZE & ZONE_INPUT_RING_MASK) != 0
+#error "ZONE_INPUT_RING_SIZE must be a power of two"
+#endif
+
+/* Per-channel edge ring */
+typedef struct {
+    zone_edge_t edges[ZONE_INPUT_RING_SIZE];
+    volatile uint32_t head;             /* Advanced by the interrupt only */
+    volatile uint32_t tail;             /* Advanced by the consumer only */
+    volatile uint32_t overruns;         /* Written by the interrupt only */
+    volatile bool latest;               /* Newest level, dropped or not; interrupt only */
+    bool level;                         /* Last consumed level */
+    uint32_t overruns_applied;          /* Overruns covered by level */
+    zone_input_stats_t stats;           /* Consumer-side statistics */
+} zone_ring_t;
+
+static zone_ring_t xZoneRings[ZONE_INPUT_CHANNEL_COUNT];
+static TaskHandle_t xZoneNotifyTask = NULL;
+
+/**
+ * @brief GPIO edge callback for the zone inputs
+ */
+static void prvZoneInputGpioCallback(uint gpio, uint32_t events)
+{
+    uint64_t ullNow = time_us_64();
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    bool xLevel;
+
+    if ((gpio < ZONE_INPUT_FIRST_GPIO) ||
+        (gpio >= (ZONE_INPUT_FIRST_GPIO + ZONE_INPUT_CHANNEL_COUNT))) {
+        return;
+    }
+
+    TRACE_ISR_ENTER(TRACE_ISR_ZONE_GPIO);
+
+    /* Both edges latched means the input bounced; sample the pin */
+    if (events == GPIO_IRQ_EDGE_RISE) {
+        xLevel = true;
+    } else if (events == GPIO_IRQ_EDGE_FALL) {
+        xLevel = false;
+    } else {
+        xLevel = gpio_get(gpio);
+    }
+
+    zone_input_push_from_isr((zone_input_channel_t)(gpio - ZONE_INPUT_FIRST_GPIO),
+                             xLevel, ullNow, &xHigherPriorityTaskWoken);
+
+    TRACE_ISR_EXIT(TRACE_ISR_ZONE_GPIO);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void zone_input_init(TaskHandle_t xNotifyTask)
+{
+    memset(xZoneRings, 0, sizeof(xZoneRings));
+    xZoneNotifyTask = xNotifyTask;
+
+    for (uint32_t ch = 0; ch < ZONE_INPUT_CHANNEL_COUNT; ch++) {
+        uint gpio = ZONE_INPUT_FIRST_GPIO + ch;
+
+        gpio_init(gpio);
+        gpio_set_dir(gpio, GPIO_IN);
+        gpio_pull_down(gpio);
+        xZoneRings[ch].level = gpio_get(gpio);
+    }
+
+    /* Prefer the PIO glitch filter; it queues edges through the same rings */
+    if (g_system_config.input_filter_enabled &&
+        zone_filter_start(g_system_config.input_filter_sample_hz,
+                          g_system_config.input_filter_confirm_samples)) {
+        return;
+    }
+
+    /* One shared callback per core; enable the remaining pins after it */
+    gpio_set_irq_enabled_with_callback(ZONE_INPUT_FIRST_GPIO,
+                                       GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL,
+                                       true, prvZoneInputGpioCallback);
+    for (uint32_t ch = 1; ch < ZONE_INPUT_CHANNEL_COUNT; ch++) {
+        gpio_set_irq_enabled(ZONE_INPUT_FIRST_GPIO + ch,
+                             GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+    }
+}
+
+void zone_input_push_from_isr(zone_input_channel_t channel, bool level,
+                              uint64_t timestamp_us,
+                              BaseType_t *pxHigherPriorityTaskWoken)
+{
+    zone_ring_t *pxRing = &xZoneRings[channel];
+    uint32_t ulHead = pxRing->head;
+
+    /* A full ring drops the edge but not its level, which the consumer
+     * picks up once it has drained the ring */
+    pxRing->latest = level;
+    if ((ulHead - pxRing->tail) >= ZONE_INPUT_RING_SIZE) {
+        __dmb();
+        pxRing->overruns++;
+    } else {
+        pxRing->edges[ulHead & ZONE_INPUT_RING_MASK].timestamp_us = timestamp_us;
+        pxRing->edges[ulHead & ZONE_INPUT_RING_MASK].level = level;
+
+        /* Publish the edge before the new head */
+        __dmb();
+        pxRing->head = ulHead + 1u;
+    }
+
+    if (xZoneNotifyTask != NULL) {
+        xTaskNotifyFromISR(xZoneNotifyTask, ZONE_INPUT_NOTIFY_BIT(channel),
+                           eSetBits, pxHigherPriorityTaskWoken);
+    }
+}
+
+bool zone_input_pop(zone_input_channel_t channel, zone_edge_t *edge)
+{
+    zone_ring_t *pxRing = &xZoneRings[channel];
+    uint32_t ulTail = pxRing->tail;
+    uint32_t ulLatency;
+
+    if (ulTail == pxRing->head) {
+        uint32_t ulOverruns = pxRing->overruns;
+
+        /* Dropped edges: settle on the newest level seen by the interrupt */
+        if (ulOverruns != pxRing->overruns_applied) {
+            __dmb();
+            pxRing->level = pxRing->latest;
+            pxRing->overruns_applied = ulOverruns;
+        }
+        return false;
+    }
+
+    /* Read the edge only after observing the head that published it */
+    __dmb();
+    *edge = pxRing->edges[ulTail & ZONE_INPUT_RING_MASK];
+    __dmb();
+    pxRing->tail = ulTail + 1u;
+
+    ulLatency = (uint32_t)(time_us_64() - edge->timestamp_us);
+    pxRing->level = edge->level;
+    pxRing->stats.edges++;
+    pxRing->stats.last_latency_us = ulLatency;
+    pxRing->stats.total_latency_us += ulLatency;
+    if (ulLatency > pxRing->stats.max_latency_us) {
+        pxRing->stats.max_latency_us = ulLatency;
+    }
+
+    return true;
+}
+
+bool zone_input_get_level(zone_input_channel_t channel)
+{
+    return xZoneRings[channel].level;
+}
+
+void zone_input_get_stats(zone_input_channel_t channel, zone_input_stats_t *stats)
+{
+    *stats = xZoneRings[channel].stats;
+    stats->overruns = xZoneRings[channel].overruns;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file zone_table.c
+ * @brief Struct-of-arrays zone table implementation
+ * 
+ * @author FACP Development Team
+ * @date 2024
+ */
+
+#include <string.h>
+#include "zone_table.h"
+
+#if (MAX_ZONES < 1) || (MAX_ZONES > 65535)
+#error "FACP_MAX_ZONES must be between 1 and 65535"
+#endif
+
+zone_table_t g_zone_table;
+
+/**
+ * @brief Zones of a mask word that count towards status
+ */
+static inline uint32_t prvActive(uint32_t word)
+{
+    return g_zone_table.configured[word] & ~g_zone_table.disabled[word];
+}
+
+void zone_table_init(uint32_t zone_count)
+{
+    if (zone_count > MAX_ZONES) {
+        zone_count = MAX_ZONES;
+    }
+
+    memset(&g_zone_table, 0, sizeof(g_zone_table));
+    g_zone_table.zone_count = zone_count;
+
+    for (uint32_t w = 0; w < ZONE_MASK_WORDS; w++) {
+        uint32_t ulFirst = w * 32u;
+
+        if (zone_count >= ulFirst + 32u) {
+            g_zone_table.configured[w] = UINT32_MAX;
+        } else if (zone_count > ulFirst) {
+            g_zone_table.configured[w] = (1UL << (zone_count - ulFirst)) - 1u;
+        }
+    }
+
+    for (uint32_t zone = 0; zone < MAX_ZONES; zone++) {
+        g_zone_table.threshold[zone] = ZONE_DEFAULT_THRESHOLD;
+    }
+}
+
+uint32_t zone_table_update(uint32_t word, uint32_t owned, uint32_t alarm,
+                           uint32_t fault, uint32_t now_ms)
+{
+    uint32_t ulOldAlarm;
+    uint32_t ulOldFault;
+    uint32_t ulRaised;
+    uint32_t ulChanged;
+
+    if (word >= ZONE_MASK_WORDS) {
+        return 0;
+    }
+
+    owned &= g_zone_table.configured[word];
+    ulOldAlarm = g_zone_table.alarm[word];
+    ulOldFault = g_zone_table.fault[word];
+
+    /* Alarms latch until zone_table_reset_alarm() */
+    g_zone_table.alarm[word] = ulOldAlarm | (alarm & owned);
+    g_zone_table.fault[word] = (ulOldFault & ~owned) | (fault & owned);
+
+    ulChanged = ((ulOldAlarm ^ g_zone_table.alarm[word]) |
+                 (ulOldFault ^ g_zone_table.fault[word]));
+
+    /* Per-zone columns only for zones that changed */
+    for (uint32_t ulBits = ulChanged; ulBits != 0; ulBits &= ulBits - 1u) {
+        uint32_t zone = (word * 32u) + (uint32_t)__builtin_ctz(ulBits);
+
+        g_zone_table.last_change_ms[zone] = now_ms;
+    }
+
+    ulRaised = g_zone_table.alarm[word] & ~ulOldAlarm;
+    for (; ulRaised != 0; ulRaised &= ulRaised - 1u) {
+        g_zone_table.alarm_count[(word * 32u) + (uint32_t)__builtin_ctz(ulRaised)]++;
+    }
+
+    ulRaised = g_zone_table.fault[word] & ~ulOldFault;
+    for (; ulRaised != 0; ulRaised &= ulRaised - 1u) {
+        g_zone_table.fault_count[(word * 32u) + (uint32_t)__builtin_ctz(ulRaised)]++;
+    }
+
+    return ulChanged;
+}
+
+uint32_t zone_table_reset_alarm(uint32_t word, uint32_t zones, uint32_t now_ms)
+{
+    uint32_t ulCleared;
+
+    if (word >= ZONE_MASK_WORDS) {
+        return 0;
+    }
+
+    ulCleared = g_zone_table.alarm[word] & zones;
+    g_zone_table.alarm[word] &= ~ulCleared;
+
+    for (uint32_t ulBits = ulCleared; ulBits != 0; ulBits &= ulBits - 1u) {
+        g_zone_table.last_change_ms[(word * 32u) + (uint32_t)__builtin_ctz(ulBits)] = now_ms;
+    }
+
+    return ulCleared;
+}
+
+void zone_table_set_disabled(uint32_t zone, bool disabled)
+{
+    if (zone >= MAX_ZONES) {
+        return;
+    }
+
+    if (disabled) {
+        g_zone_table.disabled[ZONE_MASK_WORD(zone)] |= ZONE_MASK_BIT(zone);
+    } else {
+        g_zone_table.disabled[ZONE_MASK_WORD(zone)] &= ~ZONE_MASK_BIT(zone);
+    }
+}
+
+zone_status_t zone_table_get_status(uint32_t zone)
+{
+    uint32_t w = ZONE_MASK_WORD(zone);
+    uint32_t ulBit = ZONE_MASK_BIT(zone);
+
+    if ((zone >= MAX_ZONES) || ((prvActive(w) & ulBit) == 0)) {
+        return ZONE_STATUS_DISABLED;
+    }
+    if (g_zone_table.alarm[w] & ulBit) {
+        return ZONE_STATUS_ALARM;
+    }
+    if (g_zone_table.fault[w] & ulBit) {
+        return ZONE_STATUS_FAULT;
+    }
+    return ZONE_STATUS_NORMAL;
+}
+
+uint32_t zone_table_count_alarm(void)
+{
+    uint32_t ulCount = 0;
+
+    for (uint32_t w = 0; w < ZONE_MASK_WORDS; w++) {
+        ulCount += (uint32_t)__builtin_popcount(g_zone_table.alarm[w] & prvActive(w));
+    }
+    return ulCount;
+}
+
+uint32_t zone_table_count_fault(void)
+{
+    uint32_t ulCount = 0;
+
+    for (uint32_t w = 0; w < ZONE_MASK_WORDS; w++) {
+        ulCount += (uint32_t)__builtin_popcount(g_zone_table.fault[w] &
+                                                ~g_zone_table.alarm[w] & prvActive(w));
+    }
+    return ulCount;
+}
+
+system_status_t zone_table_system_status(void)
+{
+    uint32_t ulAlarm = 0;
+    uint32_t ulFault = 0;
+
+    for (uint32_t w = 0; w < ZONE_MASK_WORDS; w++) {
+        uint32_t ulActive = prvActive(w);
+
+        ulAlarm |= g_zone_table.alarm[w] & ulActive;
+        ulFault |= g_zone_table.fault[w] & ulActive;
+    }
+
+    return ulAlarm ? SYSTEM_STATUS_ALARM :
+           ulFault ? SYSTEM_STATUS_FAULT : SYSTEM_STATUS_NORMAL;
+}
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""Symbolize an FACP iZone heap profile dump.
+
+Firmware built with -DFACP_HEAP_PROFILE=ON prints its per-call-site
+heap statistics as "HEAPPROF ..." lines (see src/heap_profile.c); other
+lines in the capture are ignored and the last complete dump is used.
+Call sites are stored relative to heap_profile_dump(), whose address is
+looked up in the ELF with nm; addr2line turns them into function and
+source line.
+
+The report lists the heap totals and fragmentation (largest free block
+against free bytes), the request that failed if any, and one row per
+call site sorted by peak live bytes, with a lifetime histogram.
+
+Usage:
+    heap_profile.py build/facp_izone.elf capture.txt
+    heap_profile.py build/facp_izone.elf capture.txt --sort total --csv
+"""
+
+import argparse
+import struct
+import subprocess
+import sys
+
+MAGIC = 0x46525048
+VERSION = 1
+ANCHOR_SYMBOL = "heap_profile_dump"
+LIFE_BUCKETS = ["<10ms", "<100ms", "<1s", "<10s", "<60s", ">=60s"]
+
+HEADER_FIELDS = ("magic", "version_sites", "anchor", "heap_size", "free",
+                 "min_ever_free", "largest_free", "free_blocks", "untracked",
+                 "failed_offset", "failed_size")
+SITE_FIELDS = ("offset", "allocs", "frees", "failures", "live", "peak", "total")
+
+SORT_KEYS = ("peak", "live", "total", "allocs")
+
+
+def words(hex_text):
+    raw = bytes.fromhex(hex_text)
+    return struct.unpack("<%dI" % (len(raw) // 4), raw)
+
+
+def signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def parse(lines):
+    """Return (header, sites) of the last complete dump, or None."""
+    result = None
+    header = None
+    sites = []
+    for line in lines:
+        fields = line.strip().split()
+        if len(fields) < 2 or fields[0] != "HEAPPROF":
+            continue
+        if fields[1] == "H" and len(fields) == 3:
+            values = words(fields[2])
+            header = dict(zip(HEADER_FIELDS, values))
+            if header["magic"] != MAGIC or (header["version_sites"] & 0xFFFF) != VERSION:
+                header = None
+                continue
+            header["sites"] = header["version_sites"] >> 16
+            header["failed_offset"] = signed(header["failed_offset"])
+            sites = []
+        elif fields[1] == "S" and len(fields) == 3 and header is not None:
+            values = words(fields[2])
+            site = dict(zip(SITE_FIELDS, values))
+            site["offset"] = signed(site["offset"])
+            site["life"] = list(values[len(SITE_FIELDS):])
+            sites.append(site)
+        elif fields[1] == "END" and header is not None:
+            if len(sites) == header["sites"]:
+                result = (header, sites)
+            header = None
+    return result
+
+
+def anchor_address(elf, nm):
+    out = subprocess.run([nm, elf], check=True, capture_output=True, text=True).stdout
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 3 and parts[2] == ANCHOR_SYMBOL:
+            return int(parts[0], 16) & ~1
+    raise SystemExit(f"{elf}: no symbol {ANCHOR_SYMBOL}; was it built with FACP_HEAP_PROFILE?")
+
+
+def symbolize(elf, addr2line, addresses):
+    """Map return addresses to 'function file:line' of the call."""
+    if not addresses:
+        return {}
+    # The return address follows the call; step back into it
+    queries = ["0x%x" % ((address & ~1) - 1) for address in addresses]
+    out = subprocess.run([addr2line, "-f", "-C", "-s", "-e", elf] + queries,
+                         check=True, capture_output=True, text=True).stdout.splitlines()
+    names = {}
+    for i, address in enumerate(addresses):
+        function = out[2 * i] if 2 * i < len(out) else "??"
+        location = out[2 * i + 1] if 2 * i + 1 < len(out) else "??:0"
+        names[address] = f"{function} {location.split(' ')[0]}"
+    return names
+
+
+def report(header, sites, names, base, sort_key, out):
+    free = header["free"]
+    largest = header["largest_free"]
+    fragmentation = (100.0 * (1.0 - largest / free)) if free else 0.0
+
+    print(f"heap {header['heap_size']} B, free {free} B, minimum ever free "
+          f"{header['min_ever_free']} B", file=out)
+    print(f"largest free block {largest} B in {header['free_blocks']} free blocks "
+          f"(fragmentation {fragmentation:.1f}%)", file=out)
+    if header["untracked"]:
+        print(f"untracked allocations: {header['untracked']} "
+              f"(site or live table full, or before heap_profile_init)", file=out)
+    if header["failed_size"]:
+        site = names.get(base + header["failed_offset"], "??")
+        print(f"failed request: {header['failed_size']} B from {site}", file=out)
+    print(file=out)
+
+    print(f"{'peak':>7} {'live':>7} {'total':>9} {'allocs':>7} {'frees':>7} {'fail':>4}  "
+          f"{' '.join(f'{b:>6}' for b in LIFE_BUCKETS)}  site", file=out)
+    for site in sorted(sites, key=lambda s: s[sort_key], reverse=True):
+        print(f"{site['peak']:>7} {site['live']:>7} {site['total']:>9} {site['allocs']:>7} "
+              f"{site['frees']:>7} {site['failures']:>4}  "
+              f"{' '.join(f'{n:>6}' for n in site['life'])}  "
+              f"{names.get(base + site['offset'], '??')}", file=out)
+
+
+def report_csv(sites, names, base, out):
+    print(",".join(("site",) + SITE_FIELDS[1:] + tuple(LIFE_BUCKETS)), file=out)
+    for site in sites:
+        name = names.get(base + site["offset"], "??").replace(",", ";")
+        print(",".join([name] + [str(site[k]) for k in SITE_FIELDS[1:]]
+                       + [str(n) for n in site["life"]]), file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="firmware ELF built with FACP_HEAP_PROFILE")
+    parser.add_argument("capture", help="console capture ('-' for stdin)")
+    parser.add_argument("--nm", default="arm-none-eabi-nm")
+    parser.add_argument("--addr2line", default="arm-none-eabi-addr2line")
+    parser.add_argument("--sort", choices=SORT_KEYS, default="peak")
+    parser.add_argument("--csv", action="store_true", help="print sites as CSV")
+    args = parser.parse_args()
+
+    if args.capture == "-":
+        dump = parse(sys.stdin)
+    else:
+        with open(args.capture, errors="replace") as f:
+            dump = parse(f)
+    if dump is None:
+        raise SystemExit(f"{args.capture}: no complete HEAPPROF dump")
+    header, sites = dump
+
+    base = anchor_address(args.elf, args.nm)
+    addresses = sorted({base + s["offset"] for s in sites} |
+                       ({base + header["failed_offset"]} if header["failed_size"] else set()))
+    names = symbolize(args.elf, args.addr2line, addresses)
+
+    if args.csv:
+        report_csv(sites, names, base, sys.stdout)
+    else:
+        report(header, sites, names, base, args.sort, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
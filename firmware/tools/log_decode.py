@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+"""Decode tokenized FACP iZone log frames using the firmware ELF.
+
+Firmware built with -DFACP_LOG_TOKENIZED=ON sends each log record as a
+binary frame carrying the offset of its format string in the ELF's
+non-loaded .facp_logfmt section (see include/log.h for the layout).
+Bytes outside valid frames are passed through as text, so output from
+plain printf calls is kept.
+
+Usage:
+    log_decode.py build/facp_izone.elf /dev/ttyACM0
+    log_decode.py build/facp_izone.elf capture.bin
+    log_decode.py build/facp_izone.elf - < capture.bin
+"""
+
+import argparse
+import binascii
+import os
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+TOKEN_DROPPED = 0xFFFFFFFF
+FORMAT_SECTION = ".facp_logfmt"
+LEVEL_TAGS = "DIWEF"
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d*))?(hh|h|ll|l|z|j|t)?([diuxXocspn%])")
+
+
+class Elf:
+    """Minimal little-endian ELF32/ELF64 section reader."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[5] != 1:
+            raise ValueError(f"{path}: not a little-endian ELF file")
+        is64 = self.data[4] == 2
+        if is64:
+            shoff, = struct.unpack_from("<Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x3A)
+            fmt = "<IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from("<I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x2E)
+            fmt = "<IIIIIIIIII"
+
+        headers = [struct.unpack_from(fmt, self.data, shoff + i * shentsize)
+                   for i in range(shnum)]
+        strtab = headers[shstrndx]
+        names = self.data[strtab[4]:strtab[4] + strtab[5]]
+
+        # name, type, flags, addr, offset, size
+        self.sections = {}
+        for h in headers:
+            name = names[h[0]:names.index(b"\0", h[0])].decode()
+            self.sections[name] = (h[1], h[2], h[3], h[4], h[5])
+
+    def section(self, name):
+        if name not in self.sections:
+            return None
+        _, _, addr, offset, size = self.sections[name]
+        return addr, self.data[offset:offset + size]
+
+    def string_at(self, address):
+        """Read a NUL-terminated string from a loaded section, or None."""
+        for sh_type, flags, addr, offset, size in self.sections.values():
+            if not flags & SHF_ALLOC or sh_type == SHT_NOBITS:
+                continue
+            if addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.find(b"\0", start, offset + size)
+                if end >= 0:
+                    return self.data[start:end].decode("utf-8", "replace")
+        return None
+
+
+class Decoder:
+    def __init__(self, elf):
+        self.elf = elf
+        section = elf.section(FORMAT_SECTION)
+        if section is None:
+            raise ValueError(f"{FORMAT_SECTION} not found: build with -DFACP_LOG_TOKENIZED=ON")
+        self.fmt_base, self.fmt_data = section
+        self.last_us = 0
+        self.epoch_us = 0
+
+    def format_string(self, token):
+        offset = token - self.fmt_base
+        if not 0 <= offset < len(self.fmt_data):
+            return None
+        end = self.fmt_data.find(b"\0", offset)
+        return self.fmt_data[offset:end].decode("utf-8", "replace")
+
+    def expand(self, fmt, args):
+        args = list(args)
+
+        def convert(match):
+            flags, width, precision, _, conv = match.groups()
+            if conv == "%":
+                return "%"
+            if not args:
+                return "?"
+            word = args.pop(0)
+            spec = "%" + flags + width + ("." + precision if precision is not None else "")
+            if conv in "di":
+                return (spec + "d") % (word - (1 << 32) if word & 0x80000000 else word)
+            if conv == "u":
+                return (spec + "d") % word
+            if conv in "xXo":
+                return (spec + conv) % word
+            if conv == "c":
+                return (spec + "c") % chr(word & 0xFF)
+            if conv == "s":
+                text = self.elf.string_at(word) if word else "(null)"
+                return (spec + "s") % (text if text is not None else f"<str@0x{word:08x}>")
+            if conv == "p":
+                return (spec + "s") % f"0x{word:x}"
+            return match.group(0)
+
+        return CONVERSION.sub(convert, fmt)
+
+    def timestamp(self, low_us):
+        # Frames carry the low 32 bits of time_us_64(); unwrap them
+        if low_us < self.last_us:
+            self.epoch_us += 1 << 32
+        self.last_us = low_us
+        return self.epoch_us + low_us
+
+    def decode(self, payload):
+        token, low_us, meta, nargs = struct.unpack_from("<IIBB", payload)
+        args = struct.unpack_from(f"<{nargs}I", payload, 10)
+        us = self.timestamp(low_us)
+        level = LEVEL_TAGS[meta >> 4] if (meta >> 4) < len(LEVEL_TAGS) else "?"
+        core = meta & 0x0F
+
+        if token == TOKEN_DROPPED:
+            text = f"[log] core {args[0]}: {args[1]} records dropped"
+        else:
+            fmt = self.format_string(token)
+            if fmt is None:
+                text = f"<unknown token 0x{token:08x}> " + " ".join(f"0x{a:x}" for a in args)
+            else:
+                text = self.expand(fmt, args).rstrip("\n")
+        return f"[{us // 1000000:5d}.{us % 1000000:06d}] {level}{core} {text}"
+
+
+def frames(stream, on_text):
+    """Yield frame payloads from a byte stream; other bytes go to on_text."""
+    buf = bytearray()
+    while True:
+        chunk = stream.read1(4096) if hasattr(stream, "read1") else stream.read(4096)
+        if not chunk:
+            break
+        buf += chunk
+        while buf:
+            if buf[0] != FRAME_SYNC:
+                sync = buf.find(FRAME_SYNC)
+                cut = len(buf) if sync < 0 else sync
+                on_text(bytes(buf[:cut]))
+                del buf[:cut]
+                continue
+            if len(buf) < 2:
+                break
+            length = buf[1]
+            if length < 10 or (length - 10) % 4 or length > 10 + 4 * 16:
+                on_text(bytes(buf[:1]))
+                del buf[:1]
+                continue
+            if len(buf) < length + 4:
+                break
+            payload = bytes(buf[2:2 + length])
+            # CRC-16/CCITT-FALSE over the length byte and payload
+            crc = buf[2 + length] | (buf[3 + length] << 8)
+            if binascii.crc_hqx(bytes(buf[1:2 + length]), 0xFFFF) != crc or \
+                    payload[9] * 4 + 10 != length:
+                on_text(bytes(buf[:1]))
+                del buf[:1]
+                continue
+            del buf[:length + 4]
+            yield payload
+    if buf:
+        on_text(bytes(buf))
+
+
+def open_input(path):
+    if path == "-":
+        return sys.stdin.buffer
+    stream = open(path, "rb", buffering=0)
+    if os.isatty(stream.fileno()):
+        import tty
+        tty.setraw(stream.fileno())
+    return stream
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="firmware ELF built with FACP_LOG_TOKENIZED=ON")
+    parser.add_argument("input", nargs="?", default="-",
+                        help="serial device, capture file or - for stdin")
+    args = parser.parse_args()
+
+    try:
+        decoder = Decoder(Elf(args.elf))
+    except (OSError, ValueError) as e:
+        sys.exit(f"log_decode: {e}")
+
+    out = sys.stdout
+
+    def on_text(data):
+        out.write(data.decode("utf-8", "replace"))
+
+    try:
+        for payload in frames(open_input(args.input), on_text):
+            out.write(decoder.decode(payload) + "\n")
+            out.flush()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
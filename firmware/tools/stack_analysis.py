@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+"""Worst-case stack depth of FACP iZone tasks from .su files and the call graph.
+
+The firmware is built with -fstack-usage, so every compiled function has
+its frame size in a .su file. The call graph comes from the disassembly
+of the ELF (direct calls and tail branches). The worst-case depth of a
+task is the deepest frame chain from its entry function, plus the
+exception frame and registers the kernel saves on the task stack at a
+context switch.
+
+Tasks and their configured stack sizes are read from the non-loaded
+.facp_stackinfo section of the ELF (STACK_INFO_RECORD in
+include/stack_monitor.h); --task adds or overrides entries. The exit
+status is 1 if any task's configured stack is smaller than its worst
+case plus --margin.
+
+Calls through function pointers cannot be followed and recursion has no
+bound; both are reported, and --strict turns them into failures for the
+tasks that reach them.
+
+Usage:
+    stack_analysis.py build/facp_izone.elf build/CMakeFiles/facp_izone.dir
+    stack_analysis.py facp_izone.elf su_dir --disassembly facp_izone.dis --verbose
+    stack_analysis.py facp_izone.elf su_dir --task vAlarmTask=1024
+"""
+
+import argparse
+import os
+import re
+import struct
+import subprocess
+import sys
+
+from log_decode import Elf
+
+STACKINFO_SECTION = ".facp_stackinfo"
+STACKINFO_NAME_LEN = 28
+
+FUNCTION_HEADER = re.compile(r"^([0-9a-f]+) <([^>]+)>:\s*$")
+TARGET = re.compile(r"<([^>+]+)>")
+SUFFIX_NUMBER = re.compile(r"\.\d+$")
+BRANCH = re.compile(r"^b(?:eq|ne|cs|hs|cc|lo|mi|pl|vs|vc|hi|ls|ge|lt|gt|le|al)?(?:\.[nw])?$")
+REGISTER = re.compile(r"^(?:r\d+|ip|sl|fp)$")
+RAW_BYTES = re.compile(r"^(?:[0-9a-f]{4}|[0-9a-f]{8})(?: (?:[0-9a-f]{4}|[0-9a-f]{8}))*$")
+
+
+def read_su(directories):
+    """Map function name to (frame bytes, dynamic) from all .su files."""
+    frames = {}
+    for directory in directories:
+        for root, _, files in os.walk(directory):
+            for name in files:
+                if not name.endswith(".su"):
+                    continue
+                with open(os.path.join(root, name), errors="replace") as f:
+                    for line in f:
+                        fields = line.rstrip("\n").split("\t")
+                        if len(fields) < 3:
+                            continue
+                        function = fields[0].rsplit(":", 1)[-1]
+                        size = int(fields[1])
+                        dynamic = "dynamic" in fields[2] and "bounded" not in fields[2]
+                        # Same-named static functions: keep the larger frame
+                        previous = frames.get(function, (0, False))
+                        frames[function] = (max(size, previous[0]), dynamic or previous[1])
+    return frames
+
+
+def frame_of(frames, function):
+    if function in frames:
+        return frames[function]
+    # Clone suffixes: symbol "f.isra.0" is "f.isra" in the .su file
+    return frames.get(SUFFIX_NUMBER.sub("", function))
+
+
+def read_call_graph(lines):
+    """Map function name to (set of callees, indirect call count)."""
+    graph = {}
+    current = None
+    for line in lines:
+        header = FUNCTION_HEADER.match(line)
+        if header:
+            current = header.group(2)
+            graph.setdefault(current, [set(), 0])
+            continue
+        if current is None:
+            continue
+        # "addr:" [raw bytes] mnemonic [operands]
+        fields = [field.strip() for field in line.rstrip("\n").split("\t")]
+        if not fields[0].endswith(":"):
+            continue
+        fields = fields[1:]
+        if fields and RAW_BYTES.match(fields[0]):
+            fields = fields[1:]
+        if not fields:
+            continue
+        mnemonic = fields[0]
+        operands = fields[1] if len(fields) > 1 else ""
+        target = TARGET.search(operands)
+
+        if mnemonic in ("bl", "blx"):
+            if target:
+                graph[current][0].add(target.group(1))
+            elif REGISTER.match(operands.split()[0] if operands else ""):
+                graph[current][1] += 1
+        elif BRANCH.match(mnemonic) and target and target.group(1) != current:
+            # A branch to the start of another function is a tail call
+            graph[current][0].add(target.group(1))
+        elif mnemonic == "bx" and operands.split()[0] != "lr":
+            graph[current][1] += 1
+    return {name: (callees, indirect) for name, (callees, indirect) in graph.items()}
+
+
+class Analysis:
+    def __init__(self, frames, graph):
+        self.frames = frames
+        self.graph = graph
+        self.memo = {}
+        self.unknown = set()
+
+    def depth(self, function, stack=()):
+        """Return (bytes, path, dynamic, indirect, recursive) for the deepest chain."""
+        if function in self.memo:
+            return self.memo[function]
+        if function in stack:
+            return (0, [function + " (recursion)"], False, False, True)
+
+        frame = frame_of(self.frames, function)
+        if frame is None:
+            self.unknown.add(function)
+            frame = (0, False)
+        callees, indirect = self.graph.get(function, (set(), 0))
+
+        best = (0, [], False, False, False)
+        dynamic, has_indirect, recursive = frame[1], indirect > 0, False
+        for callee in sorted(callees):
+            result = self.depth(callee, stack + (function,))
+            dynamic |= result[2]
+            has_indirect |= result[3]
+            recursive |= result[4]
+            if result[0] > best[0]:
+                best = result
+
+        result = (frame[0] + best[0], [function] + best[1], dynamic, has_indirect, recursive)
+        # Depths inside a recursive cycle depend on the entry point
+        if not recursive:
+            self.memo[function] = result
+        return result
+
+
+def read_stackinfo(elf_path):
+    """Return [(entry function, stack bytes)] from the ELF."""
+    elf = Elf(elf_path)
+    section = elf.sections.get(STACKINFO_SECTION)
+    if section is None:
+        return []
+    _, _, _, offset, size = section
+    record = STACKINFO_NAME_LEN + 4
+    tasks = []
+    for pos in range(offset, offset + size - record + 1, record):
+        name = elf.data[pos:pos + STACKINFO_NAME_LEN].split(b"\0", 1)[0].decode()
+        stack_bytes, = struct.unpack_from("<I", elf.data, pos + STACKINFO_NAME_LEN)
+        tasks.append((name, stack_bytes))
+    return tasks
+
+
+def disassemble(elf, objdump, listing):
+    if listing:
+        with open(listing, errors="replace") as f:
+            return f.readlines()
+    return subprocess.run([objdump, "-d", "--no-show-raw-insn", elf], check=True,
+                          capture_output=True, text=True).stdout.splitlines()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="firmware ELF")
+    parser.add_argument("su_dirs", nargs="+", help="directories searched for .su files")
+    parser.add_argument("--objdump", default="arm-none-eabi-objdump")
+    parser.add_argument("--disassembly", help="use an existing objdump -d listing (.dis)")
+    parser.add_argument("--task", action="append", default=[], metavar="FUNCTION=BYTES",
+                        help="check an entry function against a stack size")
+    parser.add_argument("--overhead", type=int, default=64,
+                        help="bytes the kernel and exceptions add on a task stack (default 64)")
+    parser.add_argument("--margin", type=int, default=0,
+                        help="extra bytes every stack must have spare (default 0)")
+    parser.add_argument("--strict", action="store_true",
+                        help="fail tasks that reach indirect calls, recursion or dynamic frames")
+    parser.add_argument("--verbose", action="store_true", help="print the deepest call chains")
+    args = parser.parse_args()
+
+    tasks = dict()
+    for name, stack_bytes in read_stackinfo(args.elf):
+        tasks[name] = max(stack_bytes, tasks.get(name, 0))
+    for spec in args.task:
+        name, _, stack_bytes = spec.partition("=")
+        tasks[name] = int(stack_bytes, 0)
+    if not tasks:
+        raise SystemExit(f"{args.elf}: no {STACKINFO_SECTION} section and no --task given")
+
+    frames = read_su(args.su_dirs)
+    if not frames:
+        raise SystemExit("no .su files found; is -fstack-usage set?")
+    graph = read_call_graph(disassemble(args.elf, args.objdump, args.disassembly))
+    analysis = Analysis(frames, graph)
+
+    failed = False
+    print(f"{'task entry':<28} {'stack':>6} {'worst':>6} {'spare':>6}  notes")
+    for name in sorted(tasks):
+        if name not in graph:
+            print(f"{name:<28} {tasks[name]:>6} {'?':>6} {'?':>6}  not in the ELF")
+            failed = True
+            continue
+        depth, path, dynamic, indirect, recursive = analysis.depth(name)
+        worst = depth + args.overhead
+        spare = tasks[name] - worst
+        notes = [n for n, flag in (("indirect calls", indirect), ("recursion", recursive),
+                                   ("dynamic frame", dynamic)) if flag]
+        too_small = spare < args.margin or (args.strict and notes)
+        failed |= bool(too_small)
+        print(f"{name:<28} {tasks[name]:>6} {worst:>6} {spare:>6}  "
+              f"{'TOO SMALL ' if too_small else ''}{', '.join(notes)}")
+        if args.verbose:
+            print("    " + " -> ".join(path))
+
+    if analysis.unknown and args.verbose:
+        print(f"\nno .su entry (counted as 0 bytes): {', '.join(sorted(analysis.unknown))}")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+"""Convert an FACP iZone trace dump to a Perfetto (Chrome JSON) trace.
+
+The firmware prints its trace rings as "TRACE ..." lines (see
+src/trace.c); other lines in the capture are ignored, so a console log
+or benchmark output can be converted as is. Open the result in
+https://ui.perfetto.dev or chrome://tracing.
+
+Each core gets a track of task slices and a track of ISR slices; queue,
+notification and priority inheritance events are instants on the core
+track, as are alarm output changes with their edge-to-output latency.
+--summary prints run time per task and core, ISR durations and alarm
+output latencies.
+
+Usage:
+    trace_convert.py capture.txt [-o trace.json] [--summary]
+"""
+
+import argparse
+import json
+import struct
+import sys
+from collections import defaultdict
+
+# Event types, as in config/trace_hooks.h
+TASK_IN = 1
+TASK_OUT = 2
+QUEUE_CREATE = 3
+ISR_ENTER = 17
+ISR_EXIT = 18
+ALARM_OUTPUT = 19
+
+# alarm_output_source_t
+ALARM_SOURCES = {0: "fast", 1: "task", 2: "release"}
+
+INSTANTS = {
+    4: "send",
+    5: "send failed",
+    6: "receive",
+    7: "receive failed",
+    8: "send (ISR)",
+    9: "receive (ISR)",
+    10: "block",
+    11: "notify",
+    12: "notify (ISR)",
+    13: "notify take",
+    14: "notify wait",
+    15: "priority inherit",
+    16: "priority disinherit",
+}
+
+# ucQueueType values and how send/receive read for them
+QUEUE_TYPES = {
+    0: ("queue", "send", "receive"),
+    1: ("mutex", "give", "take"),
+    2: ("counting semaphore", "give", "take"),
+    3: ("binary semaphore", "give", "take"),
+    4: ("recursive mutex", "give", "take"),
+}
+
+ISR_TID_OFFSET = 100
+
+
+def parse(lines):
+    """Return the last dump: core count, task and ISR names, events per core."""
+    dump = None
+    for line in lines:
+        line = line.strip()
+        if not line.startswith("TRACE "):
+            continue
+        fields = line.split(" ", 3)
+        kind = fields[1]
+        if kind == "BEGIN":
+            dump = {"cores": int(fields[3].split()[0]), "tasks": {}, "isrs": {},
+                    "events": defaultdict(list), "complete": False}
+        elif dump is None:
+            continue
+        elif kind == "TASK":
+            number, rest = int(fields[2]), fields[3]
+            priority, _, name = rest.partition(" ")
+            dump["tasks"][number] = (name, int(priority))
+        elif kind == "ISR":
+            dump["isrs"][int(fields[2])] = fields[3]
+        elif kind == "EV":
+            raw = bytes.fromhex(fields[3])
+            for off in range(0, len(raw) - 7, 8):
+                dump["events"][int(fields[2])].append(struct.unpack_from("<IBBH", raw, off))
+        elif kind == "END":
+            dump["complete"] = True
+    if dump is None:
+        sys.exit("trace_convert: no TRACE BEGIN found")
+    if not dump["complete"]:
+        print("trace_convert: dump is truncated", file=sys.stderr)
+    return dump
+
+
+def unwrap(events):
+    """Extend the 32-bit microsecond timestamps of one core."""
+    out, epoch, last = [], 0, None
+    for ts, etype, arg, eid in events:
+        if last is not None and ts < last and last - ts > 0x80000000:
+            epoch += 1 << 32
+        last = ts
+        out.append((epoch + ts, etype, arg, eid))
+    return out
+
+
+def convert(dump):
+    tasks = dump["tasks"]
+    isrs = dump["isrs"]
+    trace = []
+    per_core = {core: unwrap(ev) for core, ev in dump["events"].items()}
+    starts = [ev[0][0] for ev in per_core.values() if ev]
+    base = min(starts) if starts else 0
+
+    def task_name(number):
+        return tasks.get(number, (f"task {number}", 0))[0]
+
+    for core in sorted(per_core):
+        trace.append({"ph": "M", "name": "thread_name", "pid": 1, "tid": core,
+                      "args": {"name": f"Core {core}"}})
+        trace.append({"ph": "M", "name": "thread_name", "pid": 1,
+                      "tid": ISR_TID_OFFSET + core, "args": {"name": f"Core {core} IRQ"}})
+    trace.append({"ph": "M", "name": "process_name", "pid": 1, "args": {"name": "FACP iZone"}})
+
+    stats = {"run": defaultdict(int), "isr": defaultdict(list), "alarm": defaultdict(list)}
+
+    for core, events in sorted(per_core.items()):
+        running = None
+        isr_stack = []
+        for ts, etype, arg, eid in events:
+            t = ts - base
+            if etype == TASK_IN:
+                if running is not None:
+                    trace.append({"ph": "E", "pid": 1, "tid": core, "ts": t})
+                    stats["run"][(running[0], core)] += ts - running[1]
+                running = (eid, ts)
+                trace.append({"ph": "B", "pid": 1, "tid": core, "ts": t, "name": task_name(eid),
+                              "args": {"task": eid}})
+            elif etype == TASK_OUT:
+                if running is not None:
+                    trace.append({"ph": "E", "pid": 1, "tid": core, "ts": t})
+                    stats["run"][(running[0], core)] += ts - running[1]
+                running = None
+            elif etype == ISR_ENTER:
+                isr_stack.append((eid, ts))
+                trace.append({"ph": "B", "pid": 1, "tid": ISR_TID_OFFSET + core, "ts": t,
+                              "name": isrs.get(eid, f"isr {eid}")})
+            elif etype == ISR_EXIT:
+                if isr_stack:
+                    isr, start = isr_stack.pop()
+                    trace.append({"ph": "E", "pid": 1, "tid": ISR_TID_OFFSET + core, "ts": t})
+                    stats["isr"][isrs.get(isr, f"isr {isr}")].append(ts - start)
+            elif etype == ALARM_OUTPUT:
+                zone, source = (arg & 0x0F) + 1, ALARM_SOURCES.get(arg >> 4, "?")
+                name = f"alarm out zone {zone} {source}"
+                if source != "release":
+                    name += f" {eid} us"
+                    stats["alarm"][source].append(eid)
+                trace.append({"ph": "i", "s": "g", "pid": 1, "tid": core, "ts": t,
+                              "name": name, "args": {"zone": zone, "latency_us": eid}})
+            elif etype == QUEUE_CREATE:
+                kind = QUEUE_TYPES.get(arg, ("queue",))[0]
+                trace.append({"ph": "i", "s": "t", "pid": 1, "tid": core, "ts": t,
+                              "name": f"create {kind} {eid}"})
+            elif etype in INSTANTS:
+                name = INSTANTS[etype]
+                args = {}
+                if etype <= 10:
+                    kind, send, receive = QUEUE_TYPES.get(arg, QUEUE_TYPES[0])
+                    name = name.replace("send", send).replace("receive", receive)
+                    name = f"{name} {kind} {eid}"
+                elif etype <= 14:
+                    name = f"{name} {task_name(eid)}"
+                    args["index"] = arg
+                else:
+                    name = f"{name} {task_name(eid)}"
+                    args["priority"] = arg
+                trace.append({"ph": "i", "s": "t", "pid": 1, "tid": core, "ts": t,
+                              "name": name, "args": args})
+        if running is not None and events:
+            trace.append({"ph": "E", "pid": 1, "tid": core, "ts": events[-1][0] - base})
+
+    span = {core: (ev[-1][0] - ev[0][0]) for core, ev in per_core.items() if ev}
+    return {"traceEvents": trace, "displayTimeUnit": "ns"}, stats, span, task_name
+
+
+def print_summary(stats, span, task_name):
+    print(f"{'task':<16} {'core':>4} {'run_us':>10} {'share':>7}")
+    for (task, core), us in sorted(stats["run"].items(), key=lambda kv: -kv[1]):
+        share = 100.0 * us / span[core] if span.get(core) else 0.0
+        print(f"{task_name(task):<16} {core:>4} {us:>10} {share:>6.1f}%")
+    if stats["isr"]:
+        print(f"\n{'isr':<16} {'count':>6} {'mean_us':>8} {'max_us':>8}")
+        for name, durations in sorted(stats["isr"].items()):
+            print(f"{name:<16} {len(durations):>6} "
+                  f"{sum(durations) / len(durations):>8.1f} {max(durations):>8}")
+    if stats["alarm"]:
+        print(f"\n{'alarm output':<16} {'count':>6} {'mean_us':>8} {'max_us':>8}")
+        for source, latencies in sorted(stats["alarm"].items()):
+            print(f"{source:<16} {len(latencies):>6} "
+                  f"{sum(latencies) / len(latencies):>8.1f} {max(latencies):>8}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="text capture containing a TRACE dump (- for stdin)")
+    parser.add_argument("-o", "--output", default="trace.json", help="Perfetto JSON output")
+    parser.add_argument("--summary", action="store_true", help="print run time and ISR summary")
+    args = parser.parse_args()
+
+    if args.capture == "-":
+        dump = parse(sys.stdin)
+    else:
+        with open(args.capture, encoding="utf-8", errors="replace") as f:
+            dump = parse(f)
+
+    trace, stats, span, task_name = convert(dump)
+    with open(args.output, "w") as f:
+        json.dump(trace, f)
+    print(f"trace_convert: {sum(len(e) for e in dump['events'].values())} events "
+          f"-> {args.output}", file=sys.stderr)
+
+    if args.summary:
+        print_summary(stats, span, task_name)
+
+
+if __name__ == "__main__":
+    main()